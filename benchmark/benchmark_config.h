@@ -14,11 +14,13 @@ typedef struct {
 typedef enum {
     BENCHMARK_EQUALITY,
     BENCHMARK_FIBONACCI,
+    BENCHMARK_FOR_EACH,
     BENCHMARK_INSTANTIATION,
     BENCHMARK_METHOD_CALL,
     BENCHMARK_NEGATE,
     BENCHMARK_PROPERTIES,
     BENCHMARK_RAISE,
+    BENCHMARK_STRING_HASH,
     BENCHMARK_ZOO
 } benchmark;
 
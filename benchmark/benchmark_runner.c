@@ -27,6 +27,7 @@
 static benchmark_config_t benchmarks[] = {
     [BENCHMARK_EQUALITY] = {.benchmarkName = "Equality", .benchmarkFilePath = "Equality.clx", .executionCount = 3},
     [BENCHMARK_FIBONACCI] = {.benchmarkName = "Fibonacci", .benchmarkFilePath = "Fibonacci.clx", .executionCount = 3},
+    [BENCHMARK_FOR_EACH] = {.benchmarkName = "For Each", .benchmarkFilePath = "ForEach.clx", .executionCount = 3},
     [BENCHMARK_INSTANTIATION] = {.benchmarkName = "Instantiation",
                                  .benchmarkFilePath = "Instantiation.clx",
                                  .executionCount = 3},
@@ -38,6 +39,9 @@ static benchmark_config_t benchmarks[] = {
                               .benchmarkFilePath = "Properties.clx",
                               .executionCount = 3},
     [BENCHMARK_RAISE] = {.benchmarkName = "Raise", .benchmarkFilePath = "Raise.clx", .executionCount = 3},
+    [BENCHMARK_STRING_HASH] = {.benchmarkName = "String Hash",
+                               .benchmarkFilePath = "StringHash.clx",
+                               .executionCount = 3},
     [BENCHMARK_ZOO] = {.benchmarkName = "Zoo", .benchmarkFilePath = "Zoo.clx", .executionCount = 3}};
 
 static FILE * benchmark_runner_create_results_file_pointer(void);
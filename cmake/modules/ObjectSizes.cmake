@@ -0,0 +1,22 @@
+include(CheckTypeSize)
+
+# Reports the sizes of the object header and of all the object types of cellox at configure time
+macro (cellox_report_object_sizes)
+    set(CMAKE_EXTRA_INCLUDE_FILES "${PROJECT_SOURCE_DIR}/src/language-models/object.h")
+    if(CLX_NAN_BOXING_ACTIVATED)
+        set(CMAKE_REQUIRED_DEFINITIONS -DNAN_BOXING)
+    endif()
+    set(CMAKE_REQUIRED_QUIET ON)
+    foreach(CELLOX_OBJECT_TYPE object_t object_bound_method_t object_class_t object_closure_t
+                               object_dynamic_value_array_t object_function_t object_instance_t object_map_t
+                               object_native_t object_string_t object_typed_array_t object_upvalue_t)
+        check_type_size(${CELLOX_OBJECT_TYPE} CELLOX_SIZEOF_${CELLOX_OBJECT_TYPE} LANGUAGE C)
+        message(STATUS "sizeof(${CELLOX_OBJECT_TYPE}) = ${CELLOX_SIZEOF_${CELLOX_OBJECT_TYPE}} bytes")
+    endforeach()
+    unset(CMAKE_REQUIRED_QUIET)
+    unset(CMAKE_REQUIRED_DEFINITIONS)
+    unset(CMAKE_EXTRA_INCLUDE_FILES)
+    if(CELLOX_SIZEOF_object_t GREATER 8)
+        message(FATAL_ERROR "The object header of cellox has to fit into 8 bytes")
+    endif()
+endmacro()
@@ -22,17 +22,19 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include "../frontend/compiler.h"
 #ifdef DEBUG_LOG_GC
 #include "chunk_disassembler.h"
 #endif
 #include "../language-models/object.h"
+#include "garbage_collector_policy.h"
+#include "garbage_collector_statistics.h"
 #include "memory_mutator.h"
 #include "virtual_machine.h"
 
-#define GC_HEAP_GROWTH_FACTOR (2)
-
 static void garbage_collector_blacken_object(object_t *);
 static void garbage_collector_mark_array(dynamic_value_array_t *);
 static void garbage_collector_mark_roots(void);
@@ -42,16 +44,22 @@ static void garbage_collector_trace_references(void);
 void garbage_collector_collect_garbage(void) {
 #ifdef DEBUG_LOG_GC
     printf("garbage collection process has begun\n");
-    size_t before = virtualMachine.bytesAllocated;
 #endif
+    size_t before = virtualMachine.bytesAllocated;
+    clock_t start = clock();
     garbage_collector_mark_roots();
     garbage_collector_trace_references();
     // We have to remove the strings with a another method, because they have their own hashtable
     value_hash_table_remove_white(&virtualMachine.strings);
     // reclaim the garbage
     garbage_collector_sweep();
+    // The method caches could contain objects that were freed
+    memset(virtualMachine.methodCache, 0, sizeof(virtualMachine.methodCache));
+    memset(virtualMachine.boundMethodCache, 0, sizeof(virtualMachine.boundMethodCache));
+    clock_t end = clock();
+    garbage_collector_statistics_record_collection(before, virtualMachine.bytesAllocated, start, end);
     // Adjusts the threshold when the next garbage collection will occur
-    virtualMachine.nextGC = virtualMachine.bytesAllocated * GC_HEAP_GROWTH_FACTOR;
+    virtualMachine.nextGC = garbage_collector_policy_next_threshold(before, virtualMachine.bytesAllocated, start, end);
 #ifdef DEBUG_LOG_GC
     printf("garbage collection process has ended\n");
     printf("   collected %zu bytes (from %zu to %zu) next at %zu\n", before - virtualMachine.bytesAllocated, before,
@@ -64,7 +72,7 @@ void garbage_collector_mark_object(object_t * object) {
         return;
     }
     // Object is already marked, so we don't need to mark it again
-    if (object->isMarked) {
+    if (object_is_marked(object)) {
         return;
     }
 #ifdef DEBUG_LOG_GC
@@ -72,7 +80,7 @@ void garbage_collector_mark_object(object_t * object) {
     value_print(OBJECT_VAL(object));
     printf("\n");
 #endif
-    object->isMarked = true;
+    object_set_marked(object, true);
     if (virtualMachine.grayCapacity < virtualMachine.grayCount + 1) {
         virtualMachine.grayCapacity = GROW_CAPACITY(virtualMachine.grayCapacity);
         virtualMachine.grayStack =
@@ -99,12 +107,19 @@ static void garbage_collector_blacken_object(object_t * object) {
     value_print(OBJECT_VAL(object));
     printf("\n");
 #endif
-    switch (object->type) {
+    switch (object_get_type(object)) {
     case OBJECT_ARRAY:
         {
             object_dynamic_value_array_t * array = (object_dynamic_value_array_t *)object;
-            // If a function is reachable all of the constants stored in the chunk are reachable, too.
-            garbage_collector_mark_array(&array->array);
+            if (array->backing) {
+                // Borrowed values are marked together with the other values of the backing array
+                garbage_collector_mark_object((object_t *)array->backing);
+            } else if (object_array_is_numeric(array)) {
+                // An array that only contains numbers does not reference any objects, so it is not scanned
+            } else {
+                // If an array is reachable all of the values stored in the array are reachable, too.
+                garbage_collector_mark_array(&array->array);
+            }
             break;
         }
     case OBJECT_BOUND_METHOD:
@@ -121,7 +136,8 @@ static void garbage_collector_blacken_object(object_t * object) {
             object_class_t * celloxClass = (object_class_t *)object;
             garbage_collector_mark_object((object_t *)celloxClass->name);
             // If a class is reachable, all the methods are reachable, too.
-            value_hash_table_mark(&celloxClass->methods);
+            value_hash_table_mark(&celloxClass->methodSlots);
+            garbage_collector_mark_array(&celloxClass->methods);
             break;
         }
     case OBJECT_CLOSURE:
@@ -151,12 +167,28 @@ static void garbage_collector_blacken_object(object_t * object) {
             value_hash_table_mark(&instance->fields);
             break;
         }
+    case OBJECT_MAP:
+        // If a map is reachable all of it's keys and values are reachable, too.
+        value_map_mark(&((object_map_t *)object)->map);
+        break;
     case OBJECT_UPVALUE:
         // If a upvalue is reachable the captured value is reachable, too.
         garbage_collector_mark_value(((object_upvalue_t *)object)->closed);
         break;
-    case OBJECT_NATIVE:
     case OBJECT_STRING:
+        if (object_string_get_kind((object_string_t *)object) == OBJECT_STRING_KIND_ROPE) {
+            object_rope_t * rope = (object_rope_t *)object;
+            // If a rope is reachable both parts (or the flattened string) are reachable, too.
+            garbage_collector_mark_object((object_t *)rope->left);
+            garbage_collector_mark_object((object_t *)rope->right);
+        } else if (object_string_get_kind((object_string_t *)object) == OBJECT_STRING_KIND_SLICE) {
+            // If a slice is reachable the string that stores the characters is reachable, too.
+            garbage_collector_mark_object((object_t *)((object_string_slice_t *)object)->parent);
+        }
+        break;
+    case OBJECT_NATIVE:
+    case OBJECT_TYPED_ARRAY:
+        // Natives and typed arrays do not reference any other objects
         break;
     }
 }
@@ -189,6 +221,12 @@ static void garbage_collector_mark_roots(void) {
     // and all the compiler roots allocated on the heap
     compiler_mark_roots();
     garbage_collector_mark_object((object_t *)virtualMachine.initString);
+    garbage_collector_mark_object((object_t *)virtualMachine.iterateString);
+    garbage_collector_mark_object((object_t *)virtualMachine.iteratorValueString);
+    // and the strings that consist of a single character
+    for (uint32_t i = 0; i < UINT8_COUNT; i++) {
+        garbage_collector_mark_object((object_t *)virtualMachine.characterStrings[i]);
+    }
 }
 
 /** @brief Walks through the linked list of objects on the heap and checks their mark bits.
@@ -199,17 +237,17 @@ static void garbage_collector_sweep(void) {
     object_t * previous = NULL;
     object_t * object = virtualMachine.objects;
     while (object) {
-        if (object->isMarked) {
+        if (object_is_marked(object)) {
             // We need to unmark the object so it is picked up during the next grabage collection process
-            object->isMarked = false;
+            object_set_marked(object, false);
             previous = object;
-            object = object->next;
+            object = object_get_next(object);
         } else {
             // Unreachable value -> free memory used by the object
             object_t * unreached = object;
-            object = object->next;
+            object = object_get_next(object);
             if (previous) {
-                previous->next = object;
+                object_set_next(previous, object);
             } else {
                 virtualMachine.objects = object;
             }
@@ -0,0 +1,279 @@
+/****************************************************************************
+ * Copyright (C) 2022 by Frederik Tobner                                    *
+ *                                                                          *
+ * This file is part of Cellox.                                             *
+ *                                                                          *
+ * Permission to use, copy, modify, and distribute this software and its    *
+ * documentation under the terms of the GNU General Public License is       *
+ * hereby granted.                                                          *
+ * No representations are made about the suitability of this software for   *
+ * any purpose.                                                             *
+ * It is provided "as is" without express or implied warranty.              *
+ * See the <https://www.gnu.org/licenses/gpl-3.0.html/>GNU General Public   *
+ * License for more details.                                                *
+ ****************************************************************************/
+
+/**
+ * @file garbage_collector_policy.c
+ * @brief File containing the implementation of the policy that determines when the garbage collector runs.
+ */
+
+#include "garbage_collector_policy.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// The default threshold of the first garbage collection (1 MB)
+#define GC_POLICY_DEFAULT_INITIAL_HEAP_SIZE (1u << 20u)
+/// The default factor the heap grows by after a garbage collection
+#define GC_POLICY_DEFAULT_GROWTH_FACTOR     (2.0)
+/// The smallest growth factor that is used in adaptive mode
+#define GC_POLICY_MINIMUM_GROWTH_FACTOR     (1.25)
+/// The biggest growth factor that is used in adaptive mode
+#define GC_POLICY_MAXIMUM_GROWTH_FACTOR     (8.0)
+/// The share of the processor time that the garbage collector should use at most in adaptive mode
+#define GC_POLICY_TARGET_OVERHEAD           (0.05)
+/// Survival rate above which the heap is grown faster in adaptive mode
+#define GC_POLICY_HIGH_SURVIVAL_RATE        (0.75)
+/// Survival rate below which the heap is grown slower in adaptive mode
+#define GC_POLICY_LOW_SURVIVAL_RATE         (0.25)
+
+/// @brief The settings of the garbage collector that can be configured
+typedef enum {
+    /// Adaptive mode (tunes the growth factor based on the pause times and the survival rate)
+    GC_POLICY_OPTION_ADAPTIVE,
+    /// Factor the heap grows by after a garbage collection
+    GC_POLICY_OPTION_GROWTH_FACTOR,
+    /// Threshold of the first garbage collection
+    GC_POLICY_OPTION_INITIAL_HEAP,
+    /// Maximum size of the heap
+    GC_POLICY_OPTION_MAXIMUM_HEAP,
+    /// Report of the statistics of the garbage collector that is printed when the virtual machine is freed
+    GC_POLICY_OPTION_REPORT
+} garbage_collector_policy_option;
+
+/// @brief Models how a setting of the garbage collector can be specified
+typedef struct {
+    /// The name of the setting when it is specified as a command line argument
+    char const * argumentName;
+    /// The name of the environment variable that specifies the setting
+    char const * environmentVariable;
+} garbage_collector_policy_option_config_t;
+
+/// @brief The policy of the garbage collector
+typedef struct {
+    /// Amount of bytes that can be allocated before the garbage collector runs for the first time
+    size_t initialHeapSize;
+    /// Maximum amount of bytes that can be allocated (0 if the heap size is not limited)
+    size_t maximumHeapSize;
+    /// The factor the heap grows by after a garbage collection
+    double growthFactor;
+    /// The growth factor that is tuned in adaptive mode
+    double adaptiveGrowthFactor;
+    /// Processor time when the last garbage collection has ended
+    clock_t lastCollectionEnd;
+    /// Determines whether the growth factor is tuned based on the pause times and the survival rate
+    bool adaptive;
+    /// Determines whether a report of the garbage collector statistics is printed when the virtual machine is freed
+    bool report;
+} garbage_collector_policy_t;
+
+/// Configurations of all the settings of the garbage collector
+static garbage_collector_policy_option_config_t optionConfigs[] = {
+    [GC_POLICY_OPTION_ADAPTIVE] = {.argumentName = "--gc-adaptive", .environmentVariable = "CELLOX_GC_ADAPTIVE"},
+    [GC_POLICY_OPTION_GROWTH_FACTOR] = {.argumentName = "--gc-growth-factor",
+                                        .environmentVariable = "CELLOX_GC_GROWTH_FACTOR"},
+    [GC_POLICY_OPTION_INITIAL_HEAP] = {.argumentName = "--gc-initial-heap",
+                                       .environmentVariable = "CELLOX_GC_INITIAL_HEAP"},
+    [GC_POLICY_OPTION_MAXIMUM_HEAP] = {.argumentName = "--gc-max-heap", .environmentVariable = "CELLOX_GC_MAX_HEAP"},
+    [GC_POLICY_OPTION_REPORT] = {.argumentName = "--gc-report", .environmentVariable = "CELLOX_GC_REPORT"}};
+
+/// The policy that is used by the garbage collector
+static garbage_collector_policy_t policy = {.initialHeapSize = GC_POLICY_DEFAULT_INITIAL_HEAP_SIZE,
+                                            .maximumHeapSize = 0u,
+                                            .growthFactor = GC_POLICY_DEFAULT_GROWTH_FACTOR,
+                                            .adaptiveGrowthFactor = GC_POLICY_DEFAULT_GROWTH_FACTOR,
+                                            .lastCollectionEnd = 0,
+                                            .adaptive = false,
+                                            .report = false};
+
+static bool garbage_collector_policy_parse_bool(char const *, bool *);
+static bool garbage_collector_policy_parse_factor(char const *, double *);
+static bool garbage_collector_policy_parse_size(char const *, size_t *);
+static bool garbage_collector_policy_set_option(garbage_collector_policy_option, char const *);
+
+size_t garbage_collector_policy_initial_threshold(void) {
+    policy.adaptiveGrowthFactor = policy.growthFactor;
+    policy.lastCollectionEnd = clock();
+    if (policy.maximumHeapSize && policy.initialHeapSize > policy.maximumHeapSize) {
+        return policy.maximumHeapSize;
+    }
+    return policy.initialHeapSize;
+}
+
+size_t garbage_collector_policy_heap_limit(void) {
+    return policy.maximumHeapSize;
+}
+
+bool garbage_collector_policy_heap_limit_exceeded(size_t bytesAllocated) {
+    return policy.maximumHeapSize && bytesAllocated > policy.maximumHeapSize;
+}
+
+bool garbage_collector_policy_report_enabled(void) {
+    return policy.report;
+}
+
+char const * garbage_collector_policy_load_environment(void) {
+    size_t upperBound = sizeof(optionConfigs) / sizeof(garbage_collector_policy_option_config_t);
+    for (size_t i = 0; i < upperBound; i++) {
+        char const * value = getenv(optionConfigs[i].environmentVariable);
+        if (value && !garbage_collector_policy_set_option((garbage_collector_policy_option)i, value)) {
+            return optionConfigs[i].environmentVariable;
+        }
+    }
+    return NULL;
+}
+
+size_t garbage_collector_policy_next_threshold(size_t bytesBefore, size_t bytesAfter, clock_t start, clock_t end) {
+    double growthFactor = policy.growthFactor;
+    if (policy.adaptive) {
+        // Share of the processor time since the end of the last collection that was spent collecting garbage
+        double pauseTime = (double)(end - start);
+        double totalTime = (double)(end - policy.lastCollectionEnd);
+        double overhead = totalTime > 0 ? pauseTime / totalTime : 0.0;
+        double survivalRate = bytesBefore ? (double)bytesAfter / (double)bytesBefore : 1.0;
+        if (overhead > GC_POLICY_TARGET_OVERHEAD || survivalRate > GC_POLICY_HIGH_SURVIVAL_RATE) {
+            // Collections are expensive or reclaim little memory -> we collect less often
+            policy.adaptiveGrowthFactor *= 1.5;
+            if (policy.adaptiveGrowthFactor > GC_POLICY_MAXIMUM_GROWTH_FACTOR) {
+                policy.adaptiveGrowthFactor = GC_POLICY_MAXIMUM_GROWTH_FACTOR;
+            }
+        } else if (overhead < GC_POLICY_TARGET_OVERHEAD / 4 && survivalRate < GC_POLICY_LOW_SURVIVAL_RATE) {
+            // Collections are cheap and most of the heap is garbage -> we can keep the heap smaller
+            policy.adaptiveGrowthFactor /= 1.25;
+            if (policy.adaptiveGrowthFactor < GC_POLICY_MINIMUM_GROWTH_FACTOR) {
+                policy.adaptiveGrowthFactor = GC_POLICY_MINIMUM_GROWTH_FACTOR;
+            }
+        }
+        growthFactor = policy.adaptiveGrowthFactor;
+    }
+    policy.lastCollectionEnd = end;
+    size_t threshold = (size_t)((double)bytesAfter * growthFactor);
+    // A tiny heap would lead to collections in rapid succession in adaptive mode
+    if (policy.adaptive && threshold < policy.initialHeapSize) {
+        threshold = policy.initialHeapSize;
+    }
+    if (policy.maximumHeapSize && threshold > policy.maximumHeapSize) {
+        threshold = policy.maximumHeapSize;
+    }
+    return threshold;
+}
+
+bool garbage_collector_policy_set_from_argument(char const * argument) {
+    if (strncmp(argument, GARBAGE_COLLECTOR_POLICY_ARGUMENT_PREFIX, strlen(GARBAGE_COLLECTOR_POLICY_ARGUMENT_PREFIX))) {
+        return false;
+    }
+    char const * value = strchr(argument, '=');
+    size_t nameLength = value ? (size_t)(value - argument) : strlen(argument);
+    size_t upperBound = sizeof(optionConfigs) / sizeof(garbage_collector_policy_option_config_t);
+    for (size_t i = 0; i < upperBound; i++) {
+        if (strlen(optionConfigs[i].argumentName) == nameLength &&
+            !strncmp(optionConfigs[i].argumentName, argument, nameLength)) {
+            // --gc-adaptive and --gc-report can be used without a value
+            if (!value && (i == GC_POLICY_OPTION_ADAPTIVE || i == GC_POLICY_OPTION_REPORT)) {
+                return garbage_collector_policy_set_option((garbage_collector_policy_option)i, "on");
+            }
+            return value && garbage_collector_policy_set_option((garbage_collector_policy_option)i, value + 1);
+        }
+    }
+    return false;
+}
+
+/// @brief Parses a boolean setting
+/// @param text The textual representation of the setting (on, off, true, false, 1 or 0)
+/// @param result Pointer to the location where the result is stored
+/// @return true if the text could be parsed, false if not
+static bool garbage_collector_policy_parse_bool(char const * text, bool * result) {
+    if (!strcmp(text, "1") || !strcmp(text, "on") || !strcmp(text, "true")) {
+        *result = true;
+        return true;
+    }
+    if (!strcmp(text, "0") || !strcmp(text, "off") || !strcmp(text, "false")) {
+        *result = false;
+        return true;
+    }
+    return false;
+}
+
+/// @brief Parses a growth factor
+/// @param text The textual representation of the factor (e.g. 1.5)
+/// @param result Pointer to the location where the result is stored
+/// @return true if the text could be parsed and is a factor bigger than 1, false if not
+static bool garbage_collector_policy_parse_factor(char const * text, double * result) {
+    char * end;
+    double factor = strtod(text, &end);
+    if (end == text || *end || !(factor > 1.0 && factor <= GC_POLICY_MAXIMUM_GROWTH_FACTOR)) {
+        return false;
+    }
+    *result = factor;
+    return true;
+}
+
+/// @brief Parses a size in bytes
+/// @param text The textual representation of the size, that can be followed by K, M or G (e.g. 64M)
+/// @param result Pointer to the location where the result is stored
+/// @return true if the text could be parsed, false if not
+static bool garbage_collector_policy_parse_size(char const * text, size_t * result) {
+    char * end;
+    if (!(*text >= '0' && *text <= '9')) {
+        return false;
+    }
+    unsigned long long size = strtoull(text, &end, 10);
+    unsigned shift = 0u;
+    switch (*end) {
+    case 'k':
+    case 'K':
+        shift = 10u;
+        end++;
+        break;
+    case 'm':
+    case 'M':
+        shift = 20u;
+        end++;
+        break;
+    case 'g':
+    case 'G':
+        shift = 30u;
+        end++;
+        break;
+    default:
+        break;
+    }
+    if (*end || size > (SIZE_MAX >> shift)) {
+        return false;
+    }
+    *result = (size_t)size << shift;
+    return true;
+}
+
+/// @brief Sets a setting of the garbage collector
+/// @param option The setting that is changed
+/// @param value The textual representation of the new value
+/// @return true if the value is valid, false if not
+static bool garbage_collector_policy_set_option(garbage_collector_policy_option option, char const * value) {
+    switch (option) {
+    case GC_POLICY_OPTION_ADAPTIVE:
+        return garbage_collector_policy_parse_bool(value, &policy.adaptive);
+    case GC_POLICY_OPTION_GROWTH_FACTOR:
+        return garbage_collector_policy_parse_factor(value, &policy.growthFactor);
+    case GC_POLICY_OPTION_INITIAL_HEAP:
+        return garbage_collector_policy_parse_size(value, &policy.initialHeapSize);
+    case GC_POLICY_OPTION_MAXIMUM_HEAP:
+        return garbage_collector_policy_parse_size(value, &policy.maximumHeapSize);
+    case GC_POLICY_OPTION_REPORT:
+        return garbage_collector_policy_parse_bool(value, &policy.report);
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,77 @@
+/****************************************************************************
+ * Copyright (C) 2022 by Frederik Tobner                                    *
+ *                                                                          *
+ * This file is part of Cellox.                                             *
+ *                                                                          *
+ * Permission to use, copy, modify, and distribute this software and its    *
+ * documentation under the terms of the GNU General Public License is       *
+ * hereby granted.                                                          *
+ * No representations are made about the suitability of this software for   *
+ * any purpose.                                                             *
+ * It is provided "as is" without express or implied warranty.              *
+ * See the <https://www.gnu.org/licenses/gpl-3.0.html/>GNU General Public   *
+ * License for more details.                                                *
+ ****************************************************************************/
+
+/**
+ * @file garbage_collector_policy.h
+ * @brief Header file containing the declarations of the policy that determines when the garbage collector runs.
+ */
+
+#ifndef CELLOX_GARBAGE_COLLECTOR_POLICY_H_
+#define CELLOX_GARBAGE_COLLECTOR_POLICY_H_
+
+// This file is included in the test-suite that is written in c++ using the google-test framework
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+/// Prefix of all the command line arguments that configure the garbage collector
+#define GARBAGE_COLLECTOR_POLICY_ARGUMENT_PREFIX ("--gc-")
+
+/// @brief Determines the threshold of the first garbage collection
+/// @return The amount of bytes that can be allocated before the garbage collector runs for the first time
+/// @details Also resets the measurements that are used by the adaptive mode
+size_t garbage_collector_policy_initial_threshold(void);
+
+/// @brief Gets the maximum size of the heap
+/// @return The maximum amount of bytes that can be allocated or 0 if the size of the heap is not limited
+size_t garbage_collector_policy_heap_limit(void);
+
+/// @brief Determines whether the heap limit would be exceeded
+/// @param bytesAllocated The amount of bytes that are allocated
+/// @return true if a heap limit was specified and the allocated bytes exceed it, false if not
+bool garbage_collector_policy_heap_limit_exceeded(size_t bytesAllocated);
+
+/// @brief Determines whether a report of the garbage collector statistics is printed when the virtual machine is freed
+/// @return true if the report is printed, false if not
+bool garbage_collector_policy_report_enabled(void);
+
+/// @brief Reads the configuration of the garbage collector from the environment variables
+/// @return NULL if everything went well, otherwise the name of the environment variable with an invalid value
+/// @details The environment variables CELLOX_GC_INITIAL_HEAP, CELLOX_GC_GROWTH_FACTOR, CELLOX_GC_MAX_HEAP and
+/// CELLOX_GC_ADAPTIVE and CELLOX_GC_REPORT are supported
+char const * garbage_collector_policy_load_environment(void);
+
+/// @brief Determines the threshold of the next garbage collection
+/// @param bytesBefore The amount of bytes that were allocated before the collection
+/// @param bytesAfter The amount of bytes that are still allocated after the collection
+/// @param start The processor time when the collection has started
+/// @param end The processor time when the collection has ended
+/// @return The amount of bytes that can be allocated before the garbage collector runs again
+size_t garbage_collector_policy_next_threshold(size_t bytesBefore, size_t bytesAfter, clock_t start, clock_t end);
+
+/// @brief Configures the garbage collector using a command line argument
+/// @param argument The argument (e.g. --gc-max-heap=64M)
+/// @return true if the argument is a valid garbage collector setting, false if not
+bool garbage_collector_policy_set_from_argument(char const * argument);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,163 @@
+/****************************************************************************
+ * Copyright (C) 2022 by Frederik Tobner                                    *
+ *                                                                          *
+ * This file is part of Cellox.                                             *
+ *                                                                          *
+ * Permission to use, copy, modify, and distribute this software and its    *
+ * documentation under the terms of the GNU General Public License is       *
+ * hereby granted.                                                          *
+ * No representations are made about the suitability of this software for   *
+ * any purpose.                                                             *
+ * It is provided "as is" without express or implied warranty.              *
+ * See the <https://www.gnu.org/licenses/gpl-3.0.html/>GNU General Public   *
+ * License for more details.                                                *
+ ****************************************************************************/
+
+/**
+ * @file garbage_collector_statistics.c
+ * @brief File containing the implementation of the statistics that are collected about the garbage collector.
+ */
+
+#include "garbage_collector_statistics.h"
+
+#include <string.h>
+
+#include "virtual_machine.h"
+
+/// Global statistics of the garbage collector
+garbage_collector_statistics_t garbageCollectorStatistics;
+
+/// Upper bounds of the buckets in the histogram of the pause times (in seconds)
+static double const pauseBucketBounds[GC_STATISTICS_PAUSE_BUCKETS - 1] = {0.0001, 0.001, 0.01, 0.1};
+
+/// Labels of the buckets in the histogram of the pause times
+static char const * pauseBucketLabels[GC_STATISTICS_PAUSE_BUCKETS] = {"< 0.1 ms", "< 1 ms", "< 10 ms", "< 100 ms",
+                                                                      ">= 100 ms"};
+
+/// The names of the object types that are used in the statistics
+static char const * objectTypeNames[OBJECT_TYPE_COUNT] = {
+    [OBJECT_ARRAY] = "array",       [OBJECT_BOUND_METHOD] = "bound_method", [OBJECT_INSTANCE] = "instance",
+    [OBJECT_CLASS] = "class",       [OBJECT_CLOSURE] = "closure",           [OBJECT_FUNCTION] = "function",
+    [OBJECT_MAP] = "map",           [OBJECT_NATIVE] = "native",             [OBJECT_STRING] = "string",
+    [OBJECT_TYPED_ARRAY] = "typed_array",                                   [OBJECT_UPVALUE] = "upvalue"};
+
+static double garbage_collector_statistics_allocation_rate(void);
+static void garbage_collector_statistics_set_field(object_instance_t *, char const *, value_t);
+
+object_instance_t * garbage_collector_statistics_create_instance(void) {
+    // Every object that is created is kept on the stack, so it is not collected while the instance is populated
+    object_string_t * className = object_copy_string("GCStats", 7u, false);
+    virtual_machine_push(OBJECT_VAL(className));
+    object_class_t * statisticsClass = object_new_class(className);
+    virtual_machine_push(OBJECT_VAL(statisticsClass));
+    object_instance_t * instance = object_new_instance(statisticsClass);
+    virtual_machine_push(OBJECT_VAL(instance));
+
+    garbage_collector_statistics_set_field(instance, "collections",
+                                           NUMBER_VAL((double)garbageCollectorStatistics.collections));
+    garbage_collector_statistics_set_field(instance, "pause_total",
+                                           NUMBER_VAL(garbageCollectorStatistics.pauseTimeTotal));
+    garbage_collector_statistics_set_field(instance, "pause_max",
+                                           NUMBER_VAL(garbageCollectorStatistics.pauseTimeMaximum));
+    garbage_collector_statistics_set_field(instance, "bytes_allocated",
+                                           NUMBER_VAL((double)virtualMachine.bytesAllocated));
+    garbage_collector_statistics_set_field(instance, "bytes_allocated_total",
+                                           NUMBER_VAL((double)garbageCollectorStatistics.bytesAllocatedTotal));
+    garbage_collector_statistics_set_field(instance, "bytes_marked",
+                                           NUMBER_VAL((double)garbageCollectorStatistics.bytesMarked));
+    garbage_collector_statistics_set_field(instance, "bytes_freed",
+                                           NUMBER_VAL((double)garbageCollectorStatistics.bytesFreed));
+    garbage_collector_statistics_set_field(instance, "survival_rate",
+                                           NUMBER_VAL(garbageCollectorStatistics.survivalRate));
+    garbage_collector_statistics_set_field(instance, "allocation_rate",
+                                           NUMBER_VAL(garbage_collector_statistics_allocation_rate()));
+    garbage_collector_statistics_set_field(instance, "next_collection", NUMBER_VAL((double)virtualMachine.nextGC));
+
+    object_dynamic_value_array_t * histogram = object_new_dynamic_value_array();
+    virtual_machine_push(OBJECT_VAL(histogram));
+    for (uint32_t i = 0; i < GC_STATISTICS_PAUSE_BUCKETS; i++) {
+        object_array_write(histogram, NUMBER_VAL((double)garbageCollectorStatistics.pauseHistogram[i]));
+    }
+    garbage_collector_statistics_set_field(instance, "pause_histogram", OBJECT_VAL(histogram));
+    virtual_machine_pop();
+
+    object_instance_t * liveObjects = object_new_instance(statisticsClass);
+    virtual_machine_push(OBJECT_VAL(liveObjects));
+    for (uint32_t i = 0; i < OBJECT_TYPE_COUNT; i++) {
+        garbage_collector_statistics_set_field(liveObjects, objectTypeNames[i],
+                                               NUMBER_VAL((double)garbageCollectorStatistics.liveObjects[i]));
+    }
+    garbage_collector_statistics_set_field(instance, "live_objects", OBJECT_VAL(liveObjects));
+    virtual_machine_pop();
+
+    virtual_machine_pop();
+    virtual_machine_pop();
+    virtual_machine_pop();
+    return instance;
+}
+
+void garbage_collector_statistics_print_report(FILE * file) {
+    fprintf(file, "Garbage collector report\n");
+    fprintf(file, "  collections:      %llu\n", (unsigned long long)garbageCollectorStatistics.collections);
+    fprintf(file, "  pause time:       %.3f ms total, %.3f ms max\n", garbageCollectorStatistics.pauseTimeTotal * 1000,
+            garbageCollectorStatistics.pauseTimeMaximum * 1000);
+    fprintf(file, "  pause histogram: ");
+    for (uint32_t i = 0; i < GC_STATISTICS_PAUSE_BUCKETS; i++) {
+        fprintf(file, " %s: %llu%s", pauseBucketLabels[i],
+                (unsigned long long)garbageCollectorStatistics.pauseHistogram[i],
+                i + 1 < GC_STATISTICS_PAUSE_BUCKETS ? "," : "\n");
+    }
+    fprintf(file, "  bytes allocated:  %zu live, %llu total\n", virtualMachine.bytesAllocated,
+            (unsigned long long)garbageCollectorStatistics.bytesAllocatedTotal);
+    fprintf(file, "  bytes marked:     %llu\n", (unsigned long long)garbageCollectorStatistics.bytesMarked);
+    fprintf(file, "  bytes freed:      %llu\n", (unsigned long long)garbageCollectorStatistics.bytesFreed);
+    fprintf(file, "  survival rate:    %.2f (last collection)\n", garbageCollectorStatistics.survivalRate);
+    fprintf(file, "  allocation rate:  %.0f bytes/s\n", garbage_collector_statistics_allocation_rate());
+    fprintf(file, "  live objects:    ");
+    for (uint32_t i = 0; i < OBJECT_TYPE_COUNT; i++) {
+        fprintf(file, " %s: %llu%s", objectTypeNames[i], (unsigned long long)garbageCollectorStatistics.liveObjects[i],
+                i + 1 < OBJECT_TYPE_COUNT ? "," : "\n");
+    }
+}
+
+void garbage_collector_statistics_record_collection(size_t bytesBefore, size_t bytesAfter, clock_t start,
+                                                    clock_t end) {
+    double pauseTime = (double)(end - start) / CLOCKS_PER_SEC;
+    uint32_t bucket = 0;
+    while (bucket < GC_STATISTICS_PAUSE_BUCKETS - 1 && pauseTime >= pauseBucketBounds[bucket]) {
+        bucket++;
+    }
+    garbageCollectorStatistics.pauseHistogram[bucket]++;
+    garbageCollectorStatistics.collections++;
+    garbageCollectorStatistics.pauseTimeTotal += pauseTime;
+    if (pauseTime > garbageCollectorStatistics.pauseTimeMaximum) {
+        garbageCollectorStatistics.pauseTimeMaximum = pauseTime;
+    }
+    garbageCollectorStatistics.bytesMarked += bytesAfter;
+    garbageCollectorStatistics.bytesFreed += bytesBefore - bytesAfter;
+    garbageCollectorStatistics.survivalRate = bytesBefore ? (double)bytesAfter / (double)bytesBefore : 1.0;
+}
+
+void garbage_collector_statistics_reset(void) {
+    memset(&garbageCollectorStatistics, 0, sizeof(garbage_collector_statistics_t));
+    garbageCollectorStatistics.survivalRate = 1.0;
+    garbageCollectorStatistics.startTime = clock();
+}
+
+/// @brief Determines the amount of bytes that were allocated per second of processor time
+/// @return The allocation rate in bytes per second
+static double garbage_collector_statistics_allocation_rate(void) {
+    double elapsedTime = (double)(clock() - garbageCollectorStatistics.startTime) / CLOCKS_PER_SEC;
+    return elapsedTime > 0 ? (double)garbageCollectorStatistics.bytesAllocatedTotal / elapsedTime : 0.0;
+}
+
+/// @brief Sets a field of an instance that contains statistics
+/// @param instance The instance whose field is set
+/// @param name The name of the field
+/// @param value The value of the field
+static void garbage_collector_statistics_set_field(object_instance_t * instance, char const * name, value_t value) {
+    object_string_t * fieldName = object_copy_string(name, (uint32_t)strlen(name), false);
+    virtual_machine_push(OBJECT_VAL(fieldName));
+    value_hash_table_set(&instance->fields, fieldName, value);
+    virtual_machine_pop();
+}
@@ -0,0 +1,79 @@
+/****************************************************************************
+ * Copyright (C) 2022 by Frederik Tobner                                    *
+ *                                                                          *
+ * This file is part of Cellox.                                             *
+ *                                                                          *
+ * Permission to use, copy, modify, and distribute this software and its    *
+ * documentation under the terms of the GNU General Public License is       *
+ * hereby granted.                                                          *
+ * No representations are made about the suitability of this software for   *
+ * any purpose.                                                             *
+ * It is provided "as is" without express or implied warranty.              *
+ * See the <https://www.gnu.org/licenses/gpl-3.0.html/>GNU General Public   *
+ * License for more details.                                                *
+ ****************************************************************************/
+
+/**
+ * @file garbage_collector_statistics.h
+ * @brief Header file containing the declarations of the statistics that are collected about the garbage collector.
+ */
+
+#ifndef CELLOX_GARBAGE_COLLECTOR_STATISTICS_H_
+#define CELLOX_GARBAGE_COLLECTOR_STATISTICS_H_
+
+#include <stdio.h>
+#include <time.h>
+
+#include "../common.h"
+#include "../language-models/object.h"
+
+/// Amount of buckets in the histogram of the pause times (< 0.1 ms, < 1 ms, < 10 ms, < 100 ms and >= 100 ms)
+#define GC_STATISTICS_PAUSE_BUCKETS (5u)
+
+/// @brief Statistics about the garbage collector
+typedef struct {
+    /// The amount of garbage collections that have been performed
+    uint64_t collections;
+    /// The amount of collections per pause time bucket
+    uint64_t pauseHistogram[GC_STATISTICS_PAUSE_BUCKETS];
+    /// Total amount of bytes that were allocated by the virtual machine
+    uint64_t bytesAllocatedTotal;
+    /// Total amount of bytes that were still reachable after a collection
+    uint64_t bytesMarked;
+    /// Total amount of bytes that were reclaimed by the garbage collector
+    uint64_t bytesFreed;
+    /// The amount of objects per type that are currently allocated
+    uint64_t liveObjects[OBJECT_TYPE_COUNT];
+    /// The processor time that was spent collecting garbage (in seconds)
+    double pauseTimeTotal;
+    /// The longest pause of the program (in seconds)
+    double pauseTimeMaximum;
+    /// Share of the heap that survived the last collection
+    double survivalRate;
+    /// Processor time when the statistics were reset
+    clock_t startTime;
+} garbage_collector_statistics_t;
+
+/// Global statistics of the garbage collector
+extern garbage_collector_statistics_t garbageCollectorStatistics;
+
+/// @brief Creates a cellox instance that contains the statistics of the garbage collector
+/// @return The created instance
+object_instance_t * garbage_collector_statistics_create_instance(void);
+
+/// @brief Prints a report of the statistics of the garbage collector
+/// @param file The file the report is written to
+void garbage_collector_statistics_print_report(FILE * file);
+
+/// @brief Records a garbage collection
+/// @param bytesBefore The amount of bytes that were allocated before the collection
+/// @param bytesAfter The amount of bytes that are still allocated after the collection
+/// @param start The processor time when the collection has started
+/// @param end The processor time when the collection has ended
+void garbage_collector_statistics_record_collection(size_t bytesBefore, size_t bytesAfter, clock_t start,
+                                                    clock_t end);
+
+/// @brief Resets the statistics of the garbage collector
+void garbage_collector_statistics_reset(void);
+
+#endif
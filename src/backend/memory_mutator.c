@@ -24,12 +24,14 @@
 #include <stdlib.h>
 
 #include "garbage_collector.h"
+#include "garbage_collector_policy.h"
+#include "garbage_collector_statistics.h"
 #include "virtual_machine.h"
 
 void memory_mutator_free_objects(void) {
     object_t * object = virtualMachine.objects;
     while (object) {
-        object_t * next = object->next;
+        object_t * next = object_get_next(object);
         memory_mutator_free_object(object);
         object = next;
     }
@@ -42,12 +44,18 @@ void memory_mutator_free_objects(void) {
 void * memory_mutator_reallocate(void * pointer, size_t oldSize, size_t newSize) {
     virtualMachine.bytesAllocated += newSize - oldSize;
     if (newSize > oldSize) {
+        garbageCollectorStatistics.bytesAllocatedTotal += newSize - oldSize;
 #ifdef DEBUG_STRESS_GC
-        memory_collect_garbage();
+        garbage_collector_collect_garbage();
 #endif
         if (virtualMachine.bytesAllocated > virtualMachine.nextGC) {
             garbage_collector_collect_garbage();
         }
+        // The threshold of the garbage collector never exceeds the heap limit, so the heap was already collected
+        if (garbage_collector_policy_heap_limit_exceeded(virtualMachine.bytesAllocated)) {
+            virtualMachine.bytesAllocated -= newSize - oldSize;
+            virtual_machine_out_of_memory(newSize - oldSize);
+        }
     }
     if (!newSize) {
         free(pointer);
@@ -56,8 +64,8 @@ void * memory_mutator_reallocate(void * pointer, size_t oldSize, size_t newSize)
 
     void * result = realloc(pointer, newSize);
     if (!result) {
-        fprintf(stderr, "Failed too allocate memory");
-        exit(EXIT_CODE_SYSTEM_ERROR);
+        virtualMachine.bytesAllocated -= newSize - oldSize;
+        virtual_machine_out_of_memory(newSize - oldSize);
     }
     return result;
 }
@@ -68,11 +76,15 @@ void memory_mutator_free_object(object_t * object) {
 #ifdef DEBUG_LOG_GC
     printf("freed object %p of the type %s\n", (void *)object, object_stringify_type(object));
 #endif
-    switch (object->type) {
+    garbageCollectorStatistics.liveObjects[object_get_type(object)]--;
+    switch (object_get_type(object)) {
     case OBJECT_ARRAY:
         {
             object_dynamic_value_array_t * array = (object_dynamic_value_array_t *)object;
-            dynamic_value_array_free(&array->array);
+            // Borrowed values are freed together with the backing array
+            if (!array->backing) {
+                dynamic_value_array_free(&array->array);
+            }
             FREE(object_dynamic_value_array_t, object);
             break;
         }
@@ -83,17 +95,16 @@ void memory_mutator_free_object(object_t * object) {
         {
             object_class_t * celloxClass = (object_class_t *)object;
             // If a class is unreachable, all the methods are unreachable, too.
-            value_hash_table_free(&celloxClass->methods);
+            value_hash_table_free(&celloxClass->methodSlots);
+            dynamic_value_array_free(&celloxClass->methods);
             FREE(object_class_t, object);
             break;
         }
     case OBJECT_CLOSURE:
         {
-            object_closure_t * closure = (object_closure_t *)object;
-            // If a closure is unreachable we also need to free all the memory used by the upvalues that are captured by
-            // the closure
-            FREE_ARRAY(object_upvalue_t *, closure->upvalues, closure->upvalueCount);
-            FREE(object_closure_t, object);
+            // The references to the upvalues that are captured by a closure are stored inline, so they are freed
+            // together with the closure
+            memory_mutator_reallocate(object, OBJECT_CLOSURE_SIZE(((object_closure_t *)object)->upvalueCount), 0);
             break;
         }
     case OBJECT_FUNCTION:
@@ -112,15 +123,25 @@ void memory_mutator_free_object(object_t * object) {
             FREE(object_instance_t, object);
             break;
         }
+    case OBJECT_MAP:
+        value_map_free(&((object_map_t *)object)->map);
+        FREE(object_map_t, object);
+        break;
     case OBJECT_NATIVE:
         FREE(object_native_t, object);
         break;
     case OBJECT_STRING:
         {
-            object_string_t * string = (object_string_t *)object;
-            // If a string is unreachable we need to free the memory the underlying character sequence occupies
-            FREE_ARRAY(char, string->chars, string->length + 1);
-            FREE(object_string_t, object);
+            // The character sequence of a flat string is stored inline, so it is freed together with the string
+            memory_mutator_reallocate(object, object_string_size((object_string_t *)object), 0);
+            break;
+        }
+    case OBJECT_TYPED_ARRAY:
+        {
+            object_typed_array_t * array = (object_typed_array_t *)object;
+            FREE_ARRAY(uint8_t, array->allocation,
+                       array->count * object_typed_array_element_size(array->type) + OBJECT_TYPED_ARRAY_ALIGNMENT);
+            FREE(object_typed_array_t, object);
             break;
         }
     case OBJECT_UPVALUE:
@@ -23,6 +23,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #ifdef OS_WINDOWS
@@ -36,15 +37,35 @@
 #include "../language-models/object.h"
 #include "../language-models/value.h"
 #include "../string_utils.h"
+#include "garbage_collector_statistics.h"
 #include "memory_mutator.h"
 #include "native_functions.h"
+#include "typed_array_kernels.h"
 #include "virtual_machine.h"
 
 typedef enum {
     /// Native append_to_file function
     NATIVE_FUNCTION_APPEND_TO_FILE,
+    /// Native array_binary_search function
+    NATIVE_FUNCTION_ARRAY_BINARY_SEARCH,
+    /// Native array_filter function
+    NATIVE_FUNCTION_ARRAY_FILTER,
+    /// Native array_index_of function
+    NATIVE_FUNCTION_ARRAY_INDEX_OF,
+    /// Native array_insert function
+    NATIVE_FUNCTION_ARRAY_INSERT,
     /// Native array_length function
     NATIVE_FUNCTION_ARRAY_LENGTH,
+    /// Native array_map function
+    NATIVE_FUNCTION_ARRAY_MAP,
+    /// Native array_reduce function
+    NATIVE_FUNCTION_ARRAY_REDUCE,
+    /// Native array_remove function
+    NATIVE_FUNCTION_ARRAY_REMOVE,
+    /// Native array_reserve function
+    NATIVE_FUNCTION_ARRAY_RESERVE,
+    /// Native array_sort function
+    NATIVE_FUNCTION_ARRAY_SORT,
     /// Native asci to int function
     NATIVE_FUNCTION_ASCI_TO_NUMERICAL,
     /// Native class_of function
@@ -57,10 +78,32 @@ typedef enum {
     NATIVE_FUNCTION_EXIT,
     /// Native exponential function
     NATIVE_FUNCTION_EXPONENTIAL,
+    /// Native float64_array function
+    NATIVE_FUNCTION_FLOAT64_ARRAY,
+    /// Native gc_stats function
+    NATIVE_FUNCTION_GC_STATS,
+    /// Native int32_array function
+    NATIVE_FUNCTION_INT32_ARRAY,
     /// Native logarithm function
     NATIVE_FUNCTION_LOG,
     /// Native log 10 function
     NATIVE_FUNCTION_LOG10,
+    /// Native map function
+    NATIVE_FUNCTION_MAP,
+    /// Native map_count function
+    NATIVE_FUNCTION_MAP_COUNT,
+    /// Native map_get function
+    NATIVE_FUNCTION_MAP_GET,
+    /// Native map_has function
+    NATIVE_FUNCTION_MAP_HAS,
+    /// Native map_keys function
+    NATIVE_FUNCTION_MAP_KEYS,
+    /// Native map_remove function
+    NATIVE_FUNCTION_MAP_REMOVE,
+    /// Native map_reserve function
+    NATIVE_FUNCTION_MAP_RESERVE,
+    /// Native map_values function
+    NATIVE_FUNCTION_MAP_VALUES,
     /// NAtive numerical value to asci function
     NATIVE_FUNCTION_NUMERICAL_TO_ASCI,
     /// Native on_linux function
@@ -93,6 +136,32 @@ typedef enum {
     NATIVE_FUNCTION_SYSTEM,
     /// Native tangent function
     NATIVE_FUNCTION_TANGENT,
+    /// Native typed_array_add function
+    NATIVE_FUNCTION_TYPED_ARRAY_ADD,
+    /// Native typed_array_axpy function
+    NATIVE_FUNCTION_TYPED_ARRAY_AXPY,
+    /// Native typed_array_copy function
+    NATIVE_FUNCTION_TYPED_ARRAY_COPY,
+    /// Native typed_array_divide function
+    NATIVE_FUNCTION_TYPED_ARRAY_DIVIDE,
+    /// Native typed_array_dot function
+    NATIVE_FUNCTION_TYPED_ARRAY_DOT,
+    /// Native typed_array_fill function
+    NATIVE_FUNCTION_TYPED_ARRAY_FILL,
+    /// Native typed_array_max function
+    NATIVE_FUNCTION_TYPED_ARRAY_MAX,
+    /// Native typed_array_min function
+    NATIVE_FUNCTION_TYPED_ARRAY_MIN,
+    /// Native typed_array_multiply function
+    NATIVE_FUNCTION_TYPED_ARRAY_MULTIPLY,
+    /// Native typed_array_scale function
+    NATIVE_FUNCTION_TYPED_ARRAY_SCALE,
+    /// Native typed_array_subtract function
+    NATIVE_FUNCTION_TYPED_ARRAY_SUBTRACT,
+    /// Native typed_array_sum function
+    NATIVE_FUNCTION_TYPED_ARRAY_SUM,
+    /// Native uint8_array function
+    NATIVE_FUNCTION_UINT8_ARRAY,
     /// Native wait function
     NATIVE_FUNCTION_WAIT,
     /// Native write to file function
@@ -103,9 +172,32 @@ native_function_config_t native_function_configs[] = {
     [NATIVE_FUNCTION_APPEND_TO_FILE] = {.functionName = "append_to_file",
                                         .function = native_functions_append_to_file,
                                         .arrity = 2},
+    [NATIVE_FUNCTION_ARRAY_BINARY_SEARCH] = {.functionName = "array_binary_search",
+                                             .function = native_functions_array_binary_search,
+                                             .arrity = 2},
+    [NATIVE_FUNCTION_ARRAY_FILTER] = {.functionName = "array_filter",
+                                      .function = native_functions_array_filter,
+                                      .arrity = 2},
+    [NATIVE_FUNCTION_ARRAY_INDEX_OF] = {.functionName = "array_index_of",
+                                        .function = native_functions_array_index_of,
+                                        .arrity = 2},
+    [NATIVE_FUNCTION_ARRAY_INSERT] = {.functionName = "array_insert",
+                                      .function = native_functions_array_insert,
+                                      .arrity = 3},
     [NATIVE_FUNCTION_ARRAY_LENGTH] = {.functionName = "array_length",
                                       .function = native_functions_array_length,
                                       .arrity = 1},
+    [NATIVE_FUNCTION_ARRAY_MAP] = {.functionName = "array_map", .function = native_functions_array_map, .arrity = 2},
+    [NATIVE_FUNCTION_ARRAY_REDUCE] = {.functionName = "array_reduce",
+                                      .function = native_functions_array_reduce,
+                                      .arrity = 3},
+    [NATIVE_FUNCTION_ARRAY_REMOVE] = {.functionName = "array_remove",
+                                      .function = native_functions_array_remove,
+                                      .arrity = 2},
+    [NATIVE_FUNCTION_ARRAY_RESERVE] = {.functionName = "array_reserve",
+                                       .function = native_functions_array_reserve,
+                                       .arrity = 2},
+    [NATIVE_FUNCTION_ARRAY_SORT] = {.functionName = "array_sort", .function = native_functions_array_sort},
     [NATIVE_FUNCTION_ASCI_TO_NUMERICAL] = {.functionName = "asci_to_num",
                                            .function = native_functions_asci_to_numerical,
                                            .arrity = 1},
@@ -116,8 +208,25 @@ native_function_config_t native_function_configs[] = {
     [NATIVE_FUNCTION_EXPONENTIAL] = {.functionName = "exponential",
                                      .function = native_functions_exponential,
                                      .arrity = 1},
+    [NATIVE_FUNCTION_FLOAT64_ARRAY] = {.functionName = "float64_array",
+                                       .function = native_functions_float64_array,
+                                       .arrity = 1},
+    [NATIVE_FUNCTION_GC_STATS] = {.functionName = "gc_stats", .function = native_functions_gc_stats},
+    [NATIVE_FUNCTION_INT32_ARRAY] = {.functionName = "int32_array",
+                                     .function = native_functions_int32_array,
+                                     .arrity = 1},
     [NATIVE_FUNCTION_LOG] = {.functionName = "logarithm", .function = native_functions_logarithm, .arrity = 1},
     [NATIVE_FUNCTION_LOG10] = {.functionName = "logarithm10", .function = native_functions_logarithm10, .arrity = 1},
+    [NATIVE_FUNCTION_MAP] = {.functionName = "map", .function = native_functions_map},
+    [NATIVE_FUNCTION_MAP_COUNT] = {.functionName = "map_count", .function = native_functions_map_count, .arrity = 1},
+    [NATIVE_FUNCTION_MAP_GET] = {.functionName = "map_get", .function = native_functions_map_get, .arrity = 3},
+    [NATIVE_FUNCTION_MAP_HAS] = {.functionName = "map_has", .function = native_functions_map_has, .arrity = 2},
+    [NATIVE_FUNCTION_MAP_KEYS] = {.functionName = "map_keys", .function = native_functions_map_keys, .arrity = 1},
+    [NATIVE_FUNCTION_MAP_REMOVE] = {.functionName = "map_remove", .function = native_functions_map_remove, .arrity = 2},
+    [NATIVE_FUNCTION_MAP_RESERVE] = {.functionName = "map_reserve",
+                                     .function = native_functions_map_reserve,
+                                     .arrity = 2},
+    [NATIVE_FUNCTION_MAP_VALUES] = {.functionName = "map_values", .function = native_functions_map_values, .arrity = 1},
     [NATIVE_FUNCTION_NUMERICAL_TO_ASCI] = {.functionName = "num_to_asci",
                                            .function = native_functions_numerical_to_asci,
                                            .arrity = 1},
@@ -144,14 +253,73 @@ native_function_config_t native_function_configs[] = {
                                            .arrity = 3},
     [NATIVE_FUNCTION_SYSTEM] = {.functionName = "system", .function = native_functions_system, .arrity = 1},
     [NATIVE_FUNCTION_TANGENT] = {.functionName = "tangent", .function = native_functions_tangent, .arrity = 1},
+    [NATIVE_FUNCTION_TYPED_ARRAY_ADD] = {.functionName = "typed_array_add",
+                                         .function = native_functions_typed_array_add,
+                                         .arrity = 2},
+    [NATIVE_FUNCTION_TYPED_ARRAY_AXPY] = {.functionName = "typed_array_axpy",
+                                          .function = native_functions_typed_array_axpy,
+                                          .arrity = 3},
+    [NATIVE_FUNCTION_TYPED_ARRAY_COPY] = {.functionName = "typed_array_copy",
+                                          .function = native_functions_typed_array_copy,
+                                          .arrity = 2},
+    [NATIVE_FUNCTION_TYPED_ARRAY_DIVIDE] = {.functionName = "typed_array_divide",
+                                            .function = native_functions_typed_array_divide,
+                                            .arrity = 2},
+    [NATIVE_FUNCTION_TYPED_ARRAY_DOT] = {.functionName = "typed_array_dot",
+                                         .function = native_functions_typed_array_dot,
+                                         .arrity = 2},
+    [NATIVE_FUNCTION_TYPED_ARRAY_FILL] = {.functionName = "typed_array_fill",
+                                          .function = native_functions_typed_array_fill,
+                                          .arrity = 2},
+    [NATIVE_FUNCTION_TYPED_ARRAY_MAX] = {.functionName = "typed_array_max",
+                                         .function = native_functions_typed_array_max,
+                                         .arrity = 1},
+    [NATIVE_FUNCTION_TYPED_ARRAY_MIN] = {.functionName = "typed_array_min",
+                                         .function = native_functions_typed_array_min,
+                                         .arrity = 1},
+    [NATIVE_FUNCTION_TYPED_ARRAY_MULTIPLY] = {.functionName = "typed_array_multiply",
+                                              .function = native_functions_typed_array_multiply,
+                                              .arrity = 2},
+    [NATIVE_FUNCTION_TYPED_ARRAY_SCALE] = {.functionName = "typed_array_scale",
+                                           .function = native_functions_typed_array_scale,
+                                           .arrity = 2},
+    [NATIVE_FUNCTION_TYPED_ARRAY_SUBTRACT] = {.functionName = "typed_array_subtract",
+                                              .function = native_functions_typed_array_subtract,
+                                              .arrity = 2},
+    [NATIVE_FUNCTION_TYPED_ARRAY_SUM] = {.functionName = "typed_array_sum",
+                                         .function = native_functions_typed_array_sum,
+                                         .arrity = 1},
+    [NATIVE_FUNCTION_UINT8_ARRAY] = {.functionName = "uint8_array",
+                                     .function = native_functions_uint8_array,
+                                     .arrity = 1},
     [NATIVE_FUNCTION_WAIT] = {.functionName = "wait", .function = native_functions_wait, .arrity = 1},
     [NATIVE_FUNCTION_WRITE_TO_FILE] = {
         .functionName = "write_to_file", .function = native_functions_write_to_file, .arrity = 2}};
 
 #define MAX_READ_LINE_INPUT (1024)
 
+/// Partitions of an array that are smaller than this are sorted using insertion sort
+#define INSERTION_SORT_THRESHOLD (16u)
+
 static void native_functions_arguments_error(char const * format, ...);
+static void native_functions_apply(uint8_t, typed_array_kernels_operation, value_t const *);
+static object_dynamic_value_array_t * native_functions_assert_array(uint8_t, value_t);
 static void native_functions_assert_arrity(uint8_t, uint32_t);
+static uint32_t native_functions_assert_index(uint8_t, value_t, uint32_t);
+static object_map_t * native_functions_assert_map(uint8_t, value_t);
+static double native_functions_assert_number(uint8_t, value_t);
+static object_typed_array_t * native_functions_assert_typed_array(uint8_t, value_t);
+static void native_functions_assert_typed_arrays(uint8_t, value_t, value_t);
+static value_t native_functions_call(value_t, uint32_t, value_t const *);
+static int32_t native_functions_compare_elements(object_dynamic_value_array_t *, value_t, uint32_t, uint32_t);
+static int32_t native_functions_compare_values(value_t, value_t);
+static void native_functions_heap_sort(object_dynamic_value_array_t *, value_t, uint32_t, uint32_t);
+static void native_functions_insertion_sort(object_dynamic_value_array_t *, value_t, uint32_t, uint32_t);
+static void native_functions_introsort(object_dynamic_value_array_t *, value_t, uint32_t, uint32_t, uint32_t);
+static object_dynamic_value_array_t * native_functions_map_entries(object_map_t *, bool);
+static object_typed_array_t * native_functions_new_typed_array(uint8_t, object_typed_array_type, value_t);
+static void native_functions_sift_down(object_dynamic_value_array_t *, value_t, uint32_t, uint32_t, uint32_t);
+static inline void native_functions_swap_elements(object_dynamic_value_array_t *, uint32_t, uint32_t);
 static size_t native_functions_value_size(value_t value);
 
 native_function_config_t * native_functions_get_function_configs(void) {
@@ -178,8 +346,74 @@ value_t native_functions_append_to_file(uint32_t argCount, value_t const * args)
     return TRUE_VAL;
 }
 
+value_t native_functions_array_binary_search(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_ARRAY_BINARY_SEARCH, argCount);
+    object_dynamic_value_array_t * array = native_functions_assert_array(NATIVE_FUNCTION_ARRAY_BINARY_SEARCH, *args);
+    uint32_t low = 0u;
+    uint32_t high = array->array.count;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2u;
+        int32_t comparison = native_functions_compare_values(array->array.values[middle], *(args + 1));
+        if (!comparison) {
+            return NUMBER_VAL(middle);
+        }
+        if (comparison < 0) {
+            low = middle + 1u;
+        } else {
+            high = middle;
+        }
+    }
+    return NUMBER_VAL(-1);
+}
+
+value_t native_functions_array_filter(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_ARRAY_FILTER, argCount);
+    object_dynamic_value_array_t * array = native_functions_assert_array(NATIVE_FUNCTION_ARRAY_FILTER, *args);
+    object_dynamic_value_array_t * result = object_new_dynamic_value_array();
+    // The result is kept on the stack, so it is not collected while the predicate is executed
+    virtual_machine_push(OBJECT_VAL(result));
+    // The predicate can change the array, so the count and the values are read again after every call
+    for (uint32_t i = 0; i < array->array.count; i++) {
+        value_t value = array->array.values[i];
+        // The value is kept on the stack, in case the predicate removes it from the array
+        virtual_machine_push(value);
+        value_t fulfilled = native_functions_call(*(args + 1), 1u, &value);
+        if (!IS_NULL(fulfilled) && (!IS_BOOL(fulfilled) || AS_BOOL(fulfilled))) {
+            object_array_write(result, value);
+        }
+        virtual_machine_pop();
+    }
+    virtual_machine_pop();
+    return OBJECT_VAL(result);
+}
+
+value_t native_functions_array_index_of(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_ARRAY_INDEX_OF, argCount);
+    object_dynamic_value_array_t * array = native_functions_assert_array(NATIVE_FUNCTION_ARRAY_INDEX_OF, *args);
+    for (uint32_t i = 0; i < array->array.count; i++) {
+        if (value_values_equal(array->array.values[i], *(args + 1))) {
+            return NUMBER_VAL(i);
+        }
+    }
+    return NUMBER_VAL(-1);
+}
+
+value_t native_functions_array_insert(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_ARRAY_INSERT, argCount);
+    object_dynamic_value_array_t * array = native_functions_assert_array(NATIVE_FUNCTION_ARRAY_INSERT, *args);
+    // A value can also be inserted after the last value of the array
+    uint32_t index = native_functions_assert_index(NATIVE_FUNCTION_ARRAY_INSERT, *(args + 1), array->array.count + 1u);
+    object_array_prepare_mutation(array);
+    object_array_track_value(array, *(args + 2));
+    dynamic_value_array_insert(&array->array, index, *(args + 2));
+    return NULL_VAL;
+}
+
 value_t native_functions_array_length(uint32_t argCount, value_t const * args) {
     native_functions_assert_arrity(NATIVE_FUNCTION_ARRAY_LENGTH, argCount);
+    if (IS_TYPED_ARRAY(*args)) {
+        return NUMBER_VAL(AS_TYPED_ARRAY(*args)->count);
+    }
     if (!IS_ARRAY(*args)) {
         native_functions_arguments_error(
             "array_length can only be called with an array as argument but was called with %s",
@@ -188,6 +422,76 @@ value_t native_functions_array_length(uint32_t argCount, value_t const * args) {
     return NUMBER_VAL(AS_ARRAY(*args)->array.count);
 }
 
+value_t native_functions_array_map(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_ARRAY_MAP, argCount);
+    object_dynamic_value_array_t * array = native_functions_assert_array(NATIVE_FUNCTION_ARRAY_MAP, *args);
+    object_dynamic_value_array_t * result = object_new_dynamic_value_array();
+    // The result is kept on the stack, so it is not collected while the function is executed
+    virtual_machine_push(OBJECT_VAL(result));
+    // The result is sized upfront, so writing a result of a call does not trigger a garbage collection
+    uint32_t count = array->array.count;
+    dynamic_value_array_reserve(&result->array, count);
+    for (uint32_t i = 0; i < count && i < array->array.count; i++) {
+        value_t value = array->array.values[i];
+        object_array_write(result, native_functions_call(*(args + 1), 1u, &value));
+    }
+    virtual_machine_pop();
+    return OBJECT_VAL(result);
+}
+
+value_t native_functions_array_reduce(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_ARRAY_REDUCE, argCount);
+    object_dynamic_value_array_t * array = native_functions_assert_array(NATIVE_FUNCTION_ARRAY_REDUCE, *args);
+    // The accumulator and the current value are passed to the function
+    value_t arguments[2] = {*(args + 2)};
+    for (uint32_t i = 0; i < array->array.count; i++) {
+        arguments[1] = array->array.values[i];
+        arguments[0] = native_functions_call(*(args + 1), 2u, arguments);
+    }
+    return arguments[0];
+}
+
+value_t native_functions_array_remove(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_ARRAY_REMOVE, argCount);
+    object_dynamic_value_array_t * array = native_functions_assert_array(NATIVE_FUNCTION_ARRAY_REMOVE, *args);
+    uint32_t index = native_functions_assert_index(NATIVE_FUNCTION_ARRAY_REMOVE, *(args + 1), array->array.count);
+    object_array_prepare_mutation(array);
+    value_t removed = array->array.values[index];
+    dynamic_value_array_remove(&array->array, index);
+    return removed;
+}
+
+value_t native_functions_array_reserve(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_ARRAY_RESERVE, argCount);
+    object_dynamic_value_array_t * array = native_functions_assert_array(NATIVE_FUNCTION_ARRAY_RESERVE, *args);
+    if (!IS_NUMBER(*(args + 1)) || AS_NUMBER(*(args + 1)) < 0 || AS_NUMBER(*(args + 1)) > UINT32_MAX) {
+        native_functions_arguments_error("array_reserve can only be called with a positive number as capacity");
+    }
+    object_array_prepare_mutation(array);
+    dynamic_value_array_reserve(&array->array, (uint32_t)AS_NUMBER(*(args + 1)));
+    return NULL_VAL;
+}
+
+value_t native_functions_array_sort(uint32_t argCount, value_t const * args) {
+    // The arrity is not asserted because the comparator is optional
+    if (argCount != 1u && argCount != 2u) {
+        native_functions_arguments_error("array_sort expects 1 or 2 arguments but was called with %d", argCount);
+    }
+    object_dynamic_value_array_t * array = native_functions_assert_array(NATIVE_FUNCTION_ARRAY_SORT, *args);
+    // Without a comparator numbers and strings are sorted in ascending order
+    value_t comparator = argCount == 2u ? *(args + 1) : NULL_VAL;
+    object_array_prepare_mutation(array);
+    if (array->array.count > 1u) {
+        // After 2 * log2(n) levels of recursion the partitions are sorted using heapsort
+        uint32_t depthLimit = 0u;
+        for (uint32_t count = array->array.count; count > 1u; count >>= 1u) {
+            depthLimit += 2u;
+        }
+        native_functions_introsort(array, comparator, 0u, array->array.count - 1u, depthLimit);
+    }
+    return *args;
+}
+
 value_t native_functions_asci_to_numerical(uint32_t argCount, value_t const * args) {
     native_functions_assert_arrity(NATIVE_FUNCTION_ASCI_TO_NUMERICAL, argCount);
     if (!IS_STRING(*args)) {
@@ -199,7 +503,7 @@ value_t native_functions_asci_to_numerical(uint32_t argCount, value_t const * ar
     if (character->length != 1) {
         native_functions_arguments_error("Can only determine the ssci value of a single character");
     }
-    return NUMBER_VAL(character->chars[0]);
+    return NUMBER_VAL(object_string_chars(character)[0]);
 }
 
 value_t native_functions_classof(uint32_t argCount, value_t const * args) {
@@ -241,6 +545,22 @@ value_t native_functions_exponential(uint32_t argCount, value_t const * args) {
     return NUMBER_VAL(exp(AS_NUMBER(*args)));
 }
 
+value_t native_functions_float64_array(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_FLOAT64_ARRAY, argCount);
+    return OBJECT_VAL(
+        native_functions_new_typed_array(NATIVE_FUNCTION_FLOAT64_ARRAY, OBJECT_TYPED_ARRAY_FLOAT64, *args));
+}
+
+value_t native_functions_gc_stats(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_GC_STATS, argCount);
+    return OBJECT_VAL(garbage_collector_statistics_create_instance());
+}
+
+value_t native_functions_int32_array(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_INT32_ARRAY, argCount);
+    return OBJECT_VAL(native_functions_new_typed_array(NATIVE_FUNCTION_INT32_ARRAY, OBJECT_TYPED_ARRAY_INT32, *args));
+}
+
 value_t native_functions_logarithm(uint32_t argCount, value_t const * args) {
     native_functions_assert_arrity(NATIVE_FUNCTION_LOG, argCount);
     if (!IS_NUMBER(*args)) {
@@ -257,6 +577,72 @@ value_t native_functions_logarithm10(uint32_t argCount, value_t const * args) {
     return NUMBER_VAL(log10(AS_NUMBER(*args)));
 }
 
+value_t native_functions_map(uint32_t argCount, value_t const * args) {
+    // The arrity is not asserted because the capacity is optional
+    if (argCount > 1u) {
+        native_functions_arguments_error("map expects 0 or 1 arguments but was called with %d", argCount);
+    }
+    object_map_t * map = object_new_map();
+    if (argCount) {
+        if (!IS_NUMBER(*args) || AS_NUMBER(*args) < 0 || AS_NUMBER(*args) > UINT32_MAX) {
+            native_functions_arguments_error("map can only be called with a positive number as capacity");
+        }
+        // The map is kept on the stack, because allocating the entries might trigger a garbage collection
+        virtual_machine_push(OBJECT_VAL(map));
+        value_map_reserve(&map->map, (uint32_t)AS_NUMBER(*args));
+        virtual_machine_pop();
+    }
+    return OBJECT_VAL(map);
+}
+
+value_t native_functions_map_count(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_MAP_COUNT, argCount);
+    return NUMBER_VAL(native_functions_assert_map(NATIVE_FUNCTION_MAP_COUNT, *args)->map.count);
+}
+
+value_t native_functions_map_get(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_MAP_GET, argCount);
+    object_map_t * map = native_functions_assert_map(NATIVE_FUNCTION_MAP_GET, *args);
+    value_t value;
+    // The last argument is returned if the map does not contain the key
+    return value_map_get(&map->map, *(args + 1), &value) ? value : *(args + 2);
+}
+
+value_t native_functions_map_has(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_MAP_HAS, argCount);
+    object_map_t * map = native_functions_assert_map(NATIVE_FUNCTION_MAP_HAS, *args);
+    value_t value;
+    return BOOL_VAL(value_map_get(&map->map, *(args + 1), &value));
+}
+
+value_t native_functions_map_keys(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_MAP_KEYS, argCount);
+    return OBJECT_VAL(
+        native_functions_map_entries(native_functions_assert_map(NATIVE_FUNCTION_MAP_KEYS, *args), true));
+}
+
+value_t native_functions_map_remove(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_MAP_REMOVE, argCount);
+    object_map_t * map = native_functions_assert_map(NATIVE_FUNCTION_MAP_REMOVE, *args);
+    return BOOL_VAL(value_map_delete(&map->map, *(args + 1)));
+}
+
+value_t native_functions_map_reserve(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_MAP_RESERVE, argCount);
+    object_map_t * map = native_functions_assert_map(NATIVE_FUNCTION_MAP_RESERVE, *args);
+    if (!IS_NUMBER(*(args + 1)) || AS_NUMBER(*(args + 1)) < 0 || AS_NUMBER(*(args + 1)) > UINT32_MAX) {
+        native_functions_arguments_error("map_reserve can only be called with a positive number as capacity");
+    }
+    value_map_reserve(&map->map, (uint32_t)AS_NUMBER(*(args + 1)));
+    return NULL_VAL;
+}
+
+value_t native_functions_map_values(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_MAP_VALUES, argCount);
+    return OBJECT_VAL(
+        native_functions_map_entries(native_functions_assert_map(NATIVE_FUNCTION_MAP_VALUES, *args), false));
+}
+
 value_t native_functions_numerical_to_asci(uint32_t argCount, value_t const * args) {
     native_functions_assert_arrity(NATIVE_FUNCTION_ASCI_TO_NUMERICAL, argCount);
     if (!IS_NUMBER(*args)) {
@@ -268,8 +654,7 @@ value_t native_functions_numerical_to_asci(uint32_t argCount, value_t const * ar
     if (number < 0 || number > 255) {
         native_functions_arguments_error("Can not convert number %d to asci value", number);
     }
-    char numberAsChar = (char)number;
-    return OBJECT_VAL(object_copy_string(&numberAsChar, 1, false));
+    return OBJECT_VAL(virtual_machine_character_string((char)number));
 }
 
 value_t native_functions_on_linux(uint32_t argCount, value_t const * args) {
@@ -309,22 +694,23 @@ value_t native_functions_print_formated(uint32_t argCount, value_t const * args)
         return NULL_VAL;
     }
     object_string_t * string = AS_STRING(*args);
+    char const * chars = object_string_cstring(string);
     uint32_t placeHolderCounter = 1;
     for (size_t i = 0; i < string->length; i++) {
-        if (string->chars[i] == '{') {
+        if (chars[i] == '{') {
             i++;
-            if (string->chars[i] == '}') {
+            if (chars[i] == '}') {
                 if (placeHolderCounter > argCount) {
                     native_functions_arguments_error("Can not automatically infer value");
                 }
                 value_print(*(args + placeHolderCounter));
 
-            } else if (isdigit(string->chars[i])) {
-                int specifiedIndex = atoi(&string->chars[i]);
-                while (isdigit(string->chars[i])) {
+            } else if (isdigit(chars[i])) {
+                int specifiedIndex = atoi(&chars[i]);
+                while (isdigit(chars[i])) {
                     i++;
                 }
-                if (string->chars[i] != '}') {
+                if (chars[i] != '}') {
                     native_functions_arguments_error("Expect '}' in format specifier");
                 }
                 if (specifiedIndex >= argCount - 1) {
@@ -336,7 +722,7 @@ value_t native_functions_print_formated(uint32_t argCount, value_t const * args)
             }
             placeHolderCounter++;
         } else {
-            fputc(string->chars[i], stdout);
+            fputc(chars[i], stdout);
         }
     }
 
@@ -353,7 +739,7 @@ value_t native_functions_read_file(uint32_t argCount, value_t const * args) {
     if (!IS_STRING(*args)) {
         native_functions_arguments_error("read_file can only be called with a string as argument");
     }
-    char * path = AS_CSTRING(*args);
+    char const * path = AS_CSTRING(*args);
     // Open file in read-only mode
     FILE * file = fopen(path, "rb");
     if (!file) {
@@ -362,29 +748,35 @@ value_t native_functions_read_file(uint32_t argCount, value_t const * args) {
     // Seek end of the file
     fseek(file, 0L, SEEK_END);
     // Store filesize
-    size_t fileSize = ftell(file);
-    // Rewind filepointer to the beginning of the file
-    rewind(file);
-    // Allocate memory apropriate to store the file
-    char * buffer = (char *)malloc(fileSize);
-    if (!buffer) {
+    long fileSize = ftell(file);
+    // The file is closed before the string is allocated, because an allocation that fails does not return
+    fclose(file);
+    if (fileSize < 0) {
         return NULL_VAL;
     }
-    // Store amount of read bytes
-    size_t bytesRead = fread(buffer, sizeof(char), fileSize, file);
-    if (bytesRead < fileSize) {
+    if ((uint64_t)fileSize > UINT32_MAX) {
+        virtual_machine_abort("read_file can not read the file %s, because it is larger than 4 GiB", path);
+    }
+    // The content of the file is read directly into the string, it is neither hashed nor interned
+    object_string_t * content = object_allocate_string((uint32_t)fileSize);
+    file = fopen(path, "rb");
+    if (!file) {
         return NULL_VAL;
     }
+    // Store amount of read bytes
+    size_t bytesRead = fread(content->chars, sizeof(char), (size_t)fileSize, file);
     fclose(file);
-    // Create cellox string from content stored in the character buffer
-    return OBJECT_VAL(object_copy_string(buffer, fileSize, false));
+    if (bytesRead < (size_t)fileSize) {
+        return NULL_VAL;
+    }
+    return OBJECT_VAL(content);
 }
 
 value_t native_functions_read_key(uint32_t argCount, value_t const * args) {
     native_functions_assert_arrity(NATIVE_FUNCTION_READ_KEY, argCount);
     char character = getchar();
     object_string_t result;
-    return OBJECT_VAL(object_copy_string(&character, 1, false));
+    return OBJECT_VAL(virtual_machine_character_string(character));
 }
 
 value_t native_functions_read_line(uint32_t argCount, value_t const * args) {
@@ -392,7 +784,7 @@ value_t native_functions_read_line(uint32_t argCount, value_t const * args) {
     char line[MAX_READ_LINE_INPUT];
     object_string_t result;
     fgets(line, sizeof(line), stdin);
-    return OBJECT_VAL(object_copy_string(line, strlen(line) - 1, false));
+    return OBJECT_VAL(object_new_string(line, strlen(line) - 1));
 }
 
 value_t native_functions_sine(uint32_t argCount, value_t const * args) {
@@ -414,7 +806,8 @@ value_t native_functions_string_hash(uint32_t argCount, value_t const * args) {
         native_functions_arguments_error("strlen can only be called with a string as argument but was called with %s",
                                          value_stringify_type(*args));
     }
-    return NUMBER_VAL(AS_STRING(*args)->hash);
+    // The hash value is calculated when it is needed for the first time
+    return NUMBER_VAL(object_string_hash(AS_STRING(*args)));
 }
 
 value_t native_functions_string_length(uint32_t argCount, value_t const * args) {
@@ -423,7 +816,8 @@ value_t native_functions_string_length(uint32_t argCount, value_t const * args)
         native_functions_arguments_error("strlen can only be called with a string as argument but was called with %s",
                                          value_stringify_type(*args));
     }
-    return NUMBER_VAL(strlen(AS_CSTRING(*args)));
+    // The length of a rope is known without flattening it
+    return NUMBER_VAL(AS_STRING(*args)->length);
 }
 
 value_t native_functions_string_replace_at(uint32_t argCount, value_t const * args) {
@@ -454,12 +848,19 @@ value_t native_functions_string_replace_at(uint32_t argCount, value_t const * ar
     if (num >= str->length || num < 0) {
         native_functions_arguments_error("accessed string out of bounds at index %d", num);
     }
-    // We need to allocate a new character sequnce so no other objects are affected
-    char * newCharacterSequence = malloc(str->length + 1);
-    memcpy(newCharacterSequence, str->chars, str->length);
-    newCharacterSequence[num] = character->chars[0];
-    newCharacterSequence[str->length] = '\0';
-    object_string_t * newString = object_take_string(newCharacterSequence, str->length);
+    // We need to allocate a new string so no other objects are affected
+    char const * chars = object_string_chars(str);
+    char replacement = object_string_chars(character)[0];
+    if (chars[num] == replacement) {
+        // Strings are immutable, so the string can be reused if the character does not change
+        return *args;
+    }
+    if (str->length == 1u) {
+        return OBJECT_VAL(virtual_machine_character_string(replacement));
+    }
+    object_string_t * newString = object_allocate_string(str->length);
+    memcpy(newString->chars, chars, str->length);
+    newString->chars[num] = replacement;
     return OBJECT_VAL(newString);
 }
 
@@ -480,6 +881,158 @@ value_t native_functions_tangent(uint32_t argCount, value_t const * args) {
     return NUMBER_VAL(tan(AS_NUMBER(*args)));
 }
 
+value_t native_functions_typed_array_add(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_ADD, argCount);
+    native_functions_apply(NATIVE_FUNCTION_TYPED_ARRAY_ADD, TYPED_ARRAY_KERNELS_ADD, args);
+    return NULL_VAL;
+}
+
+value_t native_functions_typed_array_axpy(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_AXPY, argCount);
+    double alpha = native_functions_assert_number(NATIVE_FUNCTION_TYPED_ARRAY_AXPY, *args);
+    native_functions_assert_typed_arrays(NATIVE_FUNCTION_TYPED_ARRAY_AXPY, *(args + 1), *(args + 2));
+    object_typed_array_t * x = AS_TYPED_ARRAY(*(args + 1));
+    object_typed_array_t * y = AS_TYPED_ARRAY(*(args + 2));
+    if (x->type == OBJECT_TYPED_ARRAY_FLOAT64 && y->type == OBJECT_TYPED_ARRAY_FLOAT64) {
+        typed_array_kernels_axpy(alpha, x->elements, y->elements, y->count);
+    } else {
+        for (uint32_t i = 0; i < y->count; i++) {
+            object_typed_array_set(y, i, object_typed_array_get(y, i) + alpha * object_typed_array_get(x, i));
+        }
+    }
+    return NULL_VAL;
+}
+
+value_t native_functions_typed_array_copy(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_COPY, argCount);
+    native_functions_assert_typed_arrays(NATIVE_FUNCTION_TYPED_ARRAY_COPY, *args, *(args + 1));
+    object_typed_array_t * destination = AS_TYPED_ARRAY(*args);
+    object_typed_array_t * source = AS_TYPED_ARRAY(*(args + 1));
+    if (destination->type == source->type) {
+        memmove(destination->elements, source->elements,
+                destination->count * object_typed_array_element_size(destination->type));
+    } else {
+        // The elements are converted to the type of the destination
+        for (uint32_t i = 0; i < destination->count; i++) {
+            object_typed_array_set(destination, i, object_typed_array_get(source, i));
+        }
+    }
+    return NULL_VAL;
+}
+
+value_t native_functions_typed_array_divide(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_DIVIDE, argCount);
+    native_functions_apply(NATIVE_FUNCTION_TYPED_ARRAY_DIVIDE, TYPED_ARRAY_KERNELS_DIVIDE, args);
+    return NULL_VAL;
+}
+
+value_t native_functions_typed_array_dot(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_DOT, argCount);
+    native_functions_assert_typed_arrays(NATIVE_FUNCTION_TYPED_ARRAY_DOT, *args, *(args + 1));
+    object_typed_array_t * a = AS_TYPED_ARRAY(*args);
+    object_typed_array_t * b = AS_TYPED_ARRAY(*(args + 1));
+    if (a->type == OBJECT_TYPED_ARRAY_FLOAT64 && b->type == OBJECT_TYPED_ARRAY_FLOAT64) {
+        return NUMBER_VAL(typed_array_kernels_dot(a->elements, b->elements, a->count));
+    }
+    double result = 0.0;
+    for (uint32_t i = 0; i < a->count; i++) {
+        result += object_typed_array_get(a, i) * object_typed_array_get(b, i);
+    }
+    return NUMBER_VAL(result);
+}
+
+value_t native_functions_typed_array_fill(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_FILL, argCount);
+    object_typed_array_t * array = native_functions_assert_typed_array(NATIVE_FUNCTION_TYPED_ARRAY_FILL, *args);
+    double value = native_functions_assert_number(NATIVE_FUNCTION_TYPED_ARRAY_FILL, *(args + 1));
+    if (array->type == OBJECT_TYPED_ARRAY_FLOAT64) {
+        typed_array_kernels_fill(array->elements, value, array->count);
+    } else {
+        for (uint32_t i = 0; i < array->count; i++) {
+            object_typed_array_set(array, i, value);
+        }
+    }
+    return NULL_VAL;
+}
+
+value_t native_functions_typed_array_max(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_MAX, argCount);
+    object_typed_array_t * array = native_functions_assert_typed_array(NATIVE_FUNCTION_TYPED_ARRAY_MAX, *args);
+    if (!array->count) {
+        return NULL_VAL;
+    }
+    if (array->type == OBJECT_TYPED_ARRAY_FLOAT64) {
+        return NUMBER_VAL(typed_array_kernels_max(array->elements, array->count));
+    }
+    double result = object_typed_array_get(array, 0u);
+    for (uint32_t i = 1; i < array->count; i++) {
+        double element = object_typed_array_get(array, i);
+        result = element > result ? element : result;
+    }
+    return NUMBER_VAL(result);
+}
+
+value_t native_functions_typed_array_min(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_MIN, argCount);
+    object_typed_array_t * array = native_functions_assert_typed_array(NATIVE_FUNCTION_TYPED_ARRAY_MIN, *args);
+    if (!array->count) {
+        return NULL_VAL;
+    }
+    if (array->type == OBJECT_TYPED_ARRAY_FLOAT64) {
+        return NUMBER_VAL(typed_array_kernels_min(array->elements, array->count));
+    }
+    double result = object_typed_array_get(array, 0u);
+    for (uint32_t i = 1; i < array->count; i++) {
+        double element = object_typed_array_get(array, i);
+        result = element < result ? element : result;
+    }
+    return NUMBER_VAL(result);
+}
+
+value_t native_functions_typed_array_multiply(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_MULTIPLY, argCount);
+    native_functions_apply(NATIVE_FUNCTION_TYPED_ARRAY_MULTIPLY, TYPED_ARRAY_KERNELS_MULTIPLY, args);
+    return NULL_VAL;
+}
+
+value_t native_functions_typed_array_scale(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_SCALE, argCount);
+    object_typed_array_t * array = native_functions_assert_typed_array(NATIVE_FUNCTION_TYPED_ARRAY_SCALE, *args);
+    double factor = native_functions_assert_number(NATIVE_FUNCTION_TYPED_ARRAY_SCALE, *(args + 1));
+    if (array->type == OBJECT_TYPED_ARRAY_FLOAT64) {
+        typed_array_kernels_scale(array->elements, factor, array->count);
+    } else {
+        for (uint32_t i = 0; i < array->count; i++) {
+            object_typed_array_set(array, i, object_typed_array_get(array, i) * factor);
+        }
+    }
+    return NULL_VAL;
+}
+
+value_t native_functions_typed_array_subtract(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_SUBTRACT, argCount);
+    native_functions_apply(NATIVE_FUNCTION_TYPED_ARRAY_SUBTRACT, TYPED_ARRAY_KERNELS_SUBTRACT, args);
+    return NULL_VAL;
+}
+
+value_t native_functions_typed_array_sum(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_TYPED_ARRAY_SUM, argCount);
+    object_typed_array_t * array = native_functions_assert_typed_array(NATIVE_FUNCTION_TYPED_ARRAY_SUM, *args);
+    if (array->type == OBJECT_TYPED_ARRAY_FLOAT64) {
+        return NUMBER_VAL(typed_array_kernels_sum(array->elements, array->count));
+    }
+    double result = 0.0;
+    for (uint32_t i = 0; i < array->count; i++) {
+        result += object_typed_array_get(array, i);
+    }
+    return NUMBER_VAL(result);
+}
+
+value_t native_functions_uint8_array(uint32_t argCount, value_t const * args) {
+    native_functions_assert_arrity(NATIVE_FUNCTION_UINT8_ARRAY, argCount);
+    return OBJECT_VAL(native_functions_new_typed_array(NATIVE_FUNCTION_UINT8_ARRAY, OBJECT_TYPED_ARRAY_UINT8, *args));
+}
+
 value_t native_functions_wait(uint32_t argCount, value_t const * args) {
     native_functions_assert_arrity(NATIVE_FUNCTION_WAIT, argCount);
     if (!IS_NUMBER(*args)) {
@@ -512,6 +1065,54 @@ value_t native_functions_write_to_file(uint32_t argCount, value_t const * args)
     return TRUE_VAL;
 }
 
+/// @brief Applies an element-wise operation to the typed arrays a native function was called with
+/// @param function The native function that was called
+/// @param operation The operation that is applied
+/// @param args The arguments the native function was called with (the results are stored in the first typed array)
+/// @note If the arguments are not two typed arrays with the same length the program exits with an runtime error code
+static void native_functions_apply(uint8_t function, typed_array_kernels_operation operation, value_t const * args) {
+    native_functions_assert_typed_arrays(function, *args, *(args + 1));
+    object_typed_array_t * destination = AS_TYPED_ARRAY(*args);
+    object_typed_array_t * source = AS_TYPED_ARRAY(*(args + 1));
+    if (destination->type == OBJECT_TYPED_ARRAY_FLOAT64 && source->type == OBJECT_TYPED_ARRAY_FLOAT64) {
+        typed_array_kernels_apply(operation, destination->elements, source->elements, destination->count);
+        return;
+    }
+    // Integer arrays are calculated with doubles and converted back to the type of the destination
+    for (uint32_t i = 0; i < destination->count; i++) {
+        double a = object_typed_array_get(destination, i);
+        double b = object_typed_array_get(source, i);
+        switch (operation) {
+        case TYPED_ARRAY_KERNELS_ADD:
+            a += b;
+            break;
+        case TYPED_ARRAY_KERNELS_SUBTRACT:
+            a -= b;
+            break;
+        case TYPED_ARRAY_KERNELS_MULTIPLY:
+            a *= b;
+            break;
+        case TYPED_ARRAY_KERNELS_DIVIDE:
+            a /= b;
+            break;
+        }
+        object_typed_array_set(destination, i, a);
+    }
+}
+
+/// @brief Asserts that the native function was called with an array as first argument
+/// @param function The native function that was called
+/// @param value The argument that is checked
+/// @return The argument as an array
+/// @note If the argument is not an array the program exits with an runtime error code
+static object_dynamic_value_array_t * native_functions_assert_array(uint8_t function, value_t value) {
+    if (!IS_ARRAY(value)) {
+        native_functions_arguments_error("%s can only be called with an array as first argument but was called with %s",
+                                         native_function_configs[function].functionName, value_stringify_type(value));
+    }
+    return AS_ARRAY(value);
+}
+
 /// @brief Asserts that the native function was called with the appropriate argument count
 /// @param function The native function that was called
 /// @param argcount The amount of arguments that were used to call the native function
@@ -525,6 +1126,318 @@ static void native_functions_assert_arrity(uint8_t function, uint32_t argcount)
     }
 }
 
+/// @brief Asserts that the native function was called with a valid index
+/// @param function The native function that was called
+/// @param value The argument that is used as an index
+/// @param upperBound The exclusive upper bound of the index
+/// @return The index
+/// @note If the argument is not a number or out of bounds the program exits with an runtime error code
+static uint32_t native_functions_assert_index(uint8_t function, value_t value, uint32_t upperBound) {
+    if (!IS_NUMBER(value)) {
+        native_functions_arguments_error("%s can only be called with a number as index but was called with %s",
+                                         native_function_configs[function].functionName, value_stringify_type(value));
+    }
+    int64_t index = (int64_t)AS_NUMBER(value);
+    if (index < 0 || index >= upperBound) {
+        native_functions_arguments_error("%s accessed array out of bounds at index %lld",
+                                         native_function_configs[function].functionName, (long long)index);
+    }
+    return (uint32_t)index;
+}
+
+/// @brief Asserts that the native function was called with a map as first argument
+/// @param function The native function that was called
+/// @param value The argument that is checked
+/// @return The argument as a map
+/// @note If the argument is not a map the program exits with an runtime error code
+static object_map_t * native_functions_assert_map(uint8_t function, value_t value) {
+    if (!IS_MAP(value)) {
+        native_functions_arguments_error("%s can only be called with a map as first argument but was called with %s",
+                                         native_function_configs[function].functionName, value_stringify_type(value));
+    }
+    return AS_MAP(value);
+}
+
+/// @brief Asserts that an argument of a native function is a number
+/// @param function The native function that was called
+/// @param value The argument that is checked
+/// @return The number
+/// @note If the argument is not a number the program exits with an runtime error code
+static double native_functions_assert_number(uint8_t function, value_t value) {
+    if (!IS_NUMBER(value)) {
+        native_functions_arguments_error("%s expects a number but was called with %s",
+                                         native_function_configs[function].functionName, value_stringify_type(value));
+    }
+    return AS_NUMBER(value);
+}
+
+/// @brief Asserts that an argument of a native function is a typed array
+/// @param function The native function that was called
+/// @param value The argument that is checked
+/// @return The argument as a typed array
+/// @note If the argument is not a typed array the program exits with an runtime error code
+static object_typed_array_t * native_functions_assert_typed_array(uint8_t function, value_t value) {
+    if (!IS_TYPED_ARRAY(value)) {
+        native_functions_arguments_error("%s expects a typed array but was called with %s",
+                                         native_function_configs[function].functionName, value_stringify_type(value));
+    }
+    return AS_TYPED_ARRAY(value);
+}
+
+/// @brief Asserts that two arguments of a native function are typed arrays with the same length
+/// @param function The native function that was called
+/// @param a The first argument that is checked
+/// @param b The second argument that is checked
+/// @note If the arguments are not typed arrays with the same length the program exits with an runtime error code
+static void native_functions_assert_typed_arrays(uint8_t function, value_t a, value_t b) {
+    uint32_t count = native_functions_assert_typed_array(function, a)->count;
+    if (native_functions_assert_typed_array(function, b)->count != count) {
+        native_functions_arguments_error("%s can only be called with typed arrays that have the same length",
+                                         native_function_configs[function].functionName);
+    }
+}
+
+/// @brief Calls a function that was passed to a native function
+/// @param callee The function that is called
+/// @param argCount The amount of arguments the function is called with
+/// @param args The arguments the function is called with
+/// @return The value returned by the function
+/// @note If the call leads to a runtime error the program exits with an runtime error code
+static value_t native_functions_call(value_t callee, uint32_t argCount, value_t const * args) {
+    value_t result;
+    if (!virtual_machine_call_function(callee, argCount, args, &result)) {
+        // The runtime error has already been reported by the virtual machine
+        virtual_machine_free();
+        exit(EXIT_CODE_RUNTIME_ERROR);
+    }
+    return result;
+}
+
+/// @brief Compares two values of an array that is sorted
+/// @param array The array that is sorted
+/// @param comparator The comparator function or null if the values are compared by their natural order
+/// @param a The index of the first value
+/// @param b The index of the second value
+/// @return A negative number if the first value is ordered before the second one, a positive number if it is ordered
+/// after it or zero if both values are equal
+static int32_t native_functions_compare_elements(object_dynamic_value_array_t * array, value_t comparator, uint32_t a,
+                                                 uint32_t b) {
+    if (IS_NULL(comparator)) {
+        return native_functions_compare_values(array->array.values[a], array->array.values[b]);
+    }
+    uint32_t count = array->array.count;
+    value_t arguments[2] = {array->array.values[a], array->array.values[b]};
+    value_t result = native_functions_call(comparator, 2u, arguments);
+    if (array->array.count != count) {
+        native_functions_arguments_error("The array was changed by the comparator of array_sort");
+    }
+    if (!IS_NUMBER(result)) {
+        native_functions_arguments_error("The comparator of array_sort has to return a number but returned a %s",
+                                         value_stringify_type(result));
+    }
+    return (AS_NUMBER(result) > 0) - (AS_NUMBER(result) < 0);
+}
+
+/// @brief Compares two values by their natural order
+/// @param a The first value
+/// @param b The second value
+/// @return A negative number if the first value is smaller, a positive number if it is bigger or zero if both are equal
+/// @note Only numbers and strings can be compared, other values lead to a runtime error
+static int32_t native_functions_compare_values(value_t a, value_t b) {
+    if (IS_NUMBER(a) && IS_NUMBER(b)) {
+        return (AS_NUMBER(a) > AS_NUMBER(b)) - (AS_NUMBER(a) < AS_NUMBER(b));
+    }
+    if (IS_STRING(a) && IS_STRING(b)) {
+        object_string_t * first = AS_STRING(a);
+        object_string_t * second = AS_STRING(b);
+        uint32_t length = first->length < second->length ? first->length : second->length;
+        int comparison = memcmp(object_string_chars(first), object_string_chars(second), length);
+        if (comparison) {
+            return comparison;
+        }
+        return (first->length > second->length) - (first->length < second->length);
+    }
+    native_functions_arguments_error("Only numbers and strings can be compared but the values are a %s and a %s",
+                                     value_stringify_type(a), value_stringify_type(b));
+    return 0;
+}
+
+/// @brief Sorts a partition of an array using heapsort
+/// @param array The array that is sorted
+/// @param comparator The comparator function or null
+/// @param low The index of the first value of the partition
+/// @param high The index of the last value of the partition
+static void native_functions_heap_sort(object_dynamic_value_array_t * array, value_t comparator, uint32_t low,
+                                       uint32_t high) {
+    uint32_t count = high - low + 1u;
+    for (uint32_t i = count / 2u; i > 0u; i--) {
+        native_functions_sift_down(array, comparator, low, i - 1u, count);
+    }
+    for (uint32_t end = count - 1u; end > 0u; end--) {
+        native_functions_swap_elements(array, low, low + end);
+        native_functions_sift_down(array, comparator, low, 0u, end);
+    }
+}
+
+/// @brief Sorts a small partition of an array using insertion sort
+/// @param array The array that is sorted
+/// @param comparator The comparator function or null
+/// @param low The index of the first value of the partition
+/// @param high The index of the last value of the partition
+/// @details The values are swapped instead of shifted, so every value stays reachable while the comparator is executed
+static void native_functions_insertion_sort(object_dynamic_value_array_t * array, value_t comparator, uint32_t low,
+                                            uint32_t high) {
+    for (uint32_t i = low + 1u; i <= high; i++) {
+        for (uint32_t j = i; j > low && native_functions_compare_elements(array, comparator, j - 1u, j) > 0; j--) {
+            native_functions_swap_elements(array, j - 1u, j);
+        }
+    }
+}
+
+/// @brief Sorts a partition of an array using introsort
+/// @param array The array that is sorted
+/// @param comparator The comparator function or null
+/// @param low The index of the first value of the partition
+/// @param high The index of the last value of the partition
+/// @param depthLimit The remaining depth of recursion until the partition is sorted using heapsort
+/// @details Quicksort with a median of three pivot is used until the depth limit is reached, so the worst case is
+/// O(n log n). Small partitions are sorted with insertion sort.
+static void native_functions_introsort(object_dynamic_value_array_t * array, value_t comparator, uint32_t low,
+                                       uint32_t high, uint32_t depthLimit) {
+    while (high - low + 1u > INSERTION_SORT_THRESHOLD) {
+        if (!depthLimit) {
+            native_functions_heap_sort(array, comparator, low, high);
+            return;
+        }
+        depthLimit--;
+        // The median of the first, the middle and the last value is moved to the middle and used as pivot
+        uint32_t middle = low + (high - low) / 2u;
+        if (native_functions_compare_elements(array, comparator, middle, low) < 0) {
+            native_functions_swap_elements(array, middle, low);
+        }
+        if (native_functions_compare_elements(array, comparator, high, low) < 0) {
+            native_functions_swap_elements(array, high, low);
+        }
+        if (native_functions_compare_elements(array, comparator, high, middle) < 0) {
+            native_functions_swap_elements(array, high, middle);
+        }
+        // The pivot is moved next to the end, so it is not moved while the partition is partitioned (Hoare)
+        native_functions_swap_elements(array, middle, high - 1u);
+        uint32_t pivot = high - 1u;
+        uint32_t i = low;
+        uint32_t j = high - 1u;
+        for (;;) {
+            while (++i < pivot && native_functions_compare_elements(array, comparator, i, pivot) < 0)
+                ;
+            while (--j > low && native_functions_compare_elements(array, comparator, j, pivot) > 0)
+                ;
+            if (i >= j) {
+                break;
+            }
+            native_functions_swap_elements(array, i, j);
+        }
+        // The pivot is placed at its final position
+        native_functions_swap_elements(array, i, pivot);
+        // The smaller partition is sorted recursively, so the recursion depth is at most log2(n)
+        if (i - low < high - i) {
+            native_functions_introsort(array, comparator, low, i - 1u, depthLimit);
+            low = i + 1u;
+        } else {
+            native_functions_introsort(array, comparator, i + 1u, high, depthLimit);
+            high = i - 1u;
+        }
+    }
+    if (low < high) {
+        native_functions_insertion_sort(array, comparator, low, high);
+    }
+}
+
+/// @brief Creates an array that contains the keys or the values of a map
+/// @param map The map whose entries are copied
+/// @param keys Indicates whether the keys or the values are copied
+/// @return The created array
+static object_dynamic_value_array_t * native_functions_map_entries(object_map_t * map, bool keys) {
+    object_dynamic_value_array_t * result = object_new_dynamic_value_array();
+    // The result is kept on the stack, because reserving the values might trigger a garbage collection
+    virtual_machine_push(OBJECT_VAL(result));
+    dynamic_value_array_reserve(&result->array, map->map.count);
+    for (uint32_t i = 0; i < map->map.capacity; i++) {
+        value_map_entry_t * entry = map->map.entries + i;
+        if (entry->hash) {
+            object_array_write(result, keys ? entry->key : entry->value);
+        }
+    }
+    virtual_machine_pop();
+    return result;
+}
+
+/// @brief Creates a typed array for a native function
+/// @param function The native function that was called
+/// @param type The type of the elements of the typed array
+/// @param argument The length of the typed array or an array whose values are converted
+/// @return The created typed array
+/// @note If the argument is neither a valid length nor an array of numbers the program exits with an runtime error code
+static object_typed_array_t * native_functions_new_typed_array(uint8_t function, object_typed_array_type type,
+                                                               value_t argument) {
+    if (IS_NUMBER(argument)) {
+        if (AS_NUMBER(argument) < 0 || AS_NUMBER(argument) > UINT32_MAX) {
+            native_functions_arguments_error("%s can only be called with a positive number as length",
+                                             native_function_configs[function].functionName);
+        }
+        return object_new_typed_array(type, (uint32_t)AS_NUMBER(argument));
+    }
+    if (IS_TYPED_ARRAY(argument)) {
+        object_typed_array_t * source = AS_TYPED_ARRAY(argument);
+        object_typed_array_t * array = object_new_typed_array(type, source->count);
+        for (uint32_t i = 0; i < source->count; i++) {
+            object_typed_array_set(array, i, object_typed_array_get(source, i));
+        }
+        return array;
+    }
+    if (!IS_ARRAY(argument)) {
+        native_functions_arguments_error("%s can only be called with a length or an array but was called with %s",
+                                         native_function_configs[function].functionName,
+                                         value_stringify_type(argument));
+    }
+    object_dynamic_value_array_t * source = AS_ARRAY(argument);
+    object_typed_array_t * array = object_new_typed_array(type, source->array.count);
+    for (uint32_t i = 0; i < source->array.count; i++) {
+        object_typed_array_set(array, i, native_functions_assert_number(function, source->array.values[i]));
+    }
+    return array;
+}
+
+/// @brief Moves a value of a heap down until the heap property is restored
+/// @param array The array that contains the heap
+/// @param comparator The comparator function or null
+/// @param offset The index of the first value of the heap
+/// @param root The index of the value that is moved down (relative to the offset)
+/// @param count The amount of values in the heap
+static void native_functions_sift_down(object_dynamic_value_array_t * array, value_t comparator, uint32_t offset,
+                                       uint32_t root, uint32_t count) {
+    for (uint32_t child = 2u * root + 1u; child < count; child = 2u * root + 1u) {
+        if (child + 1u < count &&
+            native_functions_compare_elements(array, comparator, offset + child, offset + child + 1u) < 0) {
+            child++;
+        }
+        if (native_functions_compare_elements(array, comparator, offset + root, offset + child) >= 0) {
+            return;
+        }
+        native_functions_swap_elements(array, offset + root, offset + child);
+        root = child;
+    }
+}
+
+/// @brief Swaps two values of an array
+/// @param array The array that contains the values
+/// @param a The index of the first value
+/// @param b The index of the second value
+static inline void native_functions_swap_elements(object_dynamic_value_array_t * array, uint32_t a, uint32_t b) {
+    value_t temporary = array->array.values[a];
+    array->array.values[a] = array->array.values[b];
+    array->array.values[b] = temporary;
+}
+
 /// @brief Emits a error message regarding a faulty native function call and exits with the appropriate exit code (70 -
 /// runtime error)
 /// @param format The format of the error message
@@ -561,15 +1474,14 @@ static size_t native_functions_value_size(value_t value) {
         {
             object_class_t * celloxClass = AS_CLASS(value);
             size_t classSize = 0;
-            for (size_t i = 0; i < celloxClass->methods.capacity; i++) {
-                if (celloxClass->methods.entries[i].key != NULL) {
-                    classSize += native_functions_value_size(celloxClass->methods.entries[i].value);
-                }
+            for (size_t i = 0; i < celloxClass->methods.count; i++) {
+                classSize += native_functions_value_size(celloxClass->methods.values[i]);
             }
             return classSize + sizeof(object_class_t);
         }
     case OBJECT_CLOSURE:
-        return AS_CLOSURE(value)->function->chunk.byteCodeCount + sizeof(object_closure_t);
+        return AS_CLOSURE(value)->function->chunk.byteCodeCount +
+               OBJECT_CLOSURE_SIZE(AS_CLOSURE(value)->upvalueCount);
     case OBJECT_FUNCTION:
         return AS_FUNCTION(value)->chunk.byteCodeCount + sizeof(object_function_t);
     case OBJECT_INSTANCE:
@@ -583,10 +1495,15 @@ static size_t native_functions_value_size(value_t value) {
                 }
             }
         }
+    case OBJECT_MAP:
+        return sizeof(object_map_t) + AS_MAP(value)->map.capacity * sizeof(value_map_entry_t);
     case OBJECT_NATIVE:
         return sizeof(native_function_t);
     case OBJECT_STRING:
-        return sizeof(object_string_t) + AS_STRING(value)->length;
+        return object_string_size(AS_STRING(value));
+    case OBJECT_TYPED_ARRAY:
+        return sizeof(object_typed_array_t) +
+               AS_TYPED_ARRAY(value)->count * object_typed_array_element_size(AS_TYPED_ARRAY(value)->type);
 
     default:
         return 0;
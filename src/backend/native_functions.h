@@ -45,12 +45,67 @@ native_function_config_t * native_functions_get_function_configs();
 /// @return The amount of native functions that are defiened
 size_t native_functions_get_function_count(void);
 
+/// @brief Searches a value in an array that is sorted in ascending order
+/// @param argCount The amount of arguments that were used when array_binary_search was called
+/// @param args The arguments that array_binary_search was called with
+/// @return The index of the value or -1 if the array does not contain the value
+value_t native_functions_array_binary_search(uint32_t argCount, value_t const * args);
+
+/// @brief Creates a new array that contains the values of an array for which a predicate returns a truthy value
+/// @param argCount The amount of arguments that were used when array_filter was called
+/// @param args The arguments that array_filter was called with
+/// @return The array containing the values that fulfill the predicate
+value_t native_functions_array_filter(uint32_t argCount, value_t const * args);
+
+/// @brief Searches the first occurence of a value in an array
+/// @param argCount The amount of arguments that were used when array_index_of was called
+/// @param args The arguments that array_index_of was called with
+/// @return The index of the value or -1 if the array does not contain the value
+value_t native_functions_array_index_of(uint32_t argCount, value_t const * args);
+
+/// @brief Inserts a value into an array at the given index
+/// @param argCount The amount of arguments that were used when array_insert was called
+/// @param args The arguments that array_insert was called with
+/// @return null
+value_t native_functions_array_insert(uint32_t argCount, value_t const * args);
+
 /// @brief Determines the length of an array
 /// @param argCount The amount of arguments that were used when array_length was called
 /// @param args The arguments that array_length was called with
 /// @return The length of the array
 value_t native_functions_array_length(uint32_t argCount, value_t const * args);
 
+/// @brief Creates a new array that contains the results of calling a function with every value of an array
+/// @param argCount The amount of arguments that were used when array_map was called
+/// @param args The arguments that array_map was called with
+/// @return The array containing the results of the function calls
+value_t native_functions_array_map(uint32_t argCount, value_t const * args);
+
+/// @brief Combines the values of an array to a single value by calling a function with the accumulated value and each
+/// value of the array
+/// @param argCount The amount of arguments that were used when array_reduce was called
+/// @param args The arguments that array_reduce was called with
+/// @return The accumulated value
+value_t native_functions_array_reduce(uint32_t argCount, value_t const * args);
+
+/// @brief Removes the value at the given index from an array
+/// @param argCount The amount of arguments that were used when array_remove was called
+/// @param args The arguments that array_remove was called with
+/// @return The value that was removed
+value_t native_functions_array_remove(uint32_t argCount, value_t const * args);
+
+/// @brief Increases the capacity of an array, so values can be appended without reallocating the array
+/// @param argCount The amount of arguments that were used when array_reserve was called
+/// @param args The arguments that array_reserve was called with
+/// @return null
+value_t native_functions_array_reserve(uint32_t argCount, value_t const * args);
+
+/// @brief Sorts an array in place in ascending order or according to an optional comparator function
+/// @param argCount The amount of arguments that were used when array_sort was called
+/// @param args The arguments that array_sort was called with
+/// @return The sorted array
+value_t native_functions_array_sort(uint32_t argCount, value_t const * args);
+
 /// @brief Appends the content of a cellox string to a file
 /// @param argCount The amount of arguments that were used when append_to was called
 /// @param args The arguments that append_to_file was called with
@@ -93,6 +148,24 @@ value_t native_functions_exit(uint32_t argCount, value_t const * args);
 /// @return e (2.71828) raised to the power of the given argument
 value_t native_functions_exponential(uint32_t argCount, value_t const * args);
 
+/// @brief Creates a typed array that stores 64-bit floating point numbers
+/// @param argCount The amount of arguments that were used when float64_array was called
+/// @param args The arguments that float64_array was called with
+/// @return The created typed array
+value_t native_functions_float64_array(uint32_t argCount, value_t const * args);
+
+/// @brief Collects the statistics of the garbage collector
+/// @param argCount The amount of arguments that were used when gc_stats was called
+/// @param args The arguments that gc_stats was called with
+/// @return An instance that contains the statistics of the garbage collector
+value_t native_functions_gc_stats(uint32_t argCount, value_t const * args);
+
+/// @brief Creates a typed array that stores 32-bit signed integers
+/// @param argCount The amount of arguments that were used when int32_array was called
+/// @param args The arguments that int32_array was called with
+/// @return The created typed array
+value_t native_functions_int32_array(uint32_t argCount, value_t const * args);
+
 /// @brief Computes the natural logarithm of the given argument
 /// @param argCount The amount of arguments that were used when logarithm was called
 /// @param args The arguments that logarithm was called with
@@ -105,6 +178,54 @@ value_t native_functions_logarithm(uint32_t argCount, value_t const * args);
 /// @return The base 10 logarithm of the argument
 value_t native_functions_logarithm10(uint32_t argCount, value_t const * args);
 
+/// @brief Creates a new map, that can optionally be presized for a given amount of entries
+/// @param argCount The amount of arguments that were used when map was called
+/// @param args The arguments that map was called with
+/// @return The created map
+value_t native_functions_map(uint32_t argCount, value_t const * args);
+
+/// @brief Determines the amount of entries in a map
+/// @param argCount The amount of arguments that were used when map_count was called
+/// @param args The arguments that map_count was called with
+/// @return The amount of entries
+value_t native_functions_map_count(uint32_t argCount, value_t const * args);
+
+/// @brief Gets the value that is associated with a key or a default value if the map does not contain the key
+/// @param argCount The amount of arguments that were used when map_get was called
+/// @param args The arguments that map_get was called with
+/// @return The value that is associated with the key or the default value
+value_t native_functions_map_get(uint32_t argCount, value_t const * args);
+
+/// @brief Determines whether a map contains a key
+/// @param argCount The amount of arguments that were used when map_has was called
+/// @param args The arguments that map_has was called with
+/// @return true if the map contains the key, false if not
+value_t native_functions_map_has(uint32_t argCount, value_t const * args);
+
+/// @brief Creates an array that contains the keys of a map
+/// @param argCount The amount of arguments that were used when map_keys was called
+/// @param args The arguments that map_keys was called with
+/// @return The array containing the keys
+value_t native_functions_map_keys(uint32_t argCount, value_t const * args);
+
+/// @brief Removes the entry with the given key from a map
+/// @param argCount The amount of arguments that were used when map_remove was called
+/// @param args The arguments that map_remove was called with
+/// @return true if an entry was removed, false if not
+value_t native_functions_map_remove(uint32_t argCount, value_t const * args);
+
+/// @brief Grows a map, so it can store the given amount of entries without growing again
+/// @param argCount The amount of arguments that were used when map_reserve was called
+/// @param args The arguments that map_reserve was called with
+/// @return null
+value_t native_functions_map_reserve(uint32_t argCount, value_t const * args);
+
+/// @brief Creates an array that contains the values of a map
+/// @param argCount The amount of arguments that were used when map_values was called
+/// @param args The arguments that map_values was called with
+/// @return The array containing the values
+value_t native_functions_map_values(uint32_t argCount, value_t const * args);
+
 /// @brief Converts a numerical value to a asci character
 /// @param argCount The amount of arguments that were used when num_to_asci was called
 /// @param args The arguments that num_to_asci was called with
@@ -172,6 +293,7 @@ value_t native_functions_sine(uint32_t argCount, value_t const * args);
 value_t native_functions_size_of(uint32_t argCount, value_t const * args);
 
 /// @brief Gets the hash of a string
+/// @details The hash is calculated with string_utils_hash_string and is the same on every platform
 /// @param argCount The amount of arguments that were used when string_hash was called
 /// @param args The arguments that string_hash was called with
 /// @return The haash of the string
@@ -201,6 +323,84 @@ value_t native_functions_system(uint32_t argCount, value_t const * args);
 /// @return The tangent of the argument passed
 value_t native_functions_tangent(uint32_t argCount, value_t const * args);
 
+/// @brief Adds the elements of a typed array to the elements of another typed array
+/// @param argCount The amount of arguments that were used when typed_array_add was called
+/// @param args The arguments that typed_array_add was called with
+/// @return null
+value_t native_functions_typed_array_add(uint32_t argCount, value_t const * args);
+
+/// @brief Adds the elements of a typed array multiplied with a factor to the elements of another typed array
+/// @param argCount The amount of arguments that were used when typed_array_axpy was called
+/// @param args The arguments that typed_array_axpy was called with
+/// @return null
+value_t native_functions_typed_array_axpy(uint32_t argCount, value_t const * args);
+
+/// @brief Copies the elements of a typed array into another typed array
+/// @param argCount The amount of arguments that were used when typed_array_copy was called
+/// @param args The arguments that typed_array_copy was called with
+/// @return null
+value_t native_functions_typed_array_copy(uint32_t argCount, value_t const * args);
+
+/// @brief Divides the elements of a typed array by the elements of another typed array
+/// @param argCount The amount of arguments that were used when typed_array_divide was called
+/// @param args The arguments that typed_array_divide was called with
+/// @return null
+value_t native_functions_typed_array_divide(uint32_t argCount, value_t const * args);
+
+/// @brief Calculates the dot product of two typed arrays
+/// @param argCount The amount of arguments that were used when typed_array_dot was called
+/// @param args The arguments that typed_array_dot was called with
+/// @return The dot product
+value_t native_functions_typed_array_dot(uint32_t argCount, value_t const * args);
+
+/// @brief Sets all the elements of a typed array to a number
+/// @param argCount The amount of arguments that were used when typed_array_fill was called
+/// @param args The arguments that typed_array_fill was called with
+/// @return null
+value_t native_functions_typed_array_fill(uint32_t argCount, value_t const * args);
+
+/// @brief Determines the biggest element of a typed array
+/// @param argCount The amount of arguments that were used when typed_array_max was called
+/// @param args The arguments that typed_array_max was called with
+/// @return The biggest element or null if the typed array is empty
+value_t native_functions_typed_array_max(uint32_t argCount, value_t const * args);
+
+/// @brief Determines the smallest element of a typed array
+/// @param argCount The amount of arguments that were used when typed_array_min was called
+/// @param args The arguments that typed_array_min was called with
+/// @return The smallest element or null if the typed array is empty
+value_t native_functions_typed_array_min(uint32_t argCount, value_t const * args);
+
+/// @brief Multiplies the elements of a typed array with the elements of another typed array
+/// @param argCount The amount of arguments that were used when typed_array_multiply was called
+/// @param args The arguments that typed_array_multiply was called with
+/// @return null
+value_t native_functions_typed_array_multiply(uint32_t argCount, value_t const * args);
+
+/// @brief Multiplies the elements of a typed array with a factor
+/// @param argCount The amount of arguments that were used when typed_array_scale was called
+/// @param args The arguments that typed_array_scale was called with
+/// @return null
+value_t native_functions_typed_array_scale(uint32_t argCount, value_t const * args);
+
+/// @brief Subtracts the elements of a typed array from the elements of another typed array
+/// @param argCount The amount of arguments that were used when typed_array_subtract was called
+/// @param args The arguments that typed_array_subtract was called with
+/// @return null
+value_t native_functions_typed_array_subtract(uint32_t argCount, value_t const * args);
+
+/// @brief Calculates the sum of the elements of a typed array
+/// @param argCount The amount of arguments that were used when typed_array_sum was called
+/// @param args The arguments that typed_array_sum was called with
+/// @return The sum of the elements
+value_t native_functions_typed_array_sum(uint32_t argCount, value_t const * args);
+
+/// @brief Creates a typed array that stores 8-bit unsigned integers
+/// @param argCount The amount of arguments that were used when uint8_array was called
+/// @param args The arguments that uint8_array was called with
+/// @return The created typed array
+value_t native_functions_uint8_array(uint32_t argCount, value_t const * args);
+
 /// @brief Native wait function - waits for the specified amount of seconds
 /// @param argCount The amount of arguments that were used when wait was called
 /// @param args The arguments that wait was called with
@@ -0,0 +1,571 @@
+/****************************************************************************
+ * Copyright (C) 2022 by Frederik Tobner                                    *
+ *                                                                          *
+ * This file is part of Cellox.                                             *
+ *                                                                          *
+ * Permission to use, copy, modify, and distribute this software and its    *
+ * documentation under the terms of the GNU General Public License is       *
+ * hereby granted.                                                          *
+ * No representations are made about the suitability of this software for   *
+ * any purpose.                                                             *
+ * It is provided "as is" without express or implied warranty.              *
+ * See the <https://www.gnu.org/licenses/gpl-3.0.html/>GNU General Public   *
+ * License for more details.                                                *
+ ****************************************************************************/
+
+/**
+ * @file typed_array_kernels.c
+ * @brief File containing the implementation of the vectorized kernels that are used by the typed arrays.
+ * @details Every kernel is implemented with plain C loops and, on x86-64, with SSE2 and AVX instructions. The
+ * implementation that is used is selected at runtime based on the features of the processor.
+ */
+
+#include "typed_array_kernels.h"
+
+#if (defined(COMPILER_GCC) || defined(COMPILER_CLANG)) && defined(__x86_64__)
+#define TYPED_ARRAY_KERNELS_X86_64
+#include <immintrin.h>
+#endif
+
+/// @brief The implementations of the kernels for a single instruction set
+typedef struct {
+    /// Applies an element-wise operation
+    void (*apply)(typed_array_kernels_operation, double *, double const *, size_t);
+    /// Adds a multiple of an array to another array
+    void (*axpy)(double, double const *, double *, size_t);
+    /// Calculates the dot product
+    double (*dot)(double const *, double const *, size_t);
+    /// Fills an array
+    void (*fill)(double *, double, size_t);
+    /// Determines the biggest element
+    double (*max)(double const *, size_t);
+    /// Determines the smallest element
+    double (*min)(double const *, size_t);
+    /// Scales an array
+    void (*scale)(double *, double, size_t);
+    /// Calculates the sum
+    double (*sum)(double const *, size_t);
+} typed_array_kernels_table_t;
+
+static typed_array_kernels_table_t const * typed_array_kernels_get_table(void);
+static void typed_array_kernels_scalar_apply(typed_array_kernels_operation, double *, double const *, size_t);
+static void typed_array_kernels_scalar_axpy(double, double const *, double *, size_t);
+static double typed_array_kernels_scalar_dot(double const *, double const *, size_t);
+static void typed_array_kernels_scalar_fill(double *, double, size_t);
+static double typed_array_kernels_scalar_max(double const *, size_t);
+static double typed_array_kernels_scalar_min(double const *, size_t);
+static void typed_array_kernels_scalar_scale(double *, double, size_t);
+static double typed_array_kernels_scalar_sum(double const *, size_t);
+
+/// Kernels that are implemented with plain C loops
+static typed_array_kernels_table_t const scalarKernels = {
+    .apply = typed_array_kernels_scalar_apply,
+    .axpy = typed_array_kernels_scalar_axpy,
+    .dot = typed_array_kernels_scalar_dot,
+    .fill = typed_array_kernels_scalar_fill,
+    .max = typed_array_kernels_scalar_max,
+    .min = typed_array_kernels_scalar_min,
+    .scale = typed_array_kernels_scalar_scale,
+    .sum = typed_array_kernels_scalar_sum,
+};
+
+#ifdef TYPED_ARRAY_KERNELS_X86_64
+
+/// Attribute that enables the AVX instructions for a single function
+#define TYPED_ARRAY_KERNELS_AVX_TARGET __attribute__((target("avx")))
+
+/// Applies a vectorized binary operation to the elements of the destination and the source, as long as a full vector
+/// of the given width is left
+#define TYPED_ARRAY_KERNELS_APPLY_LOOP(width, load, store, operation)                           \
+    for (; i + (width) <= count; i += (width)) {                                                \
+        store(destination + i, operation(load(destination + i), load(source + i)));             \
+    }
+
+static void typed_array_kernels_sse2_apply(typed_array_kernels_operation, double *, double const *, size_t);
+static void typed_array_kernels_sse2_axpy(double, double const *, double *, size_t);
+static double typed_array_kernels_sse2_dot(double const *, double const *, size_t);
+static void typed_array_kernels_sse2_fill(double *, double, size_t);
+static inline double typed_array_kernels_sse2_horizontal_sum(__m128d);
+static double typed_array_kernels_sse2_max(double const *, size_t);
+static double typed_array_kernels_sse2_min(double const *, size_t);
+static void typed_array_kernels_sse2_scale(double *, double, size_t);
+static double typed_array_kernels_sse2_sum(double const *, size_t);
+
+static void typed_array_kernels_avx_apply(typed_array_kernels_operation, double *, double const *, size_t);
+static void typed_array_kernels_avx_axpy(double, double const *, double *, size_t);
+static double typed_array_kernels_avx_dot(double const *, double const *, size_t);
+static void typed_array_kernels_avx_fill(double *, double, size_t);
+static inline double typed_array_kernels_avx_horizontal_sum(__m256d);
+static double typed_array_kernels_avx_max(double const *, size_t);
+static double typed_array_kernels_avx_min(double const *, size_t);
+static void typed_array_kernels_avx_scale(double *, double, size_t);
+static double typed_array_kernels_avx_sum(double const *, size_t);
+
+/// Kernels that use 128-bit vectors
+static typed_array_kernels_table_t const sse2Kernels = {
+    .apply = typed_array_kernels_sse2_apply,
+    .axpy = typed_array_kernels_sse2_axpy,
+    .dot = typed_array_kernels_sse2_dot,
+    .fill = typed_array_kernels_sse2_fill,
+    .max = typed_array_kernels_sse2_max,
+    .min = typed_array_kernels_sse2_min,
+    .scale = typed_array_kernels_sse2_scale,
+    .sum = typed_array_kernels_sse2_sum,
+};
+
+/// Kernels that use 256-bit vectors
+static typed_array_kernels_table_t const avxKernels = {
+    .apply = typed_array_kernels_avx_apply,
+    .axpy = typed_array_kernels_avx_axpy,
+    .dot = typed_array_kernels_avx_dot,
+    .fill = typed_array_kernels_avx_fill,
+    .max = typed_array_kernels_avx_max,
+    .min = typed_array_kernels_avx_min,
+    .scale = typed_array_kernels_avx_scale,
+    .sum = typed_array_kernels_avx_sum,
+};
+
+#endif
+
+/// The kernels that are used on this processor (selected when a kernel is executed for the first time)
+static typed_array_kernels_table_t const * kernels = NULL;
+
+/// The instruction set of the selected kernels
+static typed_array_kernels_instruction_set instructionSet = TYPED_ARRAY_KERNELS_SCALAR;
+
+void typed_array_kernels_apply(typed_array_kernels_operation operation, double * destination, double const * source,
+                               size_t count) {
+    typed_array_kernels_get_table()->apply(operation, destination, source, count);
+}
+
+void typed_array_kernels_axpy(double alpha, double const * x, double * y, size_t count) {
+    typed_array_kernels_get_table()->axpy(alpha, x, y, count);
+}
+
+double typed_array_kernels_dot(double const * a, double const * b, size_t count) {
+    return typed_array_kernels_get_table()->dot(a, b, count);
+}
+
+void typed_array_kernels_fill(double * values, double value, size_t count) {
+    typed_array_kernels_get_table()->fill(values, value, count);
+}
+
+typed_array_kernels_instruction_set typed_array_kernels_get_instruction_set(void) {
+    typed_array_kernels_get_table();
+    return instructionSet;
+}
+
+double typed_array_kernels_max(double const * values, size_t count) {
+    return typed_array_kernels_get_table()->max(values, count);
+}
+
+double typed_array_kernels_min(double const * values, size_t count) {
+    return typed_array_kernels_get_table()->min(values, count);
+}
+
+void typed_array_kernels_scale(double * values, double factor, size_t count) {
+    typed_array_kernels_get_table()->scale(values, factor, count);
+}
+
+bool typed_array_kernels_set_instruction_set(typed_array_kernels_instruction_set set) {
+    switch (set) {
+    case TYPED_ARRAY_KERNELS_SCALAR:
+        kernels = &scalarKernels;
+        break;
+#ifdef TYPED_ARRAY_KERNELS_X86_64
+    case TYPED_ARRAY_KERNELS_SSE2:
+        kernels = &sse2Kernels;
+        break;
+    case TYPED_ARRAY_KERNELS_AVX:
+        __builtin_cpu_init();
+        if (!__builtin_cpu_supports("avx")) {
+            return false;
+        }
+        kernels = &avxKernels;
+        break;
+#endif
+    default:
+        return false;
+    }
+    instructionSet = set;
+    return true;
+}
+
+double typed_array_kernels_sum(double const * values, size_t count) {
+    return typed_array_kernels_get_table()->sum(values, count);
+}
+
+/// @brief Gets the kernels that are used on this processor
+/// @return The kernels for the best instruction set that is supported by the processor
+static typed_array_kernels_table_t const * typed_array_kernels_get_table(void) {
+    if (kernels) {
+        return kernels;
+    }
+#ifdef TYPED_ARRAY_KERNELS_X86_64
+    // SSE2 is part of x86-64, AVX also has to be supported by the operating system (checked by the builtin)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) {
+        instructionSet = TYPED_ARRAY_KERNELS_AVX;
+        kernels = &avxKernels;
+    } else {
+        instructionSet = TYPED_ARRAY_KERNELS_SSE2;
+        kernels = &sse2Kernels;
+    }
+#else
+    instructionSet = TYPED_ARRAY_KERNELS_SCALAR;
+    kernels = &scalarKernels;
+#endif
+    return kernels;
+}
+
+/// @brief Applies an element-wise operation to two arrays using plain C loops
+/// @param operation The operation that is applied
+/// @param destination The array that contains the first operands and where the results are stored
+/// @param source The array that contains the second operands
+/// @param count The amount of elements of both arrays
+static void typed_array_kernels_scalar_apply(typed_array_kernels_operation operation, double * destination,
+                                             double const * source, size_t count) {
+    switch (operation) {
+    case TYPED_ARRAY_KERNELS_ADD:
+        for (size_t i = 0; i < count; i++) {
+            destination[i] += source[i];
+        }
+        break;
+    case TYPED_ARRAY_KERNELS_SUBTRACT:
+        for (size_t i = 0; i < count; i++) {
+            destination[i] -= source[i];
+        }
+        break;
+    case TYPED_ARRAY_KERNELS_MULTIPLY:
+        for (size_t i = 0; i < count; i++) {
+            destination[i] *= source[i];
+        }
+        break;
+    case TYPED_ARRAY_KERNELS_DIVIDE:
+        for (size_t i = 0; i < count; i++) {
+            destination[i] /= source[i];
+        }
+        break;
+    }
+}
+
+/// @brief Adds a multiple of an array to another array using a plain C loop
+/// @param alpha The factor the elements of x are multiplied with
+/// @param x The array that is scaled
+/// @param y The array the scaled elements are added to
+/// @param count The amount of elements of both arrays
+static void typed_array_kernels_scalar_axpy(double alpha, double const * x, double * y, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+/// @brief Calculates the dot product of two arrays using a plain C loop
+/// @param a The first array
+/// @param b The second array
+/// @param count The amount of elements of both arrays
+/// @return The dot product
+static double typed_array_kernels_scalar_dot(double const * a, double const * b, size_t count) {
+    double result = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+/// @brief Fills an array using a plain C loop
+/// @param values The array that is filled
+/// @param value The value that is stored
+/// @param count The amount of elements of the array
+static void typed_array_kernels_scalar_fill(double * values, double value, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        values[i] = value;
+    }
+}
+
+/// @brief Determines the biggest element of an array using a plain C loop
+/// @param values The array (must not be empty)
+/// @param count The amount of elements of the array
+/// @return The biggest element
+static double typed_array_kernels_scalar_max(double const * values, size_t count) {
+    double result = values[0];
+    for (size_t i = 1; i < count; i++) {
+        result = values[i] > result ? values[i] : result;
+    }
+    return result;
+}
+
+/// @brief Determines the smallest element of an array using a plain C loop
+/// @param values The array (must not be empty)
+/// @param count The amount of elements of the array
+/// @return The smallest element
+static double typed_array_kernels_scalar_min(double const * values, size_t count) {
+    double result = values[0];
+    for (size_t i = 1; i < count; i++) {
+        result = values[i] < result ? values[i] : result;
+    }
+    return result;
+}
+
+/// @brief Scales an array using a plain C loop
+/// @param values The array that is scaled
+/// @param factor The factor the elements are multiplied with
+/// @param count The amount of elements of the array
+static void typed_array_kernels_scalar_scale(double * values, double factor, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        values[i] *= factor;
+    }
+}
+
+/// @brief Calculates the sum of the elements of an array using a plain C loop
+/// @param values The array
+/// @param count The amount of elements of the array
+/// @return The sum of the elements
+static double typed_array_kernels_scalar_sum(double const * values, size_t count) {
+    double result = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        result += values[i];
+    }
+    return result;
+}
+
+#ifdef TYPED_ARRAY_KERNELS_X86_64
+
+// The vectorized kernels process full vectors and hand the remaining elements to the scalar kernels
+
+/// @brief Applies an element-wise operation to two arrays using SSE2
+static void typed_array_kernels_sse2_apply(typed_array_kernels_operation operation, double * destination,
+                                           double const * source, size_t count) {
+    size_t i = 0;
+    switch (operation) {
+    case TYPED_ARRAY_KERNELS_ADD:
+        TYPED_ARRAY_KERNELS_APPLY_LOOP(2u, _mm_loadu_pd, _mm_storeu_pd, _mm_add_pd)
+        break;
+    case TYPED_ARRAY_KERNELS_SUBTRACT:
+        TYPED_ARRAY_KERNELS_APPLY_LOOP(2u, _mm_loadu_pd, _mm_storeu_pd, _mm_sub_pd)
+        break;
+    case TYPED_ARRAY_KERNELS_MULTIPLY:
+        TYPED_ARRAY_KERNELS_APPLY_LOOP(2u, _mm_loadu_pd, _mm_storeu_pd, _mm_mul_pd)
+        break;
+    case TYPED_ARRAY_KERNELS_DIVIDE:
+        TYPED_ARRAY_KERNELS_APPLY_LOOP(2u, _mm_loadu_pd, _mm_storeu_pd, _mm_div_pd)
+        break;
+    }
+    typed_array_kernels_scalar_apply(operation, destination + i, source + i, count - i);
+}
+
+/// @brief Adds a multiple of an array to another array using SSE2
+static void typed_array_kernels_sse2_axpy(double alpha, double const * x, double * y, size_t count) {
+    __m128d factor = _mm_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 2u <= count; i += 2u) {
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(factor, _mm_loadu_pd(x + i))));
+    }
+    typed_array_kernels_scalar_axpy(alpha, x + i, y + i, count - i);
+}
+
+/// @brief Calculates the dot product of two arrays using SSE2
+static double typed_array_kernels_sse2_dot(double const * a, double const * b, size_t count) {
+    // Two accumulators are used, so consecutive additions do not depend on each other
+    __m128d first = _mm_setzero_pd();
+    __m128d second = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4u <= count; i += 4u) {
+        first = _mm_add_pd(first, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        second = _mm_add_pd(second, _mm_mul_pd(_mm_loadu_pd(a + i + 2u), _mm_loadu_pd(b + i + 2u)));
+    }
+    return typed_array_kernels_sse2_horizontal_sum(_mm_add_pd(first, second)) +
+           typed_array_kernels_scalar_dot(a + i, b + i, count - i);
+}
+
+/// @brief Fills an array using SSE2
+static void typed_array_kernels_sse2_fill(double * values, double value, size_t count) {
+    __m128d vector = _mm_set1_pd(value);
+    size_t i = 0;
+    for (; i + 2u <= count; i += 2u) {
+        _mm_storeu_pd(values + i, vector);
+    }
+    typed_array_kernels_scalar_fill(values + i, value, count - i);
+}
+
+/// @brief Adds the lanes of a 128-bit vector
+static inline double typed_array_kernels_sse2_horizontal_sum(__m128d vector) {
+    return _mm_cvtsd_f64(_mm_add_sd(vector, _mm_unpackhi_pd(vector, vector)));
+}
+
+/// @brief Determines the biggest element of an array using SSE2
+static double typed_array_kernels_sse2_max(double const * values, size_t count) {
+    __m128d result = _mm_set1_pd(values[0]);
+    size_t i = 0;
+    for (; i + 2u <= count; i += 2u) {
+        result = _mm_max_pd(result, _mm_loadu_pd(values + i));
+    }
+    result = _mm_max_sd(result, _mm_unpackhi_pd(result, result));
+    double maximum = _mm_cvtsd_f64(result);
+    for (; i < count; i++) {
+        maximum = values[i] > maximum ? values[i] : maximum;
+    }
+    return maximum;
+}
+
+/// @brief Determines the smallest element of an array using SSE2
+static double typed_array_kernels_sse2_min(double const * values, size_t count) {
+    __m128d result = _mm_set1_pd(values[0]);
+    size_t i = 0;
+    for (; i + 2u <= count; i += 2u) {
+        result = _mm_min_pd(result, _mm_loadu_pd(values + i));
+    }
+    result = _mm_min_sd(result, _mm_unpackhi_pd(result, result));
+    double minimum = _mm_cvtsd_f64(result);
+    for (; i < count; i++) {
+        minimum = values[i] < minimum ? values[i] : minimum;
+    }
+    return minimum;
+}
+
+/// @brief Scales an array using SSE2
+static void typed_array_kernels_sse2_scale(double * values, double factor, size_t count) {
+    __m128d vector = _mm_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 2u <= count; i += 2u) {
+        _mm_storeu_pd(values + i, _mm_mul_pd(_mm_loadu_pd(values + i), vector));
+    }
+    typed_array_kernels_scalar_scale(values + i, factor, count - i);
+}
+
+/// @brief Calculates the sum of the elements of an array using SSE2
+static double typed_array_kernels_sse2_sum(double const * values, size_t count) {
+    __m128d first = _mm_setzero_pd();
+    __m128d second = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4u <= count; i += 4u) {
+        first = _mm_add_pd(first, _mm_loadu_pd(values + i));
+        second = _mm_add_pd(second, _mm_loadu_pd(values + i + 2u));
+    }
+    return typed_array_kernels_sse2_horizontal_sum(_mm_add_pd(first, second)) +
+           typed_array_kernels_scalar_sum(values + i, count - i);
+}
+
+/// @brief Applies an element-wise operation to two arrays using AVX
+TYPED_ARRAY_KERNELS_AVX_TARGET
+static void typed_array_kernels_avx_apply(typed_array_kernels_operation operation, double * destination,
+                                          double const * source, size_t count) {
+    size_t i = 0;
+    switch (operation) {
+    case TYPED_ARRAY_KERNELS_ADD:
+        TYPED_ARRAY_KERNELS_APPLY_LOOP(4u, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_add_pd)
+        break;
+    case TYPED_ARRAY_KERNELS_SUBTRACT:
+        TYPED_ARRAY_KERNELS_APPLY_LOOP(4u, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_sub_pd)
+        break;
+    case TYPED_ARRAY_KERNELS_MULTIPLY:
+        TYPED_ARRAY_KERNELS_APPLY_LOOP(4u, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_mul_pd)
+        break;
+    case TYPED_ARRAY_KERNELS_DIVIDE:
+        TYPED_ARRAY_KERNELS_APPLY_LOOP(4u, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_div_pd)
+        break;
+    }
+    typed_array_kernels_scalar_apply(operation, destination + i, source + i, count - i);
+}
+
+/// @brief Adds a multiple of an array to another array using AVX
+TYPED_ARRAY_KERNELS_AVX_TARGET
+static void typed_array_kernels_avx_axpy(double alpha, double const * x, double * y, size_t count) {
+    __m256d factor = _mm256_set1_pd(alpha);
+    size_t i = 0;
+    for (; i + 4u <= count; i += 4u) {
+        _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_mul_pd(factor, _mm256_loadu_pd(x + i))));
+    }
+    typed_array_kernels_scalar_axpy(alpha, x + i, y + i, count - i);
+}
+
+/// @brief Calculates the dot product of two arrays using AVX
+TYPED_ARRAY_KERNELS_AVX_TARGET
+static double typed_array_kernels_avx_dot(double const * a, double const * b, size_t count) {
+    __m256d first = _mm256_setzero_pd();
+    __m256d second = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8u <= count; i += 8u) {
+        first = _mm256_add_pd(first, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        second = _mm256_add_pd(second, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4u), _mm256_loadu_pd(b + i + 4u)));
+    }
+    return typed_array_kernels_avx_horizontal_sum(_mm256_add_pd(first, second)) +
+           typed_array_kernels_scalar_dot(a + i, b + i, count - i);
+}
+
+/// @brief Fills an array using AVX
+TYPED_ARRAY_KERNELS_AVX_TARGET
+static void typed_array_kernels_avx_fill(double * values, double value, size_t count) {
+    __m256d vector = _mm256_set1_pd(value);
+    size_t i = 0;
+    for (; i + 4u <= count; i += 4u) {
+        _mm256_storeu_pd(values + i, vector);
+    }
+    typed_array_kernels_scalar_fill(values + i, value, count - i);
+}
+
+/// @brief Adds the lanes of a 256-bit vector
+TYPED_ARRAY_KERNELS_AVX_TARGET
+static inline double typed_array_kernels_avx_horizontal_sum(__m256d vector) {
+    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(vector), _mm256_extractf128_pd(vector, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+/// @brief Determines the biggest element of an array using AVX
+TYPED_ARRAY_KERNELS_AVX_TARGET
+static double typed_array_kernels_avx_max(double const * values, size_t count) {
+    __m256d result = _mm256_set1_pd(values[0]);
+    size_t i = 0;
+    for (; i + 4u <= count; i += 4u) {
+        result = _mm256_max_pd(result, _mm256_loadu_pd(values + i));
+    }
+    __m128d half = _mm_max_pd(_mm256_castpd256_pd128(result), _mm256_extractf128_pd(result, 1));
+    double maximum = _mm_cvtsd_f64(_mm_max_sd(half, _mm_unpackhi_pd(half, half)));
+    for (; i < count; i++) {
+        maximum = values[i] > maximum ? values[i] : maximum;
+    }
+    return maximum;
+}
+
+/// @brief Determines the smallest element of an array using AVX
+TYPED_ARRAY_KERNELS_AVX_TARGET
+static double typed_array_kernels_avx_min(double const * values, size_t count) {
+    __m256d result = _mm256_set1_pd(values[0]);
+    size_t i = 0;
+    for (; i + 4u <= count; i += 4u) {
+        result = _mm256_min_pd(result, _mm256_loadu_pd(values + i));
+    }
+    __m128d half = _mm_min_pd(_mm256_castpd256_pd128(result), _mm256_extractf128_pd(result, 1));
+    double minimum = _mm_cvtsd_f64(_mm_min_sd(half, _mm_unpackhi_pd(half, half)));
+    for (; i < count; i++) {
+        minimum = values[i] < minimum ? values[i] : minimum;
+    }
+    return minimum;
+}
+
+/// @brief Scales an array using AVX
+TYPED_ARRAY_KERNELS_AVX_TARGET
+static void typed_array_kernels_avx_scale(double * values, double factor, size_t count) {
+    __m256d vector = _mm256_set1_pd(factor);
+    size_t i = 0;
+    for (; i + 4u <= count; i += 4u) {
+        _mm256_storeu_pd(values + i, _mm256_mul_pd(_mm256_loadu_pd(values + i), vector));
+    }
+    typed_array_kernels_scalar_scale(values + i, factor, count - i);
+}
+
+/// @brief Calculates the sum of the elements of an array using AVX
+TYPED_ARRAY_KERNELS_AVX_TARGET
+static double typed_array_kernels_avx_sum(double const * values, size_t count) {
+    __m256d first = _mm256_setzero_pd();
+    __m256d second = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8u <= count; i += 8u) {
+        first = _mm256_add_pd(first, _mm256_loadu_pd(values + i));
+        second = _mm256_add_pd(second, _mm256_loadu_pd(values + i + 4u));
+    }
+    return typed_array_kernels_avx_horizontal_sum(_mm256_add_pd(first, second)) +
+           typed_array_kernels_scalar_sum(values + i, count - i);
+}
+
+#endif
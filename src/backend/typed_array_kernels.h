@@ -0,0 +1,123 @@
+/****************************************************************************
+ * Copyright (C) 2022 by Frederik Tobner                                    *
+ *                                                                          *
+ * This file is part of Cellox.                                             *
+ *                                                                          *
+ * Permission to use, copy, modify, and distribute this software and its    *
+ * documentation under the terms of the GNU General Public License is       *
+ * hereby granted.                                                          *
+ * No representations are made about the suitability of this software for   *
+ * any purpose.                                                             *
+ * It is provided "as is" without express or implied warranty.              *
+ * See the <https://www.gnu.org/licenses/gpl-3.0.html/>GNU General Public   *
+ * License for more details.                                                *
+ ****************************************************************************/
+
+/**
+ * @file typed_array_kernels.h
+ * @brief Header file containing the declarations of the vectorized kernels that are used by the typed arrays.
+ */
+
+#ifndef CELLOX_TYPED_ARRAY_KERNELS_H_
+#define CELLOX_TYPED_ARRAY_KERNELS_H_
+
+// This file is included in the test-suite that is written in c++ using the google-test framework
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/// @brief The instruction sets the kernels can be executed with
+typedef enum {
+    /// Plain C loops (used on processors that are not x86-64 or with other compilers than gcc and clang)
+    TYPED_ARRAY_KERNELS_SCALAR,
+    /// 128-bit vectors (always available on x86-64)
+    TYPED_ARRAY_KERNELS_SSE2,
+    /// 256-bit vectors (used if the processor and the operating system support it)
+    TYPED_ARRAY_KERNELS_AVX,
+} typed_array_kernels_instruction_set;
+
+/// @brief The element-wise operations that can be applied to two arrays
+typedef enum {
+    /// Adds the elements of the source to the elements of the destination
+    TYPED_ARRAY_KERNELS_ADD,
+    /// Subtracts the elements of the source from the elements of the destination
+    TYPED_ARRAY_KERNELS_SUBTRACT,
+    /// Multiplies the elements of the destination with the elements of the source
+    TYPED_ARRAY_KERNELS_MULTIPLY,
+    /// Divides the elements of the destination by the elements of the source
+    TYPED_ARRAY_KERNELS_DIVIDE,
+} typed_array_kernels_operation;
+
+/// @brief Applies an element-wise operation to two arrays
+/// @param operation The operation that is applied
+/// @param destination The array that contains the first operands and where the results are stored
+/// @param source The array that contains the second operands
+/// @param count The amount of elements of both arrays
+void typed_array_kernels_apply(typed_array_kernels_operation operation, double * destination, double const * source,
+                               size_t count);
+
+/// @brief Adds a multiple of an array to another array (y = alpha * x + y)
+/// @param alpha The factor the elements of x are multiplied with
+/// @param x The array that is scaled
+/// @param y The array the scaled elements are added to
+/// @param count The amount of elements of both arrays
+void typed_array_kernels_axpy(double alpha, double const * x, double * y, size_t count);
+
+/// @brief Calculates the dot product of two arrays
+/// @param a The first array
+/// @param b The second array
+/// @param count The amount of elements of both arrays
+/// @return The sum of the products of the elements
+double typed_array_kernels_dot(double const * a, double const * b, size_t count);
+
+/// @brief Sets all elements of an array to the same value
+/// @param values The array that is filled
+/// @param value The value that is stored
+/// @param count The amount of elements of the array
+void typed_array_kernels_fill(double * values, double value, size_t count);
+
+/// @brief Determines the instruction set that is used by the kernels
+/// @return The instruction set that is used on this processor
+/// @details The instruction set is detected once, when a kernel is executed for the first time
+typed_array_kernels_instruction_set typed_array_kernels_get_instruction_set(void);
+
+/// @brief Determines the biggest element of an array
+/// @param values The array (must not be empty)
+/// @param count The amount of elements of the array
+/// @return The biggest element
+double typed_array_kernels_max(double const * values, size_t count);
+
+/// @brief Determines the smallest element of an array
+/// @param values The array (must not be empty)
+/// @param count The amount of elements of the array
+/// @return The smallest element
+double typed_array_kernels_min(double const * values, size_t count);
+
+/// @brief Multiplies all elements of an array with a factor
+/// @param values The array that is scaled
+/// @param factor The factor the elements are multiplied with
+/// @param count The amount of elements of the array
+void typed_array_kernels_scale(double * values, double factor, size_t count);
+
+/// @brief Selects the instruction set that is used by the kernels
+/// @param set The instruction set that is used from now on
+/// @return true if the instruction set is supported by this processor, false if not (the selection is not changed)
+/// @details The kernels for the best instruction set are selected automatically, this allows to execute the other
+/// implementations as well, e.g. the plain C loops on x86-64
+bool typed_array_kernels_set_instruction_set(typed_array_kernels_instruction_set set);
+
+/// @brief Calculates the sum of the elements of an array
+/// @param values The array
+/// @param count The amount of elements of the array
+/// @return The sum of the elements
+/// @note The elements are summed in several lanes, so the result can differ from a sequential sum in the last bits
+double typed_array_kernels_sum(double const * values, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
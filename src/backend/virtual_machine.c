@@ -22,6 +22,7 @@
 #include "virtual_machine.h"
 
 #include <math.h>
+#include <setjmp.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -30,6 +31,8 @@
 
 #include "../common.h"
 #include "../frontend/compiler.h"
+#include "garbage_collector_policy.h"
+#include "garbage_collector_statistics.h"
 #include "memory_mutator.h"
 #include "native_functions.h"
 #if defined(DEBUG_TRACE_EXECUTION)
@@ -40,6 +43,27 @@
 /// Global VirtualMachine variable
 virtual_machine_t virtualMachine;
 
+/// Execution context that is restored if the virtual machine runs out of memory, the stack overflows or a native
+/// function aborts the program
+static jmp_buf fatalErrorHandler;
+
+/// Determines whether a program is interpreted and the fatal error handler can be used
+static bool fatalErrorHandlerActive = false;
+
+/// Prevents that a function is inlined into a function that sets the fatal error handler, so the locals of the function
+/// can not be clobbered by a longjmp
+#if defined(COMPILER_GCC) || defined(COMPILER_CLANG)
+#define VIRTUAL_MACHINE_NO_INLINE __attribute__((noinline))
+#elif defined(COMPILER_MSVC)
+#define VIRTUAL_MACHINE_NO_INLINE __declspec(noinline)
+#else
+#define VIRTUAL_MACHINE_NO_INLINE
+#endif
+
+/// The amount of frames on the callstack at which the execution returns to a native function that called a closure
+static uint32_t exitFrameCount = 0u;
+
+static void virtual_machine_append_to_array(void);
 static void virtual_machine_array_literal(int32_t);
 static bool virtual_machine_bind_method(object_class_t *, object_string_t *);
 static bool virtual_machine_call(object_closure_t *, int32_t);
@@ -51,22 +75,56 @@ static void virtual_machine_concatenate_strings(void);
 static void virtual_machine_define_method(object_string_t *);
 static void virtual_machine_define_native(char const *, native_function_t);
 static void virtual_machine_define_natives(void);
+static bool virtual_machine_divide(void);
+static VIRTUAL_MACHINE_NO_INLINE interpret_result virtual_machine_execute_chunk(chunk_t);
+static interpret_result virtual_machine_execute_function(object_function_t *);
+static VIRTUAL_MACHINE_NO_INLINE interpret_result virtual_machine_execute_program(char *);
+static inline object_closure_t * virtual_machine_find_method(object_class_t *, object_string_t *);
 static bool virtual_machine_get_index_of(void);
 static bool virtual_machine_get_sclice_of(void);
+static uint8_t * virtual_machine_hash_jump(uint8_t *, value_t, value_t const *);
+static void virtual_machine_inherit(object_class_t *, object_class_t *);
+static bool virtual_machine_instantiate(object_class_t *, int32_t);
 static bool virtual_machine_invoke(object_string_t *, int32_t);
 static bool virtual_machine_invoke_from_class(object_class_t *, object_string_t *, int32_t);
+static bool virtual_machine_invoke_iterator(value_t, object_string_t *, value_t, value_t *);
 static inline bool virtual_machine_is_falsey(value_t);
+static bool virtual_machine_iterate(value_t *, bool *);
+static inline uint8_t * virtual_machine_jump_table(uint8_t *, value_t);
 static bool virtual_machine_modulo(void);
+static bool virtual_machine_multiply(void);
 static inline value_t virtual_machine_peek(int32_t);
+static inline uint32_t virtual_machine_read_u32(uint8_t const *);
 static inline void virtual_machine_reset_stack(void);
 static interpret_result virtual_machine_run(void);
 static void virtual_machine_runtime_error(char const *, ...);
+static inline void virtual_machine_set_field(object_instance_t *, object_string_t *, value_t);
 static bool virtual_machine_set_index_of(void);
 
+void virtual_machine_abort(char const * format, ...) {
+    char message[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    if (!fatalErrorHandlerActive) {
+        fprintf(stderr, "%s\n", message);
+        exit(EXIT_CODE_RUNTIME_ERROR);
+    }
+    virtual_machine_runtime_error("%s", message);
+    longjmp(fatalErrorHandler, 1);
+}
+
 void virtual_machine_free(void) {
+    if (garbage_collector_policy_report_enabled()) {
+        garbage_collector_statistics_print_report(stderr);
+    }
     value_hash_table_free(&virtualMachine.globals);
     value_hash_table_free(&virtualMachine.strings);
-    virtualMachine.initString = NULL;
+    virtualMachine.initString = virtualMachine.iterateString = virtualMachine.iteratorValueString = NULL;
+    for (uint32_t i = 0; i < UINT8_COUNT; i++) {
+        virtualMachine.characterStrings[i] = NULL;
+    }
     if (virtualMachine.program) {
         free(virtualMachine.program);
     }
@@ -75,11 +133,12 @@ void virtual_machine_free(void) {
 
 void virtual_machine_init(void) {
     virtual_machine_reset_stack();
+    garbage_collector_statistics_reset();
     virtualMachine.program = NULL;
     virtualMachine.objects = NULL;
     virtualMachine.bytesAllocated = 0;
-    // Garbage Collection is triggered after 1 MB of data has been allocated
-    virtualMachine.nextGC = (1 << 20);
+    // Garbage Collection is triggered after the initial heap target (1 MB by default) has been allocated
+    virtualMachine.nextGC = garbage_collector_policy_initial_threshold();
     virtualMachine.grayCount = virtualMachine.grayCapacity = 0u;
     virtualMachine.grayStack = NULL;
     // Initializes the hashtable that contains the global variables
@@ -87,8 +146,20 @@ void virtual_machine_init(void) {
     // Initializes the hashtable that contains the strings
     value_hash_table_init(&virtualMachine.strings);
     // virtualMachine.stackTop = virtualMachine.stack;
-    virtualMachine.initString = NULL;
+    virtualMachine.initString = virtualMachine.iterateString = virtualMachine.iteratorValueString = NULL;
     virtualMachine.initString = object_copy_string("init", 4u, false);
+    virtualMachine.iterateString = object_copy_string("iterate", 7u, false);
+    virtualMachine.iteratorValueString = object_copy_string("iteratorValue", 13u, false);
+    memset(virtualMachine.methodCache, 0, sizeof(virtualMachine.methodCache));
+    memset(virtualMachine.boundMethodCache, 0, sizeof(virtualMachine.boundMethodCache));
+    // The strings that consist of a single character are created upfront, so indexing a string does not allocate
+    for (uint32_t i = 0; i < UINT8_COUNT; i++) {
+        virtualMachine.characterStrings[i] = NULL;
+    }
+    for (uint32_t i = 0; i < UINT8_COUNT; i++) {
+        char character = (char)i;
+        virtualMachine.characterStrings[i] = object_copy_string(&character, 1u, false);
+    }
     // defines the native functions supported by the virtual machine
     virtual_machine_define_natives();
     // Sets seed value of the random number generator based on the time the vm was initialized
@@ -96,42 +167,80 @@ void virtual_machine_init(void) {
 }
 
 interpret_result virtual_machine_interpret(char * program, bool freeProgram) {
-    object_function_t * function = compiler_compile(program);
-    if (!function) {
-        return INTERPRET_COMPILE_ERROR;
-    }
-
-    virtual_machine_push(OBJECT_VAL(function));
-    object_closure_t * closure = object_new_closure(function);
-    virtual_machine_pop();
-    virtual_machine_push(OBJECT_VAL(closure));
-    virtual_machine_call(closure, 0u);
     if (freeProgram) {
         virtualMachine.program = program;
     }
-    return virtual_machine_run();
+    if (setjmp(fatalErrorHandler)) {
+        // The virtual machine has run out of memory, the stack has overflowed or a native function has failed
+        fatalErrorHandlerActive = false;
+        compiler_reset();
+        return INTERPRET_RUNTIME_ERROR;
+    }
+    fatalErrorHandlerActive = true;
+    interpret_result result = virtual_machine_execute_program(program);
+    fatalErrorHandlerActive = false;
+    return result;
+}
+
+void virtual_machine_out_of_memory(size_t requestedBytes) {
+    if (!fatalErrorHandlerActive) {
+        fprintf(stderr, "Failed to allocate %zu bytes\n", requestedBytes);
+        exit(EXIT_CODE_SYSTEM_ERROR);
+    }
+    if (garbage_collector_policy_heap_limit_exceeded(virtualMachine.bytesAllocated + requestedBytes)) {
+        virtual_machine_runtime_error("Out of memory - the heap limit of %zu bytes was exceeded",
+                                      garbage_collector_policy_heap_limit());
+    } else {
+        virtual_machine_runtime_error("Out of memory - failed to allocate %zu bytes", requestedBytes);
+    }
+    longjmp(fatalErrorHandler, 1);
 }
 
 interpret_result virtual_machine_run_chunk(chunk_t chunk) {
-    object_function_t * function = object_new_function();
-    function->chunk = chunk;
-    function->upvalueCount = 0;
-    function->arity = 0;
-    if (!function) {
-        return INTERPRET_COMPILE_ERROR;
+    if (setjmp(fatalErrorHandler)) {
+        // The virtual machine has run out of memory, the stack has overflowed or a native function has failed
+        fatalErrorHandlerActive = false;
+        return INTERPRET_RUNTIME_ERROR;
     }
-    virtual_machine_push(OBJECT_VAL(function));
-    object_closure_t * closure = object_new_closure(function);
-    virtual_machine_pop();
-    virtual_machine_push(OBJECT_VAL(closure));
-    virtual_machine_call(closure, 0u);
-    return virtual_machine_run();
+    fatalErrorHandlerActive = true;
+    interpret_result result = virtual_machine_execute_chunk(chunk);
+    fatalErrorHandlerActive = false;
+    return result;
+}
+
+bool virtual_machine_call_function(value_t callee, uint32_t argCount, value_t const * args, value_t * result) {
+    virtual_machine_push(callee);
+    for (uint32_t i = 0; i < argCount; i++) {
+        virtual_machine_push(args[i]);
+    }
+    uint32_t enclosingExitFrameCount = exitFrameCount;
+    uint32_t frameCount = virtualMachine.frameCount;
+    if (!virtual_machine_call_value(callee, (int32_t)argCount)) {
+        return false;
+    }
+    // Natives and classes without an initializer return immediately, closures are executed until they return
+    if (virtualMachine.frameCount > frameCount) {
+        exitFrameCount = frameCount;
+        interpret_result interpretResult = virtual_machine_run();
+        exitFrameCount = enclosingExitFrameCount;
+        if (interpretResult != INTERPRET_OK) {
+            return false;
+        }
+    }
+    *result = virtual_machine_pop();
+    return true;
 }
 
 void virtual_machine_push(value_t value) {
-    // There are 16384 values on the stack 🤯
+    // There are 81920 values on the stack 🤯
     if ((virtualMachine.stackTop - virtualMachine.stack) == STACK_MAX) {
+        if (!fatalErrorHandlerActive) {
+            fprintf(stderr, "Stack overflow!!!\n");
+            exit(EXIT_CODE_SYSTEM_ERROR);
+        }
+        // The execution is aborted, because the value can not be written anywhere
         virtual_machine_runtime_error("Stack overflow!!!");
+        longjmp(fatalErrorHandler, 1);
     }
     // We add the value to the stack
     *virtualMachine.stackTop = value;
@@ -146,18 +255,44 @@ value_t virtual_machine_pop(void) {
     return *virtualMachine.stackTop;
 }
 
+/// @brief Appends the upper value on the stack to the array below it without copying the array
+/// @details If the appended value is an array as well, all of its values are appended in bulk
+static void virtual_machine_append_to_array(void) {
+    object_dynamic_value_array_t * array = AS_ARRAY(virtual_machine_peek(1));
+    value_t appended = virtual_machine_peek(0);
+    object_array_prepare_mutation(array);
+    if (IS_ARRAY(appended)) {
+        // The count is read before the reservation, because an array can be appended to itself
+        uint32_t appendedCount = AS_ARRAY(appended)->array.count;
+        dynamic_value_array_reserve(&array->array, array->array.count + appendedCount);
+        if (appendedCount) {
+            memcpy(array->array.values + array->array.count, AS_ARRAY(appended)->array.values,
+                   appendedCount * sizeof(value_t));
+        }
+        array->array.count += appendedCount;
+        object_array_track_values(array, AS_ARRAY(appended));
+    } else {
+        object_array_write(array, appended);
+    }
+    virtual_machine_pop();
+}
+
 /// @brief Creates an array based on an array literal expression
 /// @param argCount The size of the array
 static void virtual_machine_array_literal(int32_t argCount) {
     object_dynamic_value_array_t * dynamicArray = object_new_dynamic_value_array();
-    value_t val;
-    // The elements are reversed on the stack so we iterate backwards 🔙
-    for (int32_t i = argCount - 1; i >= 0; i--) {
-        dynamic_value_array_write(&dynamicArray->array, virtual_machine_peek(i));
-    }
-    for (int32_t j = 0; j < argCount; j++) {
-        virtual_machine_pop();
+    // The array is kept on the stack while its values are allocated, so it is not collected by the garbage collector
+    virtual_machine_push(OBJECT_VAL(dynamicArray));
+    if (argCount) {
+        // The array gets exactly the capacity of the literal and the elements are copied from the stack at once
+        dynamicArray->array.values = ALLOCATE(value_t, argCount);
+        dynamicArray->array.capacity = dynamicArray->array.count = (uint32_t)argCount;
+        memcpy(dynamicArray->array.values, virtualMachine.stackTop - 1 - argCount, sizeof(value_t) * argCount);
+        for (int32_t i = 0; i < argCount; i++) {
+            object_array_track_value(dynamicArray, dynamicArray->array.values[i]);
+        }
     }
+    virtualMachine.stackTop -= argCount + 1;
     virtual_machine_push(OBJECT_VAL(dynamicArray));
 }
 
@@ -165,15 +300,23 @@ static void virtual_machine_array_literal(int32_t argCount) {
 /// @param celloxClass The class the method is bound to
 /// @param name The name of the method
 /// @return true if the method was defiened, false if not
+/// @details If the method has already been bound to the receiver on top of the stack, the bound method is reused
 static bool virtual_machine_bind_method(object_class_t * celloxClass, object_string_t * name) {
-    value_t method;
-    if (!value_hash_table_get(&celloxClass->methods, name, &method)) {
+    object_closure_t * method = virtual_machine_find_method(celloxClass, name);
+    if (!method) {
         virtual_machine_runtime_error("Undefined property '%s'.", name->chars);
         return false;
     }
-    object_bound_method_t * bound = object_new_bound_method(virtual_machine_peek(0), AS_CLOSURE(method));
+    value_t receiver = virtual_machine_peek(0);
+    uintptr_t cacheIndex = ((uintptr_t)AS_OBJECT(receiver) >> 4u) ^ ((uintptr_t)method >> 3u);
+    bound_method_cache_entry_t * entry = &virtualMachine.boundMethodCache[cacheIndex & (BOUND_METHOD_CACHE_SIZE - 1u)];
+    if (!entry->bound || entry->method != method || !value_values_equal(entry->receiver, receiver)) {
+        entry->bound = object_new_bound_method(receiver, method);
+        entry->receiver = receiver;
+        entry->method = method;
+    }
     virtual_machine_pop();
-    virtual_machine_push(OBJECT_VAL(bound));
+    virtual_machine_push(OBJECT_VAL(entry->bound));
     return true;
 }
 
@@ -216,18 +359,7 @@ static bool virtual_machine_call_value(value_t callee, int32_t argCount) {
                 return virtual_machine_call(bound->method, argCount);
             }
         case OBJECT_CLASS:
-            {
-                object_class_t * celloxClass = AS_CLASS(callee);
-                virtualMachine.stackTop[-argCount - 1] = OBJECT_VAL(object_new_instance(celloxClass));
-                value_t initializer;
-                if (value_hash_table_get(&celloxClass->methods, virtualMachine.initString, &initializer)) {
-                    return virtual_machine_call(AS_CLOSURE(initializer), argCount);
-                } else if (argCount != 0) {
-                    virtual_machine_runtime_error("Expected 0 arguments but got %d.", argCount);
-                    return false;
-                }
-                return true;
-            }
+            return virtual_machine_instantiate(AS_CLASS(callee), argCount);
         case OBJECT_CLOSURE:
             return virtual_machine_call(AS_CLOSURE(callee), argCount);
         case OBJECT_NATIVE:
@@ -290,22 +422,34 @@ static void virtual_machine_close_upvalues(value_t * last) {
 }
 
 /// @brief Concatenates the two upper values (cellox arrays) on the stack
+/// @details The destination is sized once and both parts are copied in bulk instead of value by value
 static void virtual_machine_concatenate_arrays(void) {
     object_dynamic_value_array_t * newArray = object_new_dynamic_value_array();
-    for (uint32_t i = 0; i < AS_ARRAY(virtual_machine_peek(1))->array.count; i++) {
-        dynamic_value_array_write(&newArray->array, AS_ARRAY(virtual_machine_peek(1))->array.values[i]);
-    }
+    // Reserving the destination may trigger a garbage collection, so the new array has to be reachable
+    virtual_machine_push(OBJECT_VAL(newArray));
+    object_dynamic_value_array_t * left = AS_ARRAY(virtual_machine_peek(2));
+    value_t right = virtual_machine_peek(1);
+    uint32_t rightCount = IS_ARRAY(right) ? AS_ARRAY(right)->array.count : 1u;
+    dynamic_value_array_reserve(&newArray->array, left->array.count + rightCount);
 
-    if (IS_ARRAY(virtual_machine_peek(0))) {
-        object_dynamic_value_array_t * array = AS_ARRAY(virtual_machine_peek(0));
-        // Adding the same array twice results in an infinite loop
-        uint32_t upperBound = array->array.count;
-        for (uint32_t i = 0; i < upperBound; i++) {
-            dynamic_value_array_write(&newArray->array, array->array.values[i]);
+    // Empty arrays have no values, so they are not copied
+    if (left->array.count) {
+        memcpy(newArray->array.values, left->array.values, left->array.count * sizeof(value_t));
+    }
+    object_array_track_values(newArray, left);
+    if (IS_ARRAY(right)) {
+        if (rightCount) {
+            memcpy(newArray->array.values + left->array.count, AS_ARRAY(right)->array.values,
+                   rightCount * sizeof(value_t));
         }
+        object_array_track_values(newArray, AS_ARRAY(right));
     } else {
-        dynamic_value_array_write(&newArray->array, virtual_machine_peek(0));
+        newArray->array.values[left->array.count] = right;
+        object_array_track_value(newArray, right);
     }
+    newArray->array.count = left->array.count + rightCount;
+
+    virtual_machine_pop();
     virtual_machine_pop();
     virtual_machine_pop();
     virtual_machine_push(OBJECT_VAL(newArray));
@@ -313,25 +457,30 @@ static void virtual_machine_concatenate_arrays(void) {
 
 /// @brief Concatenates the two upper values (cellox strings) on the stack
 static void virtual_machine_concatenate_strings(void) {
-    object_string_t * b = AS_STRING(virtual_machine_peek(0));
-    object_string_t * a = AS_STRING(virtual_machine_peek(1));
-    uint32_t length = a->length + b->length;
-    char * chars = ALLOCATE(char, length + 1u);
-    memcpy(chars, a->chars, a->length);
-    memcpy(chars + a->length, b->chars, b->length);
-    chars[length] = '\0';
-    object_string_t * result = object_take_string(chars, length);
+    // Both strings stay on the stack until the result is created, so they can not be reclaimed in the meantime
+    object_string_t * result =
+        object_concatenate_strings(AS_STRING(virtual_machine_peek(1)), AS_STRING(virtual_machine_peek(0)));
     virtual_machine_pop();
     virtual_machine_pop();
     virtual_machine_push(OBJECT_VAL(result));
 }
 
-/// @brief Defines a new Method in the hashTable of the cellox class instance
+/// @brief Defines a new Method in the method vector of the cellox class
 /// @param name The name of the method
+/// @details A method that overrides an inherited method replaces it in its slot, otherwise a new slot is appended
 static void virtual_machine_define_method(object_string_t * name) {
     value_t method = virtual_machine_peek(0);
     object_class_t * celloxClass = AS_CLASS(virtual_machine_peek(1));
-    value_hash_table_set(&celloxClass->methods, name, method);
+    value_t slot;
+    if (value_hash_table_get(&celloxClass->methodSlots, name, &slot)) {
+        celloxClass->methods.values[(uint32_t)AS_NUMBER(slot)] = method;
+    } else {
+        value_hash_table_set(&celloxClass->methodSlots, name, NUMBER_VAL(celloxClass->methods.count));
+        dynamic_value_array_write(&celloxClass->methods, method);
+    }
+    if (name == virtualMachine.initString) {
+        celloxClass->initializer = AS_CLOSURE(method);
+    }
     virtual_machine_pop();
 }
 
@@ -359,29 +508,127 @@ static void virtual_machine_define_natives(void) {
     }
 }
 
-/// @brief Gets an item in an array or a string specified by a numerical index
+/// @brief Executes a division
+/// @return A boolean value that indicates whether the execution has led to a runtime error
+static bool virtual_machine_divide(void) {
+    if (IS_INTEGER(virtual_machine_peek(0)) && IS_INTEGER(virtual_machine_peek(1))) {
+        value_t quotient;
+        if (value_divide_integers(AS_INTEGER(virtual_machine_peek(1)), AS_INTEGER(virtual_machine_peek(0)),
+                                  &quotient)) {
+            virtual_machine_pop();
+            virtual_machine_pop();
+            virtual_machine_push(quotient);
+            return true;
+        }
+    }
+    if (!IS_NUMBER(virtual_machine_peek(0)) || !IS_NUMBER(virtual_machine_peek(1))) {
+        virtual_machine_runtime_error(
+            "Operands must be numbers but they are a %s %s and a %s %s", value_stringify_type(virtual_machine_peek(0)),
+            IS_OBJECT(virtual_machine_peek(0)) ? "object" : "value", value_stringify_type(virtual_machine_peek(1)),
+            IS_OBJECT(virtual_machine_peek(1)) ? "object" : "value");
+        return false;
+    }
+    double b = AS_NUMBER(virtual_machine_pop());
+    double a = AS_NUMBER(virtual_machine_pop());
+    virtual_machine_push(NUMBER_VAL(a / b));
+    return true;
+}
+
+/// @brief Executes a chunk that has been loaded from a chunk file
+/// @param chunk The chunk that is executed
+/// @return The result of the execution
+static VIRTUAL_MACHINE_NO_INLINE interpret_result virtual_machine_execute_chunk(chunk_t chunk) {
+    object_function_t * function = object_new_function();
+    function->chunk = chunk;
+    function->upvalueCount = 0;
+    function->arity = 0;
+    if (!function) {
+        return INTERPRET_COMPILE_ERROR;
+    }
+    return virtual_machine_execute_function(function);
+}
+
+/// @brief Executes the function of a script
+/// @param function The function that is executed
+/// @return The result of the execution
+static interpret_result virtual_machine_execute_function(object_function_t * function) {
+    virtual_machine_push(OBJECT_VAL(function));
+    object_closure_t * closure = object_new_closure(function);
+    virtual_machine_pop();
+    virtual_machine_push(OBJECT_VAL(closure));
+    virtual_machine_call(closure, 0u);
+    return virtual_machine_run();
+}
+
+/// @brief Compiles and executes a program
+/// @param program The source code of the program
+/// @return The result of the compilation and the execution
+static VIRTUAL_MACHINE_NO_INLINE interpret_result virtual_machine_execute_program(char * program) {
+    object_function_t * function = compiler_compile(program);
+    if (!function) {
+        return INTERPRET_COMPILE_ERROR;
+    }
+    return virtual_machine_execute_function(function);
+}
+
+/// @brief Looks up a method of a class
+/// @param celloxClass The class where the method is looked up
+/// @param name The name of the method
+/// @return The closure of the method or NULL if the class has no method with the given name
+/// @details The slot of the method is taken from the method cache, only if the class and the name are not cached the
+/// slot is looked up in the hashtable of the class
+static inline object_closure_t * virtual_machine_find_method(object_class_t * celloxClass, object_string_t * name) {
+    uintptr_t cacheIndex = ((uintptr_t)celloxClass >> 3u) ^ ((uintptr_t)name >> 4u);
+    method_cache_entry_t * entry = &virtualMachine.methodCache[cacheIndex & (METHOD_CACHE_SIZE - 1u)];
+    if (entry->celloxClass != celloxClass || entry->name != name) {
+        value_t slot;
+        if (!value_hash_table_get(&celloxClass->methodSlots, name, &slot)) {
+            return NULL;
+        }
+        entry->celloxClass = celloxClass;
+        entry->name = name;
+        entry->slot = (uint32_t)AS_NUMBER(slot);
+    }
+    return AS_CLOSURE(celloxClass->methods.values[entry->slot]);
+}
+
+/// @brief Gets an item in an array or a string specified by a numerical index or the value of a key in a map
 /// @return A boolean value that indicates whether the execution has led to a runtime error
 static bool virtual_machine_get_index_of(void) {
-    if (IS_NUMBER(virtual_machine_peek(0)) && IS_STRING(virtual_machine_peek(1))) {
-        int num = AS_NUMBER(virtual_machine_pop());
-        object_string_t * str = AS_STRING(virtual_machine_pop());
+    if (IS_MAP(virtual_machine_peek(1))) {
+        // Looking up a key that is not contained in the map results in null
+        value_t value = NULL_VAL;
+        value_map_get(&AS_MAP(virtual_machine_peek(1))->map, virtual_machine_peek(0), &value);
+        virtual_machine_pop();
+        virtual_machine_pop();
+        virtual_machine_push(value);
+    } else if (IS_NUMBER(virtual_machine_peek(0)) && IS_STRING(virtual_machine_peek(1))) {
+        int num = value_truncate(virtual_machine_pop());
+        // The string stays on the stack, because a rope is flattened when it is indexed
+        object_string_t * str = AS_STRING(virtual_machine_peek(0));
         if (num >= str->length || num < 0) {
             virtual_machine_runtime_error("accessed string out of bounds (at index %i)", num);
             return false;
         }
-        char * chars = ALLOCATE(char, 2u);
-        chars[0] = str->chars[num];
-        chars[1] = '\0';
-        object_string_t * result = object_take_string(chars, 1u);
+        object_string_t * result = virtual_machine_character_string(object_string_chars(str)[num]);
+        virtual_machine_pop();
         virtual_machine_push(OBJECT_VAL(result));
     } else if (IS_NUMBER(virtual_machine_peek(0)) && IS_ARRAY(virtual_machine_peek(1))) {
-        int num = AS_NUMBER(virtual_machine_pop());
+        int num = value_truncate(virtual_machine_pop());
         object_dynamic_value_array_t * array = AS_ARRAY(virtual_machine_pop());
         if (num >= array->array.count || num < 0) {
             virtual_machine_runtime_error("accessed array out of bounds (at index %i)", num);
             return false;
         }
         virtual_machine_push(array->array.values[num]);
+    } else if (IS_NUMBER(virtual_machine_peek(0)) && IS_TYPED_ARRAY(virtual_machine_peek(1))) {
+        int num = value_truncate(virtual_machine_pop());
+        object_typed_array_t * array = AS_TYPED_ARRAY(virtual_machine_pop());
+        if (num >= (int64_t)array->count || num < 0) {
+            virtual_machine_runtime_error("accessed typed array out of bounds (at index %i)", num);
+            return false;
+        }
+        virtual_machine_push(NUMBER_VAL(object_typed_array_get(array, num)));
     } else {
         virtual_machine_runtime_error(
             "Operands must a numerical value and a string object but are a %s %s and a %s %s",
@@ -415,8 +662,8 @@ static bool virtual_machine_get_slice_of(void) {
         return false;
     }
 
-    int upperBound = AS_NUMBER(virtual_machine_pop());
-    int i = AS_NUMBER(virtual_machine_pop());
+    int upperBound = value_truncate(virtual_machine_pop());
+    int i = value_truncate(virtual_machine_pop());
     if (i >= upperBound) {
         virtual_machine_runtime_error(
             "Upper bound must be bigger than lower bound, but upper bound is %d and lower bound is %d", upperBound, i);
@@ -426,34 +673,99 @@ static bool virtual_machine_get_slice_of(void) {
         virtual_machine_runtime_error("LowerBound can not be negative, but is %d", i);
         return false;
     }
+    // The source stays on the stack while the slice is created, so it can not be reclaimed in the meantime
     if (IS_ARRAY(virtual_machine_peek(0))) {
-        object_dynamic_value_array_t * sourceArray = AS_ARRAY(virtual_machine_pop());
+        object_dynamic_value_array_t * sourceArray = AS_ARRAY(virtual_machine_peek(0));
         if (upperBound >= sourceArray->array.count) {
             virtual_machine_runtime_error(
                 "Upperbound can not be higher or equal to the size of the array, but upperbound is %d and size %d",
                 upperBound, sourceArray->array.count);
             return false;
         }
-        object_dynamic_value_array_t * resultArray = object_new_dynamic_value_array();
-        for (; i < upperBound; i++) {
-            dynamic_value_array_write(&resultArray->array, sourceArray->array.values[i]);
-        }
+        object_dynamic_value_array_t * resultArray = object_new_array_slice(sourceArray, i, upperBound - i);
+        virtual_machine_pop();
         virtual_machine_push(OBJECT_VAL(resultArray));
     } else {
-        object_string_t * sourceString = AS_STRING(virtual_machine_pop());
+        object_string_t * sourceString = AS_STRING(virtual_machine_peek(0));
         if (upperBound >= sourceString->length) {
             virtual_machine_runtime_error(
                 "Upperbound can not be higher or equal to the length of the string but upperbound is %d and size %d",
                 upperBound, sourceString->length);
             return false;
         }
-        char * chars = ALLOCATE(char, upperBound - i + 1);
-        for (; i < upperBound; i++) {
-            chars[i] = sourceString->chars[i];
+        object_string_t * resultString = object_new_string_slice(sourceString, i, upperBound - i);
+        virtual_machine_pop();
+        virtual_machine_push(OBJECT_VAL(resultString));
+    }
+    return true;
+}
+
+/// @brief Looks up the case of a switch statement in the hashtable of a hash jump instruction
+/// @param ip Pointer to the operands of the instruction
+/// @param subject The value the switch statement dispatches on
+/// @param constants The constants of the chunk, that contains the labels of the cases
+/// @return Pointer to the instruction where the execution continues
+/// @note Hashing a rope flattens it, so the subject has to be reachable
+static uint8_t * virtual_machine_hash_jump(uint8_t * ip, value_t subject, value_t const * constants) {
+    uint32_t defaultJump = virtual_machine_read_u32(ip);
+    uint32_t slotCount = (uint32_t)(ip[4] << 8 | ip[5]);
+    uint8_t * slots = ip + 6;
+    uint8_t * end = slots + 6u * slotCount;
+    // Case labels are either numbers or strings
+    if (IS_NUMBER(subject) || IS_STRING(subject)) {
+        uint32_t mask = slotCount - 1u;
+        // There is always an empty slot, because the table is at most half full
+        for (uint32_t index = value_map_hash_key(subject) & mask;; index = (index + 1u) & mask) {
+            uint8_t * slot = slots + 6u * index;
+            uint32_t jump = virtual_machine_read_u32(slot + 2);
+            if (!jump) {
+                break;
+            }
+            if (value_values_equal(constants[slot[0] << 8 | slot[1]], subject)) {
+                return end - jump;
+            }
         }
-        chars[i] = '\0';
-        object_string_t * resultSting = object_take_string(chars, upperBound - i + 1);
-        virtual_machine_push(OBJECT_VAL(resultSting));
+    }
+    return end - defaultJump;
+}
+
+/// @brief Copies the methods of a superclass down into a subclass
+/// @param superclass The class that is inherited from
+/// @param subclass The class that inherits the methods (no methods are defined in the subclass at this point)
+/// @details The subclass gets the same slots for the inherited methods as the superclass, so the methods that are
+/// defined in the body of the subclass afterwards override them in place
+static void virtual_machine_inherit(object_class_t * superclass, object_class_t * subclass) {
+    dynamic_value_array_reserve(&subclass->methods, superclass->methods.count);
+    for (uint32_t i = 0; i < superclass->methods.count; i++) {
+        dynamic_value_array_write(&subclass->methods, superclass->methods.values[i]);
+    }
+    value_hash_table_add_all(&superclass->methodSlots, &subclass->methodSlots);
+    subclass->initializer = superclass->initializer;
+}
+
+/// @brief Creates an instance of a class and calls the initializer of the class
+/// @param celloxClass The class that is instantiated
+/// @param argCount The amount of arguments the class was called with
+/// @return true if everything went well, false if the wrong amount of arguments was used or the callstack is full
+/// @details The arguments are checked before the instance is allocated. The instance replaces the class on the stack
+/// and the callframe of the initializer is pushed right away.
+static bool virtual_machine_instantiate(object_class_t * celloxClass, int32_t argCount) {
+    object_closure_t * initializer = celloxClass->initializer;
+    int32_t arity = initializer ? (int32_t)initializer->function->arity : 0;
+    if (argCount != arity) {
+        virtual_machine_runtime_error("Expected %d arguments but got %d.", arity, argCount);
+        return false;
+    }
+    if (initializer && virtualMachine.frameCount == FRAMES_MAX) {
+        virtual_machine_runtime_error("Stack overflow.");
+        return false;
+    }
+    virtualMachine.stackTop[-argCount - 1] = OBJECT_VAL(object_new_instance(celloxClass));
+    if (initializer) {
+        call_frame_t * frame = &virtualMachine.callStack[virtualMachine.frameCount++];
+        frame->closure = initializer;
+        frame->ip = initializer->function->chunk.code;
+        frame->slots = virtualMachine.stackTop - argCount - 1;
     }
     return true;
 }
@@ -486,12 +798,37 @@ static bool virtual_machine_invoke(object_string_t * name, int32_t argCount) {
 /// @return true if everything went well, false if something went wrong (undefiened method / stack overflow / wrong
 /// argument count)
 static bool virtual_machine_invoke_from_class(object_class_t * celloxClass, object_string_t * name, int32_t argCount) {
-    value_t method;
-    if (!value_hash_table_get(&celloxClass->methods, name, &method)) {
+    object_closure_t * method = virtual_machine_find_method(celloxClass, name);
+    if (!method) {
         virtual_machine_runtime_error("Undefined property '%s'.", name->chars);
         return false;
     }
-    return virtual_machine_call(AS_CLOSURE(method), argCount);
+    return virtual_machine_call(method, argCount);
+}
+
+/// @brief Invokes a method of the iterator protocol and executes it until it returns
+/// @param receiver The instance that is iterated
+/// @param name The name of the method (iterate or iteratorValue)
+/// @param cursor The cursor of the for-each loop, that is passed as the argument
+/// @param result Pointer to the value where the result of the method is stored
+/// @return A boolean value that indicates whether the execution has led to a runtime error
+static bool virtual_machine_invoke_iterator(value_t receiver, object_string_t * name, value_t cursor,
+                                            value_t * result) {
+    virtual_machine_push(receiver);
+    virtual_machine_push(cursor);
+    uint32_t enclosingExitFrameCount = exitFrameCount;
+    uint32_t frameCount = virtualMachine.frameCount;
+    if (!virtual_machine_invoke_from_class(AS_INSTANCE(receiver)->celloxClass, name, 1)) {
+        return false;
+    }
+    exitFrameCount = frameCount;
+    interpret_result interpretResult = virtual_machine_run();
+    exitFrameCount = enclosingExitFrameCount;
+    if (interpretResult != INTERPRET_OK) {
+        return false;
+    }
+    *result = virtual_machine_pop();
+    return true;
 }
 
 /// @brief  Determines if a value is falsey (either null or false)
@@ -501,13 +838,127 @@ static inline bool virtual_machine_is_falsey(value_t value) {
     return IS_NULL(value) || (IS_BOOL(value) && !AS_BOOL(value));
 }
 
+/// @brief Pushes the next element of the collection of a for-each loop onto the stack and advances the cursor
+/// @param iterator Pointer to the hidden locals of the loop (the collection, the cursor and the modification count)
+/// @param exhausted Set to true if there are no elements left
+/// @return A boolean value that indicates whether the execution has led to a runtime error
+/** @details Arrays, strings and typed arrays are indexed directly, the cursor is the index of the next element (null
+ * before the first element). The cursor of a map is the index of the next entry that is examined, the keys of the map
+ * are iterated. Adding or removing a key moves the entries of a map, so the modification count of the map is stored
+ * when the loop starts and changing the keys of the map in the loop is a runtime error. Instances implement the
+ * iterator protocol with two methods instead. iterate(cursor) returns the next cursor or a falsey value if there are
+ * no elements left, iteratorValue(cursor) returns the element at the cursor.
+ */
+static bool virtual_machine_iterate(value_t * iterator, bool * exhausted) {
+    value_t collection = iterator[0];
+    if (IS_INSTANCE(collection)) {
+        value_t cursor;
+        if (!virtual_machine_invoke_iterator(collection, virtualMachine.iterateString, iterator[1], &cursor)) {
+            return false;
+        }
+        iterator[1] = cursor;
+        *exhausted = virtual_machine_is_falsey(cursor);
+        if (*exhausted) {
+            return true;
+        }
+        value_t element;
+        if (!virtual_machine_invoke_iterator(collection, virtualMachine.iteratorValueString, cursor, &element)) {
+            return false;
+        }
+        virtual_machine_push(element);
+        return true;
+    }
+    uint32_t index = IS_NULL(iterator[1]) ? 0u : (uint32_t)value_truncate(iterator[1]);
+    if (IS_ARRAY(collection)) {
+        object_dynamic_value_array_t * array = AS_ARRAY(collection);
+        *exhausted = index >= array->array.count;
+        if (!*exhausted) {
+            virtual_machine_push(array->array.values[index]);
+        }
+    } else if (IS_STRING(collection)) {
+        // The string is stored in a local, because a rope is flattened when it is indexed
+        object_string_t * string = AS_STRING(collection);
+        *exhausted = index >= string->length;
+        if (!*exhausted) {
+            virtual_machine_push(OBJECT_VAL(virtual_machine_character_string(object_string_chars(string)[index])));
+        }
+    } else if (IS_TYPED_ARRAY(collection)) {
+        object_typed_array_t * array = AS_TYPED_ARRAY(collection);
+        *exhausted = index >= array->count;
+        if (!*exhausted) {
+            virtual_machine_push(NUMBER_VAL(object_typed_array_get(array, index)));
+        }
+    } else if (IS_MAP(collection)) {
+        value_map_t * map = &AS_MAP(collection)->map;
+        value_t modificationCount = value_from_integer(map->modificationCount);
+        if (IS_NULL(iterator[1])) {
+            iterator[2] = modificationCount;
+        } else if (!value_values_equal(iterator[2], modificationCount)) {
+            virtual_machine_runtime_error("The keys of a map can not be changed while it is iterated");
+            return false;
+        }
+        while (index < map->capacity && !map->entries[index].hash) {
+            index++;
+        }
+        *exhausted = index >= map->capacity;
+        if (!*exhausted) {
+            virtual_machine_push(map->entries[index].key);
+        }
+    } else {
+        virtual_machine_runtime_error("Only arrays, strings, typed arrays, maps and instances can be iterated but the "
+                                      "collection is a %s %s",
+                                      value_stringify_type(collection), IS_OBJECT(collection) ? "object" : "value");
+        return false;
+    }
+    if (!*exhausted) {
+        iterator[1] = value_from_integer((int64_t)index + 1);
+    }
+    return true;
+}
+
+/// @brief Looks up the case of a switch statement in the table of a jump table instruction
+/// @param ip Pointer to the operands of the instruction
+/// @param subject The value the switch statement dispatches on
+/// @return Pointer to the instruction where the execution continues
+static inline uint8_t * virtual_machine_jump_table(uint8_t * ip, value_t subject) {
+    uint32_t defaultJump = virtual_machine_read_u32(ip);
+    int32_t minimum = (int32_t)virtual_machine_read_u32(ip + 4);
+    uint32_t count = (uint32_t)(ip[8] << 8 | ip[9]);
+    uint8_t * entries = ip + 10;
+    uint8_t * end = entries + 4u * count;
+    int64_t index;
+    if (IS_INTEGER(subject)) {
+        index = (int64_t)AS_INTEGER(subject) - minimum;
+    } else if (IS_NUMBER(subject)) {
+        double number = AS_NUMBER(subject);
+        // Numbers with a fractional part or outside of the range of the labels can not match any case
+        if (!(number >= INT32_MIN && number <= INT32_MAX) || number != (double)(int32_t)number) {
+            return end - defaultJump;
+        }
+        index = (int64_t)(int32_t)number - minimum;
+    } else {
+        return end - defaultJump;
+    }
+    if ((uint64_t)index >= count) {
+        return end - defaultJump;
+    }
+    return end - virtual_machine_read_u32(entries + 4u * index);
+}
+
 /// @brief Executes a modulo operation
 /// @return A boolean value that indicates whether the execution has led to a runtime error
 static bool virtual_machine_modulo() {
     if (IS_NUMBER(virtual_machine_peek(0)) && IS_NUMBER(virtual_machine_peek(1))) {
-        int b = AS_NUMBER(virtual_machine_pop());
-        int a = AS_NUMBER(virtual_machine_pop());
-        virtual_machine_push(NUMBER_VAL(a % b));
+        // The operands are truncated to integers, so integer operands are used without converting them
+        int64_t b = value_truncate(virtual_machine_peek(0));
+        int64_t a = value_truncate(virtual_machine_peek(1));
+        if (!b) {
+            virtual_machine_runtime_error("Modulo by zero");
+            return false;
+        }
+        virtual_machine_pop();
+        virtual_machine_pop();
+        virtual_machine_push(value_from_integer(a % b));
     } else {
         virtual_machine_runtime_error(
             "Operands must be two numbers but they are a %s %s and a %s %s",
@@ -518,6 +969,28 @@ static bool virtual_machine_modulo() {
     return true;
 }
 
+/// @brief Executes a multiplication
+/// @return A boolean value that indicates whether the execution has led to a runtime error
+static bool virtual_machine_multiply(void) {
+    if (IS_INTEGER(virtual_machine_peek(0)) && IS_INTEGER(virtual_machine_peek(1))) {
+        int64_t b = AS_INTEGER(virtual_machine_pop());
+        int64_t a = AS_INTEGER(virtual_machine_pop());
+        virtual_machine_push(value_multiply_integers(a, b));
+        return true;
+    }
+    if (!IS_NUMBER(virtual_machine_peek(0)) || !IS_NUMBER(virtual_machine_peek(1))) {
+        virtual_machine_runtime_error(
+            "Operands must be numbers but they are a %s %s and a %s %s", value_stringify_type(virtual_machine_peek(0)),
+            IS_OBJECT(virtual_machine_peek(0)) ? "object" : "value", value_stringify_type(virtual_machine_peek(1)),
+            IS_OBJECT(virtual_machine_peek(1)) ? "object" : "value");
+        return false;
+    }
+    double b = AS_NUMBER(virtual_machine_pop());
+    double a = AS_NUMBER(virtual_machine_pop());
+    virtual_machine_push(NUMBER_VAL(a * b));
+    return true;
+}
+
 /// @brief Gets the value at the specified distance on the stack
 /// @param distance The distance to the value
 /// @return The value at the specified distance
@@ -525,6 +998,13 @@ static inline value_t virtual_machine_peek(int32_t distance) {
     return virtualMachine.stackTop[-1 - distance];
 }
 
+/// @brief Reads a big endian unsigned 32-bit integer operand
+/// @param ip Pointer to the first byte of the operand
+/// @return The value of the operand
+static inline uint32_t virtual_machine_read_u32(uint8_t const * ip) {
+    return (uint32_t)ip[0] << 24 | (uint32_t)ip[1] << 16 | (uint32_t)ip[2] << 8 | ip[3];
+}
+
 /// @brief Resets the stack of the vm
 /// @details This means that all values will be removed
 /// The upvalues and framecount is also reset.
@@ -532,6 +1012,7 @@ static inline void virtual_machine_reset_stack(void) {
     virtualMachine.stackTop = virtualMachine.stack;
     virtualMachine.frameCount = 0u;
     virtualMachine.openUpvalues = NULL;
+    exitFrameCount = 0u;
 }
 
 static interpret_result virtual_machine_run(void) {
@@ -545,8 +1026,14 @@ static interpret_result virtual_machine_run(void) {
 /// Reads a single short (unsigned 16-bit integer value from the current frame on top of the callstack
 #define READ_SHORT()    (frame->ip += 2, (uint16_t)((frame->ip[-2] << 8) | frame->ip[-1]))
 
+/// Reads an index operand, that is widened by the OP_EXTENDED_ARG prefixes in front of the instruction
+#define READ_INDEX()    (extendedArg | READ_BYTE())
+
+/// Reads a jump offset, that is widened by the OP_EXTENDED_ARG prefixes in front of the instruction
+#define READ_OFFSET()   (extendedArg << 8 | READ_SHORT())
+
 /// Reads a constant from the closure of the current frame on the callstack
-#define READ_CONSTANT() (frame->closure->function->chunk.constants.values[READ_BYTE()])
+#define READ_CONSTANT() (frame->closure->function->chunk.constants.values[READ_INDEX()])
 
 /// Makro reads string in the chunk
 #define READ_STRING()   AS_STRING(READ_CONSTANT())
@@ -556,8 +1043,15 @@ static interpret_result virtual_machine_run(void) {
  * We have to embed the marco into a do while, which isn't followed by a semicolon,
  * so all the statements in it get executed if they are after an if 🤮
  */
-#define BINARY_OP(valueType, op)                                                                       \
+#define BINARY_OP(valueType, integerType, op)                                                          \
     do {                                                                                               \
+        if (IS_INTEGER(virtual_machine_peek(0)) && IS_INTEGER(virtual_machine_peek(1))) {              \
+            /* Integers are widened to 64 bits, so the result can not overflow before it is checked */ \
+            int64_t b = AS_INTEGER(virtual_machine_pop());                                             \
+            int64_t a = AS_INTEGER(virtual_machine_pop());                                             \
+            virtual_machine_push(integerType(a op b));                                                 \
+            break;                                                                                     \
+        }                                                                                              \
         if (!IS_NUMBER(virtual_machine_peek(0)) || !IS_NUMBER(virtual_machine_peek(1))) {              \
             virtual_machine_runtime_error("Operands must be numbers but they are a %s %s and a %s %s", \
                                           value_stringify_type(virtual_machine_peek(0)),               \
@@ -572,6 +1066,8 @@ static interpret_result virtual_machine_run(void) {
     } while (false)
 
     call_frame_t * frame = &virtualMachine.callStack[virtualMachine.frameCount - 1];
+    // The operand bits of the OP_EXTENDED_ARG prefixes in front of the current instruction
+    uint32_t extendedArg = 0u;
 
 // For GCC and Clang we use computed goto's for non-debug builds, to create a efficient dispatch table, in order to
 // speed up the execution.🚀 This is for example also done by ruby or dalvik (android java VM). Lua on the other hand
@@ -579,19 +1075,27 @@ static interpret_result virtual_machine_run(void) {
 #if !defined(BUILD_DEBUG) && (defined(COMPILER_GCC) || defined(COMPILER_Clang))
 
     // Dispatch table with the labels we jump to instead of function pointers
-    void * dispatch_table[] = {
-        &&label_add,           &&label_array_literal, &&label_call,          &&label_class,         &&label_closure,
-        &&label_close_upvalue, &&label_constant,      &&label_define_global, &&label_divide,        &&label_equal,
-        &&label_exponent,      &&label_false,         &&label_get_global,    &&label_get_index_of,  &&label_get_local,
-        &&label_get_property,  &&label_get_slice_of,  &&label_get_super,     &&label_get_upvalue,   &&label_greater,
-        &&label_inherit,       &&label_invoke,        &&label_jump,          &&label_jump_if_false, &&label_less,
-        &&label_loop,          &&label_method,        &&label_modulo,        &&label_multiply,      &&label_negate,
-        &&label_not,           &&label_null,          &&label_pop,           &&label_return,        &&label_set_global,
-        &&label_set_index_of,  &&label_set_local,     &&label_set_property,  &&label_set_upvalue,   &&label_subtract,
-        &&label_super_invoke,  &&label_true};
+    // The table is static, so it is not rebuilt when a native function calls back into the virtual machine
+    static void * dispatch_table[] = {
+        &&label_add,            &&label_add_in_place,   &&label_array_constant, &&label_array_literal,
+        &&label_call,           &&label_class,          &&label_closure,        &&label_close_upvalue,
+        &&label_constant,       &&label_define_global,  &&label_divide,         &&label_equal,
+        &&label_exponent,       &&label_extended_arg,   &&label_false,          &&label_for_each,
+        &&label_get_global,     &&label_get_index_of,   &&label_get_local,      &&label_get_property,
+        &&label_get_slice_of,   &&label_get_super,      &&label_get_upvalue,    &&label_greater,
+        &&label_hash_jump,      &&label_inherit,        &&label_invoke,         &&label_jump,
+        &&label_jump_if_false,  &&label_jump_table,     &&label_less,           &&label_loop,
+        &&label_method,         &&label_modulo,         &&label_multiply,       &&label_negate,
+        &&label_not,            &&label_null,           &&label_pop,            &&label_return,
+        &&label_set_global,     &&label_set_index_of,   &&label_set_local,      &&label_set_property,
+        &&label_set_upvalue,    &&label_subtract,       &&label_super_invoke,   &&label_true};
 
 /// Makro that dipatches the next bytecode instuction
-#define DISPATCH() goto * dispatch_table[READ_BYTE()]
+#define DISPATCH()                           \
+    do {                                     \
+        extendedArg = 0u;                    \
+        goto * dispatch_table[READ_BYTE()]; \
+    } while (false)
 
     DISPATCH();
 #endif // Not debug and clang or gcc
@@ -611,11 +1115,18 @@ static interpret_result virtual_machine_run(void) {
 #endif
 
 #if !defined(BUILD_DEBUG) && (defined(COMPILER_GCC) || defined(COMPILER_Clang))
+    label_add_in_place:
+        if (IS_ARRAY(virtual_machine_peek(1))) {
+            virtual_machine_append_to_array();
+            DISPATCH();
+        }
+        // Other values are added like they are added by OP_ADD
+        goto label_add;
     label_add:
         if (IS_STRING(virtual_machine_peek(0)) && IS_STRING(virtual_machine_peek(1))) {
             virtual_machine_concatenate_strings();
         } else if (IS_NUMBER(virtual_machine_peek(0)) && IS_NUMBER(virtual_machine_peek(1))) {
-            BINARY_OP(NUMBER_VAL, +);
+            BINARY_OP(NUMBER_VAL, value_from_integer, +);
         } else if (IS_ARRAY(virtual_machine_peek(1))) {
             virtual_machine_concatenate_arrays();
         } else {
@@ -626,6 +1137,9 @@ static interpret_result virtual_machine_run(void) {
             return INTERPRET_RUNTIME_ERROR;
         }
         DISPATCH();
+    label_array_constant:
+        virtual_machine_push(OBJECT_VAL(object_new_array_copy(AS_ARRAY(READ_CONSTANT()))));
+        DISPATCH();
     label_array_literal:
         virtual_machine_array_literal(READ_BYTE());
         DISPATCH();
@@ -645,7 +1159,7 @@ static interpret_result virtual_machine_run(void) {
             virtual_machine_push(OBJECT_VAL(closure));
             for (uint32_t i = 0; i < closure->upvalueCount; i++) {
                 uint8_t isLocal = READ_BYTE();
-                uint8_t index = READ_BYTE();
+                uint16_t index = READ_SHORT();
                 closure->upvalues[i] =
                     isLocal ? virtual_machine_capture_upvalue(frame->slots + index) : frame->closure->upvalues[index];
             }
@@ -672,13 +1186,17 @@ static interpret_result virtual_machine_run(void) {
             DISPATCH();
         }
     label_divide:
-        BINARY_OP(NUMBER_VAL, /);
+        if (!virtual_machine_divide()) {
+            return INTERPRET_RUNTIME_ERROR;
+        }
         DISPATCH();
     label_equal:
         {
-            value_t a = virtual_machine_pop();
-            value_t b = virtual_machine_pop();
-            virtual_machine_push(BOOL_VAL(value_values_equal(a, b)));
+            // Comparing ropes flattens them, so both values stay on the stack until they are compared
+            bool equal = value_values_equal(virtual_machine_peek(0), virtual_machine_peek(1));
+            virtual_machine_pop();
+            virtual_machine_pop();
+            virtual_machine_push(BOOL_VAL(equal));
             DISPATCH();
         }
     label_exponent:
@@ -693,9 +1211,26 @@ static interpret_result virtual_machine_run(void) {
             return INTERPRET_RUNTIME_ERROR;
         }
         DISPATCH();
+    label_extended_arg:
+        // The prefix widens the operand of the next instruction, so extendedArg must not be reset before it
+        extendedArg = (extendedArg | READ_BYTE()) << 8;
+        goto * dispatch_table[READ_BYTE()];
     label_false:
         virtual_machine_push(BOOL_VAL(false));
         DISPATCH();
+    label_for_each:
+        {
+            uint32_t offset = READ_OFFSET();
+            uint16_t slot = READ_SHORT();
+            bool exhausted;
+            if (!virtual_machine_iterate(frame->slots + slot, &exhausted)) {
+                return INTERPRET_RUNTIME_ERROR;
+            }
+            if (exhausted) {
+                frame->ip += offset;
+            }
+            DISPATCH();
+        }
     label_get_global:
         {
             object_string_t * name = READ_STRING();
@@ -713,7 +1248,7 @@ static interpret_result virtual_machine_run(void) {
         }
         DISPATCH();
     label_get_local:
-        virtual_machine_push(frame->slots[READ_BYTE()]);
+        virtual_machine_push(frame->slots[READ_INDEX()]);
         DISPATCH();
     label_get_property:
         {
@@ -755,12 +1290,18 @@ static interpret_result virtual_machine_run(void) {
         }
     label_get_upvalue:
         {
-            uint8_t slot = READ_BYTE();
+            uint32_t slot = READ_INDEX();
             virtual_machine_push(*frame->closure->upvalues[slot]->location);
             DISPATCH();
         }
     label_greater:
-        BINARY_OP(BOOL_VAL, >);
+        BINARY_OP(BOOL_VAL, BOOL_VAL, >);
+        DISPATCH();
+    label_hash_jump:
+        // The subject is popped after the lookup, because hashing a rope flattens it
+        frame->ip = virtual_machine_hash_jump(frame->ip, virtual_machine_peek(0),
+                                              frame->closure->function->chunk.constants.values);
+        virtual_machine_pop();
         DISPATCH();
     label_inherit:
         {
@@ -773,7 +1314,7 @@ static interpret_result virtual_machine_run(void) {
                 return INTERPRET_RUNTIME_ERROR;
             }
             object_class_t * subclass = AS_CLASS(virtual_machine_peek(0));
-            value_hash_table_add_all(&AS_CLASS(superclassvalue)->methods, &subclass->methods);
+            virtual_machine_inherit(AS_CLASS(superclassvalue), subclass);
             virtual_machine_pop(); // Subclass.
             DISPATCH();
         }
@@ -788,22 +1329,25 @@ static interpret_result virtual_machine_run(void) {
         }
     label_jump:
         // We jump 🦘
-        frame->ip += READ_SHORT();
+        frame->ip += READ_OFFSET();
         DISPATCH();
     label_jump_if_false:
         {
-            uint16_t offset = READ_SHORT();
+            uint32_t offset = READ_OFFSET();
             if (virtual_machine_is_falsey(virtual_machine_peek(0))) {
                 // We jump 🦘
                 frame->ip += offset;
             }
             DISPATCH();
         }
+    label_jump_table:
+        frame->ip = virtual_machine_jump_table(frame->ip, virtual_machine_pop());
+        DISPATCH();
     label_less:
-        BINARY_OP(BOOL_VAL, <);
+        BINARY_OP(BOOL_VAL, BOOL_VAL, <);
         DISPATCH();
     label_loop:
-        frame->ip -= READ_SHORT();
+        frame->ip -= READ_OFFSET();
         DISPATCH();
     label_method:
         virtual_machine_define_method(READ_STRING());
@@ -814,7 +1358,9 @@ static interpret_result virtual_machine_run(void) {
         }
         DISPATCH();
     label_multiply:
-        BINARY_OP(NUMBER_VAL, *);
+        if (!virtual_machine_multiply()) {
+            return INTERPRET_RUNTIME_ERROR;
+        }
         DISPATCH();
     label_negate:
         if (!IS_NUMBER(virtual_machine_peek(0))) {
@@ -823,7 +1369,7 @@ static interpret_result virtual_machine_run(void) {
                                           IS_OBJECT(virtual_machine_peek(0)) ? "object" : "value");
             return INTERPRET_RUNTIME_ERROR;
         }
-        virtual_machine_push(NUMBER_VAL(-AS_NUMBER(virtual_machine_pop())));
+        virtual_machine_push(value_negate(virtual_machine_pop()));
         DISPATCH();
     label_not:
         virtual_machine_push(BOOL_VAL(virtual_machine_is_falsey(virtual_machine_pop())));
@@ -845,6 +1391,10 @@ static interpret_result virtual_machine_run(void) {
             }
             virtualMachine.stackTop = frame->slots;
             virtual_machine_push(result);
+            if (virtualMachine.frameCount == exitFrameCount) {
+                // The function was called by a native function that continues with the result
+                return INTERPRET_OK;
+            }
             frame = &virtualMachine.callStack[virtualMachine.frameCount - 1];
             DISPATCH();
         }
@@ -866,7 +1416,7 @@ static interpret_result virtual_machine_run(void) {
     label_set_local:
         // We set the value at the specified slot to the value that is stored on the top of the stack of the virtual
         // machine.
-        frame->slots[READ_BYTE()] = virtual_machine_peek(0);
+        frame->slots[READ_INDEX()] = virtual_machine_peek(0);
         DISPATCH();
     label_set_property:
         {
@@ -877,7 +1427,7 @@ static interpret_result virtual_machine_run(void) {
                 return INTERPRET_RUNTIME_ERROR;
             }
             // We look up the field in the 'fields' hashtable of the cellox object instance
-            value_hash_table_set(&AS_INSTANCE(virtual_machine_peek(1))->fields, READ_STRING(), virtual_machine_peek(0));
+            virtual_machine_set_field(AS_INSTANCE(virtual_machine_peek(1)), READ_STRING(), virtual_machine_peek(0));
             // The value that is assigned to the property
             value_t value = virtual_machine_pop();
             virtual_machine_pop();
@@ -885,10 +1435,10 @@ static interpret_result virtual_machine_run(void) {
             DISPATCH();
         }
     label_set_upvalue:
-        *frame->closure->upvalues[READ_BYTE()]->location = virtual_machine_peek(0);
+        *frame->closure->upvalues[READ_INDEX()]->location = virtual_machine_peek(0);
         DISPATCH();
     label_subtract:
-        BINARY_OP(NUMBER_VAL, -);
+        BINARY_OP(NUMBER_VAL, value_from_integer, -);
         DISPATCH();
     label_super_invoke:
         {
@@ -906,14 +1456,26 @@ static interpret_result virtual_machine_run(void) {
         DISPATCH();
 // For MSVC and other C-compilers we use a switch statement instead
 #else
-        uint8_t instruction;
-        switch (instruction = READ_BYTE()) {
+        uint8_t instruction = READ_BYTE();
+        extendedArg = 0u;
+        while (instruction == OP_EXTENDED_ARG) {
+            extendedArg = (extendedArg | READ_BYTE()) << 8;
+            instruction = READ_BYTE();
+        }
+        switch (instruction) {
+        case OP_ADD_IN_PLACE:
+            if (IS_ARRAY(virtual_machine_peek(1))) {
+                virtual_machine_append_to_array();
+                break;
+            }
+            // Other values are added like they are added by OP_ADD
+            // fall through
         case OP_ADD:
             {
                 if (IS_STRING(virtual_machine_peek(0)) && IS_STRING(virtual_machine_peek(1))) {
                     virtual_machine_concatenate_strings();
                 } else if (IS_NUMBER(virtual_machine_peek(0)) && IS_NUMBER(virtual_machine_peek(1))) {
-                    BINARY_OP(NUMBER_VAL, +);
+                    BINARY_OP(NUMBER_VAL, value_from_integer, +);
                 } else if (IS_ARRAY(virtual_machine_peek(1))) {
                     virtual_machine_concatenate_arrays();
                 } else {
@@ -925,6 +1487,9 @@ static interpret_result virtual_machine_run(void) {
                 }
                 break;
             }
+        case OP_ARRAY_CONSTANT:
+            virtual_machine_push(OBJECT_VAL(object_new_array_copy(AS_ARRAY(READ_CONSTANT()))));
+            break;
         case OP_ARRAY_LITERAL:
             {
                 virtual_machine_array_literal(READ_BYTE());
@@ -946,7 +1511,7 @@ static interpret_result virtual_machine_run(void) {
                 virtual_machine_push(OBJECT_VAL(closure));
                 for (uint32_t i = 0; i < closure->upvalueCount; i++) {
                     uint8_t isLocal = READ_BYTE();
-                    uint8_t index = READ_BYTE();
+                    uint16_t index = READ_SHORT();
                     closure->upvalues[i] = isLocal ? virtual_machine_capture_upvalue(frame->slots + index)
                                                    : frame->closure->upvalues[index];
                 }
@@ -973,13 +1538,17 @@ static interpret_result virtual_machine_run(void) {
                 break;
             }
         case OP_DIVIDE:
-            BINARY_OP(NUMBER_VAL, /);
+            if (!virtual_machine_divide()) {
+                return INTERPRET_RUNTIME_ERROR;
+            }
             break;
         case OP_EQUAL:
             {
-                value_t a = virtual_machine_pop();
-                value_t b = virtual_machine_pop();
-                virtual_machine_push(BOOL_VAL(value_values_equal(a, b)));
+                // Comparing ropes flattens them, so both values stay on the stack until they are compared
+                bool equal = value_values_equal(virtual_machine_peek(0), virtual_machine_peek(1));
+                virtual_machine_pop();
+                virtual_machine_pop();
+                virtual_machine_push(BOOL_VAL(equal));
                 break;
             }
         case OP_EXPONENT:
@@ -999,6 +1568,19 @@ static interpret_result virtual_machine_run(void) {
         case OP_FALSE:
             virtual_machine_push(BOOL_VAL(false));
             break;
+        case OP_FOR_EACH:
+            {
+                uint32_t offset = READ_OFFSET();
+                uint16_t slot = READ_SHORT();
+                bool exhausted;
+                if (!virtual_machine_iterate(frame->slots + slot, &exhausted)) {
+                    return INTERPRET_RUNTIME_ERROR;
+                }
+                if (exhausted) {
+                    frame->ip += offset;
+                }
+                break;
+            }
         case OP_GET_GLOBAL:
             {
                 object_string_t * name = READ_STRING();
@@ -1019,7 +1601,7 @@ static interpret_result virtual_machine_run(void) {
             }
         case OP_GET_LOCAL:
             {
-                uint8_t slot = READ_BYTE();
+                uint32_t slot = READ_INDEX();
                 virtual_machine_push(frame->slots[slot]);
                 break;
             }
@@ -1065,12 +1647,18 @@ static interpret_result virtual_machine_run(void) {
             }
         case OP_GET_UPVALUE:
             {
-                uint8_t slot = READ_BYTE();
+                uint32_t slot = READ_INDEX();
                 virtual_machine_push(*frame->closure->upvalues[slot]->location);
                 break;
             }
         case OP_GREATER:
-            BINARY_OP(BOOL_VAL, >);
+            BINARY_OP(BOOL_VAL, BOOL_VAL, >);
+            break;
+        case OP_HASH_JUMP:
+            // The subject is popped after the lookup, because hashing a rope flattens it
+            frame->ip = virtual_machine_hash_jump(frame->ip, virtual_machine_peek(0),
+                                                  frame->closure->function->chunk.constants.values);
+            virtual_machine_pop();
             break;
         case OP_INHERIT:
             {
@@ -1083,7 +1671,7 @@ static interpret_result virtual_machine_run(void) {
                     return INTERPRET_RUNTIME_ERROR;
                 }
                 object_class_t * subclass = AS_CLASS(virtual_machine_peek(0));
-                value_hash_table_add_all(&AS_CLASS(superclass)->methods, &subclass->methods);
+                virtual_machine_inherit(AS_CLASS(superclass), subclass);
                 virtual_machine_pop(); // Subclass.
                 break;
             }
@@ -1099,26 +1687,29 @@ static interpret_result virtual_machine_run(void) {
             }
         case OP_JUMP:
             {
-                uint16_t offset = READ_SHORT();
+                uint32_t offset = READ_OFFSET();
                 // We jump 🦘
                 frame->ip += offset;
                 break;
             }
         case OP_JUMP_IF_FALSE:
             {
-                uint16_t offset = READ_SHORT();
+                uint32_t offset = READ_OFFSET();
                 if (virtual_machine_is_falsey(virtual_machine_peek(0))) {
                     // We jump 🦘
                     frame->ip += offset;
                 }
                 break;
             }
+        case OP_JUMP_TABLE:
+            frame->ip = virtual_machine_jump_table(frame->ip, virtual_machine_pop());
+            break;
         case OP_LESS:
-            BINARY_OP(BOOL_VAL, <);
+            BINARY_OP(BOOL_VAL, BOOL_VAL, <);
             break;
         case OP_LOOP:
             {
-                uint16_t offset = READ_SHORT();
+                uint32_t offset = READ_OFFSET();
                 frame->ip -= offset;
                 break;
             }
@@ -1133,7 +1724,9 @@ static interpret_result virtual_machine_run(void) {
                 break;
             }
         case OP_MULTIPLY:
-            BINARY_OP(NUMBER_VAL, *);
+            if (!virtual_machine_multiply()) {
+                return INTERPRET_RUNTIME_ERROR;
+            }
             break;
         case OP_NEGATE:
             if (!IS_NUMBER(virtual_machine_peek(0))) {
@@ -1142,7 +1735,7 @@ static interpret_result virtual_machine_run(void) {
                                               IS_OBJECT(virtual_machine_peek(0)) ? "object" : "value");
                 return INTERPRET_RUNTIME_ERROR;
             }
-            virtual_machine_push(NUMBER_VAL(-AS_NUMBER(virtual_machine_pop())));
+            virtual_machine_push(value_negate(virtual_machine_pop()));
             break;
         case OP_NOT:
             virtual_machine_push(BOOL_VAL(virtual_machine_is_falsey(virtual_machine_pop())));
@@ -1164,6 +1757,10 @@ static interpret_result virtual_machine_run(void) {
                 }
                 virtualMachine.stackTop = frame->slots;
                 virtual_machine_push(result);
+                if (virtualMachine.frameCount == exitFrameCount) {
+                    // The function was called by a native function that continues with the result
+                    return INTERPRET_OK;
+                }
                 frame = &virtualMachine.callStack[virtualMachine.frameCount - 1];
                 break;
             }
@@ -1188,7 +1785,7 @@ static interpret_result virtual_machine_run(void) {
             {
                 // We set the value at the specified slot to the value that is stored on the top of the stack of the
                 // virtual machine.
-                uint8_t slot = READ_BYTE();
+                uint32_t slot = READ_INDEX();
                 frame->slots[slot] = virtual_machine_peek(0);
                 break;
             }
@@ -1201,7 +1798,7 @@ static interpret_result virtual_machine_run(void) {
                     return INTERPRET_RUNTIME_ERROR;
                 }
                 object_instance_t * instance = AS_INSTANCE(virtual_machine_peek(1));
-                value_hash_table_set(&instance->fields, READ_STRING(), virtual_machine_peek(0));
+                virtual_machine_set_field(instance, READ_STRING(), virtual_machine_peek(0));
                 value_t value = virtual_machine_pop();
                 virtual_machine_pop();
                 virtual_machine_push(value);
@@ -1209,12 +1806,12 @@ static interpret_result virtual_machine_run(void) {
             }
         case OP_SET_UPVALUE:
             {
-                uint8_t slot = READ_BYTE();
+                uint32_t slot = READ_INDEX();
                 *frame->closure->upvalues[slot]->location = virtual_machine_peek(0);
                 break;
             }
         case OP_SUBTRACT:
-            BINARY_OP(NUMBER_VAL, -);
+            BINARY_OP(NUMBER_VAL, value_from_integer, -);
             break;
         case OP_SUPER_INVOKE:
             {
@@ -1245,6 +1842,8 @@ static interpret_result virtual_machine_run(void) {
     }
 #undef READ_BYTE
 #undef READ_SHORT
+#undef READ_INDEX
+#undef READ_OFFSET
 #undef READ_CONSTANT
 #undef READ_STRING
 #undef BINARY_OP
@@ -1277,18 +1876,64 @@ static void virtual_machine_runtime_error(char const * format, ...) {
     virtual_machine_reset_stack();
 }
 
+/// @brief Sets the value of a field of an instance
+/// @param instance The instance where the field is set
+/// @param name The name of the field
+/// @param value The new value of the field
+/// @details The class of the instance keeps track of the highest amount of fields its instances have
+static inline void virtual_machine_set_field(object_instance_t * instance, object_string_t * name, value_t value) {
+    if (value_hash_table_set(&instance->fields, name, value) &&
+        instance->fields.count > instance->celloxClass->fieldCount) {
+        instance->celloxClass->fieldCount = instance->fields.count;
+    }
+}
+
 /// @brief Executes a set index of operation
 /// @return A boolean value that indicates whether the execution has led to a runtime error
 static bool virtual_machine_set_index_of(void) {
-    if (IS_ARRAY(virtual_machine_peek(2)) && IS_NUMBER(virtual_machine_peek(1))) {
-        value_t val = virtual_machine_pop();
-        int num = AS_NUMBER(virtual_machine_pop());
-        object_dynamic_value_array_t * array = AS_ARRAY(virtual_machine_pop());
+    if (IS_MAP(virtual_machine_peek(2))) {
+        // The operands stay on the stack, because hashing the key and growing the map might trigger a garbage
+        // collection
+        object_map_t * map = AS_MAP(virtual_machine_peek(2));
+        value_map_set(&map->map, virtual_machine_peek(1), virtual_machine_peek(0));
+        virtual_machine_pop();
+        virtual_machine_pop();
+        virtual_machine_pop();
+        virtual_machine_push(OBJECT_VAL(map));
+    } else if (IS_ARRAY(virtual_machine_peek(2)) && IS_NUMBER(virtual_machine_peek(1))) {
+        value_t val = virtual_machine_peek(0);
+        int num = value_truncate(virtual_machine_peek(1));
+        object_dynamic_value_array_t * array = AS_ARRAY(virtual_machine_peek(2));
         if (num >= array->array.count || num < 0) {
             virtual_machine_runtime_error("accessed array out of bounds at index %d", num);
             return false;
         }
+        // Borrowed values are copied before the array is mutated, the operands stay on the stack in the meantime
+        object_array_prepare_mutation(array);
+        object_array_track_value(array, val);
         array->array.values[num] = val;
+        virtual_machine_pop();
+        virtual_machine_pop();
+        virtual_machine_pop();
+        virtual_machine_push(OBJECT_VAL(array));
+    } else if (IS_TYPED_ARRAY(virtual_machine_peek(2)) && IS_NUMBER(virtual_machine_peek(1))) {
+        int num = value_truncate(virtual_machine_peek(1));
+        object_typed_array_t * array = AS_TYPED_ARRAY(virtual_machine_peek(2));
+        if (num >= (int64_t)array->count || num < 0) {
+            virtual_machine_runtime_error("accessed typed array out of bounds at index %d", num);
+            return false;
+        }
+        if (!IS_NUMBER(virtual_machine_peek(0))) {
+            virtual_machine_runtime_error("Only numbers can be stored in a typed array but tried to store a %s %s",
+                                          value_stringify_type(virtual_machine_peek(0)),
+                                          IS_OBJECT(virtual_machine_peek(0)) ? "object" : "value");
+            return false;
+        }
+        // Typed arrays store unboxed numbers, so the garbage collector does not need to know about the element
+        object_typed_array_set(array, num, AS_NUMBER(virtual_machine_peek(0)));
+        virtual_machine_pop();
+        virtual_machine_pop();
+        virtual_machine_pop();
         virtual_machine_push(OBJECT_VAL(array));
     } else {
         virtual_machine_runtime_error(
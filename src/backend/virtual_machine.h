@@ -27,11 +27,17 @@
 
 /// @brief Maximum amount of frames the virtual machine can hold
 /// @details The maxiimum depth of the callstack
-#define FRAMES_MAX 64
+#define FRAMES_MAX               64
 
 /// @brief Maximum amount values that can be allocated on the stack of the VirtualMachine
-/// @details These are currently 16384 values
-#define STACK_MAX  (FRAMES_MAX * UINT8_COUNT)
+/// @details These are currently 81920 values, so a single function can use all the 65536 local slots it can address
+#define STACK_MAX                (FRAMES_MAX * UINT8_COUNT + UINT16_COUNT)
+
+/// @brief Amount of entries in the method cache of the virtual machine
+#define METHOD_CACHE_SIZE        (1024u)
+
+/// @brief Amount of entries in the bound method cache of the virtual machine
+#define BOUND_METHOD_CACHE_SIZE  (256u)
 
 /// @brief A call frame structure
 /// @details This represents a single ongoing function call
@@ -44,6 +50,30 @@ typedef struct {
     value_t * slots;
 } call_frame_t;
 
+/// @brief An entry in the method cache
+/// @details Maps a class and the name of a method to the slot of the method in the method vector of the class.
+/// The slot of a method never changes after it was defined, so the entries only become invalid if the class or the name
+/// is freed. Because of that the cache is cleared after every garbage collection.
+typedef struct {
+    /// The class the method has been looked up in
+    object_class_t * celloxClass;
+    /// The name of the method
+    object_string_t * name;
+    /// The slot of the method in the method vector of the class
+    uint32_t slot;
+} method_cache_entry_t;
+
+/// @brief An entry in the bound method cache
+/// @details Maps a receiver and a method to the bound method that has been created for them
+typedef struct {
+    /// The receiver the method is bound to
+    value_t receiver;
+    /// The closure of the method
+    object_closure_t * method;
+    /// The bound method that has been created for the receiver and the method
+    object_bound_method_t * bound;
+} bound_method_cache_entry_t;
+
 /// @brief A virtual machine
 /// @details The processbased virtual machine that is used by the cellox compiler is a stackbased virtual machine
 typedef struct {
@@ -66,6 +96,16 @@ typedef struct {
     value_hash_table_t strings;
     /// String "init" used to look up the initializer of a class - reused for every init call
     object_string_t * initString;
+    /// String "iterate" used to advance the cursor of a for-each loop over an instance
+    object_string_t * iterateString;
+    /// String "iteratorValue" used to get the element at the cursor of a for-each loop over an instance
+    object_string_t * iteratorValueString;
+    /// Caches the slots of the methods that have been looked up by a method call or a property access
+    method_cache_entry_t methodCache[METHOD_CACHE_SIZE];
+    /// Caches the bound methods that have been created by a property access
+    bound_method_cache_entry_t boundMethodCache[BOUND_METHOD_CACHE_SIZE];
+    /// Interned strings that consist of a single character, indexed by the character (used for indexing strings)
+    object_string_t * characterStrings[UINT8_COUNT];
     /// Upvalues of the closures of all the functions on the callstack
     object_upvalue_t * openUpvalues;
     /// Number of bytes that have been allocated by the virtualMachine
@@ -106,6 +146,36 @@ interpret_result virtual_machine_interpret(char * program, bool freeProgram);
 
 interpret_result virtual_machine_run_chunk(chunk_t chunk);
 
+/// @brief Reports that the virtual machine has run out of memory and aborts the interpretation of the program
+/// @param requestedBytes The amount of bytes that could not be allocated
+/// @details The interpreter returns to the caller of virtual_machine_interpret / virtual_machine_run_chunk with a
+/// runtime error. If no program is interpreted at the moment, the process is terminated.
+void virtual_machine_out_of_memory(size_t requestedBytes);
+
+/// @brief Reports a runtime error that is raised by a native function and aborts the interpretation of the program
+/// @param format The formater of the error message
+/// @param ... Arguments that are passed in for the formatter
+/// @details Like virtual_machine_out_of_memory the interpreter returns to the caller of virtual_machine_interpret /
+/// virtual_machine_run_chunk with a runtime error
+void virtual_machine_abort(char const * format, ...);
+
+/// @brief Gets the interned string that consists of a single character
+/// @param character The character of the string
+/// @return The string that only contains the character
+/// @details These strings are created when the virtual machine is initialized, so no memory is allocated
+static inline object_string_t * virtual_machine_character_string(char character) {
+    return virtualMachine.characterStrings[(uint8_t)character];
+}
+
+/// @brief Calls a function from a native function and executes it until it returns
+/// @param callee The closure, bound method, class or native function that is called
+/// @param argCount The amount of arguments the function is called with
+/// @param args The arguments the function is called with
+/// @param result Pointer to the value where the result of the call is stored
+/// @return true if the call succeeded, false if a runtime error occured (the error has already been reported)
+/// @details The callee and the arguments are pushed onto the stack, so they are reachable while the function executes
+bool virtual_machine_call_function(value_t callee, uint32_t argCount, value_t const * args, value_t * result);
+
 /// @brief Pushes a new Value on the stack
 /// @param value The value that is pushed on the stack
 void virtual_machine_push(value_t value);
@@ -27,7 +27,10 @@
 
 static void chunk_adjust_line_info_by_index(chunk_t *, uint32_t, int32_t);
 static inline bool chunk_byte_code_is_full(chunk_t *);
+static inline bool chunk_has_constant_operand(uint8_t);
+static inline bool chunk_hash_jump_slot_is_used(chunk_t *, uint32_t);
 static inline bool chunk_line_info_is_full(chunk_t *);
+static void chunk_set_index_operand(chunk_t *, uint32_t, uint32_t, uint32_t);
 
 int32_t chunk_add_constant(chunk_t * chunk, value_t value) {
     virtual_machine_push(value);
@@ -75,68 +78,113 @@ void chunk_remove_constant(chunk_t * chunk, uint32_t constantIndex) {
 }
 
 void chunk_decrement_constant_indezes(chunk_t * chunk, uint32_t startIndex) {
-    for (size_t i = 0; i < chunk->byteCodeCount; i++) {
-        switch (chunk->code[i]) {
-        case OP_CONSTANT:
-            if (chunk->code[i + 1] >= startIndex) {
-                chunk->code[i + 1]--;
+    uint32_t extendedArg = 0u, prefixCount = 0u;
+    for (uint32_t i = 0; i < chunk->byteCodeCount;) {
+        uint32_t length = chunk_instruction_length(chunk, i, extendedArg);
+        if (chunk->code[i] == OP_HASH_JUMP) {
+            // The slots follow the opcode, the default offset and the slot count
+            for (uint32_t slot = i + 7u; slot < i + length; slot += 6u) {
+                uint32_t constant = (uint32_t)(chunk->code[slot] << 8 | chunk->code[slot + 1u]);
+                if (chunk_hash_jump_slot_is_used(chunk, slot) && constant >= startIndex) {
+                    chunk->code[slot] = ((constant - 1u) >> 8) & 0xff;
+                    chunk->code[slot + 1u] = (constant - 1u) & 0xff;
+                }
             }
-        case OP_ARRAY_LITERAL:
-        case OP_CLASS:
-        case OP_DEFINE_GLOBAL:
-        case OP_GET_GLOBAL:
-        case OP_GET_PROPERTY:
-        case OP_GET_SUPER:
-        case OP_METHOD:
-        case OP_SET_GLOBAL:
-        case OP_SET_PROPERTY:
-        case OP_CALL:
-        case OP_GET_LOCAL:
-        case OP_GET_UPVALUE:
-        case OP_SET_LOCAL:
-        case OP_SET_UPVALUE:
-            i++;
-            break;
-        case OP_INVOKE:
-        case OP_JUMP:
-            i += 2;
-            break;
-        default:
-            break;
+        } else if (chunk_has_constant_operand(chunk->code[i]) && (extendedArg | chunk->code[i + 1u]) >= startIndex) {
+            chunk_set_index_operand(chunk, i, prefixCount, (extendedArg | chunk->code[i + 1u]) - 1u);
+        }
+        prefixCount = chunk->code[i] == OP_EXTENDED_ARG ? prefixCount + 1u : 0u;
+        extendedArg = chunk_next_extended_arg(chunk, i, extendedArg);
+        i += length;
+    }
+}
+
+uint32_t chunk_instruction_length(chunk_t * chunk, uint32_t offset, uint32_t extendedArg) {
+    switch (chunk->code[offset]) {
+    case OP_ARRAY_CONSTANT:
+    case OP_ARRAY_LITERAL:
+    case OP_CALL:
+    case OP_CLASS:
+    case OP_CONSTANT:
+    case OP_DEFINE_GLOBAL:
+    case OP_EXTENDED_ARG:
+    case OP_GET_GLOBAL:
+    case OP_GET_LOCAL:
+    case OP_GET_PROPERTY:
+    case OP_GET_SUPER:
+    case OP_GET_UPVALUE:
+    case OP_METHOD:
+    case OP_SET_GLOBAL:
+    case OP_SET_LOCAL:
+    case OP_SET_PROPERTY:
+    case OP_SET_UPVALUE:
+        return 2u;
+    case OP_INVOKE:
+    case OP_JUMP:
+    case OP_JUMP_IF_FALSE:
+    case OP_LOOP:
+    case OP_SUPER_INVOKE:
+        return 3u;
+    case OP_FOR_EACH:
+        return 5u;
+    case OP_CLOSURE:
+        {
+            // Every upvalue of the function is described by a flag and a 16-bit index
+            object_function_t * function = AS_FUNCTION(chunk->constants.values[extendedArg | chunk->code[offset + 1u]]);
+            return 2u + 3u * (uint32_t)function->upvalueCount;
         }
+    case OP_HASH_JUMP:
+    case OP_JUMP_TABLE:
+        return chunk_switch_instruction_length(chunk, offset);
+    default:
+        return 1u;
     }
 }
 
 void chunk_replace_constant_references(chunk_t * chunk, uint32_t oldIndex, uint32_t replacementIndex) {
-    for (size_t i = 0; i < chunk->byteCodeCount; i++) {
-        switch (chunk->code[i]) {
-        case OP_CONSTANT:
-            if (chunk->code[i + 1] == oldIndex) {
-                chunk->code[i + 1] = replacementIndex;
+    uint32_t extendedArg = 0u, prefixCount = 0u;
+    for (uint32_t i = 0; i < chunk->byteCodeCount;) {
+        uint32_t length = chunk_instruction_length(chunk, i, extendedArg);
+        if (chunk->code[i] == OP_HASH_JUMP) {
+            // The slots follow the opcode, the default offset and the slot count
+            for (uint32_t slot = i + 7u; slot < i + length; slot += 6u) {
+                uint32_t constant = (uint32_t)(chunk->code[slot] << 8 | chunk->code[slot + 1u]);
+                if (chunk_hash_jump_slot_is_used(chunk, slot) && constant == oldIndex) {
+                    chunk->code[slot] = (replacementIndex >> 8) & 0xff;
+                    chunk->code[slot + 1u] = replacementIndex & 0xff;
+                }
             }
-        case OP_ARRAY_LITERAL:
-        case OP_CLASS:
-        case OP_DEFINE_GLOBAL:
-        case OP_GET_GLOBAL:
-        case OP_GET_PROPERTY:
-        case OP_GET_SUPER:
-        case OP_METHOD:
-        case OP_SET_GLOBAL:
-        case OP_SET_PROPERTY:
-        case OP_CALL:
-        case OP_GET_LOCAL:
-        case OP_GET_UPVALUE:
-        case OP_SET_LOCAL:
-        case OP_SET_UPVALUE:
-            i++;
-            break;
-        case OP_INVOKE:
-        case OP_JUMP:
-            i += 2;
-            break;
-        default:
+        } else if (chunk_has_constant_operand(chunk->code[i]) && (extendedArg | chunk->code[i + 1u]) == oldIndex) {
+            chunk_set_index_operand(chunk, i, prefixCount, replacementIndex);
+        }
+        prefixCount = chunk->code[i] == OP_EXTENDED_ARG ? prefixCount + 1u : 0u;
+        extendedArg = chunk_next_extended_arg(chunk, i, extendedArg);
+        i += length;
+    }
+}
+
+uint32_t chunk_switch_instruction_length(chunk_t * chunk, uint32_t offset) {
+    uint8_t const * operands = chunk->code + offset + 1;
+    if (chunk->code[offset] == OP_JUMP_TABLE) {
+        uint32_t count = (uint32_t)(operands[8] << 8 | operands[9]);
+        return 11u + 4u * count;
+    }
+    uint32_t slotCount = (uint32_t)(operands[4] << 8 | operands[5]);
+    return 7u + 6u * slotCount;
+}
+
+void chunk_truncate(chunk_t * chunk, uint32_t byteCodeCount, uint32_t constantCount) {
+    chunk->byteCodeCount = byteCodeCount;
+    chunk->constants.count = constantCount;
+    // Line infos that only cover removed instructions are dropped, the last remaining one ends at the new end
+    while (chunk->lineInfoCount) {
+        uint32_t firstIndex =
+            chunk->lineInfoCount > 1u ? chunk->lineInfos[chunk->lineInfoCount - 2u].lastOpCodeIndexInLine + 1u : 0u;
+        if (firstIndex < byteCodeCount) {
+            chunk->lineInfos[chunk->lineInfoCount - 1u].lastOpCodeIndexInLine = byteCodeCount - 1u;
             break;
         }
+        chunk->lineInfoCount--;
     }
 }
 
@@ -195,9 +243,54 @@ static inline bool chunk_byte_code_is_full(chunk_t * chunk) {
     return chunk->byteCodeCapacity < chunk->byteCodeCount + 1;
 }
 
+/// @brief Determines whether the first operand of an instruction is the index of a constant
+/// @param instruction The instruction that is checked
+/// @return true if the first operand is the index of a constant, false if not
+static inline bool chunk_has_constant_operand(uint8_t instruction) {
+    switch (instruction) {
+    case OP_ARRAY_CONSTANT:
+    case OP_CLASS:
+    case OP_CLOSURE:
+    case OP_CONSTANT:
+    case OP_DEFINE_GLOBAL:
+    case OP_GET_GLOBAL:
+    case OP_GET_PROPERTY:
+    case OP_GET_SUPER:
+    case OP_INVOKE:
+    case OP_METHOD:
+    case OP_SET_GLOBAL:
+    case OP_SET_PROPERTY:
+    case OP_SUPER_INVOKE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// @brief Determines whether a slot of the hashtable of a hash jump instruction contains a case label
+/// @param chunk The chunk where the hash jump instruction is stored
+/// @param slot The index of the slot in the chunk
+/// @return true if the slot is used, false if it is empty
+static inline bool chunk_hash_jump_slot_is_used(chunk_t * chunk, uint32_t slot) {
+    // Empty slots have a jump offset of zero
+    return chunk->code[slot + 2u] || chunk->code[slot + 3u] || chunk->code[slot + 4u] || chunk->code[slot + 5u];
+}
+
 /// @brief Determines whether a chunk is completely filled with bytecode instructions
 /// @param chunk The chunk that is checked if it is already filled
 /// @return True if the chunk is full, false if not
 static inline bool chunk_line_info_is_full(chunk_t * chunk) {
     return chunk->lineInfoCapacity < chunk->lineInfoCount + 1;
 }
+
+/// @brief Overwrites the index that is the first operand of an instruction
+/// @param chunk The chunk where the instruction is stored
+/// @param offset The index of the instruction in the chunk
+/// @param prefixCount The amount of OP_EXTENDED_ARG prefixes in front of the instruction
+/// @param index The new index, it has to fit into the operand and the prefixes
+static void chunk_set_index_operand(chunk_t * chunk, uint32_t offset, uint32_t prefixCount, uint32_t index) {
+    chunk->code[offset + 1u] = index & 0xff;
+    for (uint32_t prefix = 1u; prefix <= prefixCount; prefix++) {
+        chunk->code[offset + 1u - 2u * prefix] = (index >> (8u * prefix)) & 0xff;
+    }
+}
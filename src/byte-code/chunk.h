@@ -29,6 +29,11 @@
 enum opcode {
     /// Pops the two most upper values from the stack, adds them and pushes the result onto the stack
     OP_ADD,
+    /// Adds the upper value on the stack to the value below it, arrays are extended in place (compound assignment)
+    OP_ADD_IN_PLACE,
+    /// Pushes a new array that borrows the values of a constant array literal, the values are copied when the array is
+    /// mutated for the first time (copy on write)
+    OP_ARRAY_CONSTANT,
     /// Defines the arguments of the array literal declaration
     OP_ARRAY_LITERAL,
     /// Defines the arguments for the next function invocation
@@ -51,8 +56,13 @@ enum opcode {
     /// Pops the two most upper values from the stack, raises the first with the second value and pushes the result on
     /// the stack
     OP_EXPONENT,
+    /// Supplies the upper bits of the first operand of the next instruction (see chunk_instruction_length)
+    OP_EXTENDED_ARG,
     /// Pushes the boolean value false on the stack
     OP_FALSE,
+    /// Pushes the next element of the collection of a for-each loop on the stack and advances the cursor of the loop,
+    /// jumps to the end of the loop if there are no elements left
+    OP_FOR_EACH,
     /// Gets the value of a global variable and stores it on the stack
     OP_GET_GLOBAL,
     /// Gets the value of a single character in a string at the specified index. Pushes the result on the stack
@@ -71,6 +81,9 @@ enum opcode {
     /// Pops the two most upper values from the stack, and pushes the value true on the stack if the first number is
     /// greater than the second number
     OP_GREATER,
+    /// Pops the subject of a switch statement from the stack and looks it up in the hashtable of case labels that
+    /// follows the instruction, used for sparse and string labels (see chunk_switch_instruction_length)
+    OP_HASH_JUMP,
     /// Adds another class as the parent to a class declaration
     OP_INHERIT,
     /// Invokes a function
@@ -80,6 +93,9 @@ enum opcode {
     OP_JUMP,
     /// Jumps if the value on top of the stack is false
     OP_JUMP_IF_FALSE,
+    /// Pops the subject of a switch statement from the stack and uses it as an index into the table of jump offsets
+    /// that follows the instruction, used for dense integer labels (see chunk_switch_instruction_length)
+    OP_JUMP_TABLE,
     /// Pops the two most upper values from the stack, and pushes the value true on the stack if the first number is
     /// less than the second number
     OP_LESS,
@@ -188,6 +204,58 @@ void chunk_decrement_constant_indezes(chunk_t * chunk, uint32_t startIndex);
 
 void chunk_replace_constant_references(chunk_t * chunk, uint32_t oldIndex, uint32_t replacementIndex);
 
+/// @brief Determines the length of a bytecode instruction including its operands
+/// @param chunk The chunk where the instruction is stored
+/// @param offset The index of the instruction in the chunk
+/// @param extendedArg The upper bits of the first operand that were supplied by the OP_EXTENDED_ARG prefixes in front
+/// of the instruction (zero if there are none)
+/// @return The amount of bytes the instruction occupies
+/** @details An OP_EXTENDED_ARG prefix is an instruction of its own. Every prefix shifts its operand into the upper bits
+ * of the first operand of the next instruction, like the extended argument of CPython. This applies to
+ * <ul>
+ * <li>8-bit indices of constants, local variables and upvalues, one prefix widens them to 16 bits</li>
+ * <li>16-bit jump offsets of OP_FOR_EACH, OP_JUMP, OP_JUMP_IF_FALSE and OP_LOOP, two prefixes widen them to 32
+ * bits</li>
+ * </ul>
+ * The compiler emits every forward jump with two prefixes, because the offset is not known yet, and the optimizer
+ * removes the prefixes that are not needed. OP_FOR_EACH stores the slot of its hidden locals as a 16-bit value after
+ * the jump offset.
+ * The upvalues of OP_CLOSURE are described by a flag that determines whether they capture a local variable (8-bit) and
+ * the 16-bit index of the local variable or the upvalue of the enclosing function.
+ */
+uint32_t chunk_instruction_length(chunk_t * chunk, uint32_t offset, uint32_t extendedArg);
+
+/// @brief Accumulates the operands of OP_EXTENDED_ARG prefixes while the instructions of a chunk are scanned
+/// @param chunk The chunk that is scanned
+/// @param offset The index of the instruction that was scanned
+/// @param extendedArg The upper bits of the first operand of the scanned instruction
+/// @return The upper bits of the first operand of the next instruction
+static inline uint32_t chunk_next_extended_arg(chunk_t const * chunk, uint32_t offset, uint32_t extendedArg) {
+    return chunk->code[offset] == OP_EXTENDED_ARG ? (extendedArg | chunk->code[offset + 1u]) << 8 : 0u;
+}
+
+/// @brief Determines the length of a switch instruction (OP_HASH_JUMP or OP_JUMP_TABLE) including its operands
+/// @param chunk The chunk where the instruction is stored
+/// @param offset The index of the instruction in the chunk
+/// @return The amount of bytes the instruction occupies
+/** @details The operands of both instructions start with the jump offset of the default case. All jump offsets are
+ * unsigned 32-bit values that are subtracted from the address after the instruction, because the case bodies are
+ * compiled in front of it. An offset of zero therefore leaves the switch statement.
+ * <ul>
+ * <li>OP_JUMP_TABLE: default (32-bit), smallest label (signed 32-bit), entry count (16-bit), one offset per entry</li>
+ * <li>OP_HASH_JUMP: default (32-bit), slot count (16-bit, power of two), per slot the constant index of the label
+ * (16-bit) and an offset (zero marks an empty slot)</li>
+ * </ul>
+ * Multi-byte operands are stored in big endian byte order like all other operands.
+ */
+uint32_t chunk_switch_instruction_length(chunk_t * chunk, uint32_t offset);
+
+/// @brief Removes the bytecode instructions and constants that were added last to a chunk
+/// @param chunk The chunk where the instructions and constants are removed
+/// @param byteCodeCount The amount of bytecode instructions that are kept
+/// @param constantCount The amount of constants that are kept
+void chunk_truncate(chunk_t * chunk, uint32_t byteCodeCount, uint32_t constantCount);
+
 /// @brief Writes to a single bytecode instruction to a chunk
 /// @param chunk The chunk where the byte is added
 /// @param byte The value of the byte that is added to the chunk
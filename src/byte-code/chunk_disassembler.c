@@ -27,11 +27,16 @@
 #include "../language-models/object.h"
 #include "../language-models/value.h"
 
-static int32_t chunk_disassembler_byte_instruction(char const *, chunk_t *, int32_t);
-static int32_t chunk_disassembler_constant_instruction(char const *, chunk_t *, int32_t);
-static int chunk_disassembler_invoke_instruction(char const *, chunk_t *, int32_t);
-static int32_t chunk_disassembler_jump_instruction(char const *, int32_t, chunk_t *, int32_t);
+static int32_t chunk_disassembler_byte_instruction(char const *, chunk_t *, int32_t, uint32_t);
+static int32_t chunk_disassembler_closure_instruction(chunk_t *, int32_t, uint32_t);
+static int32_t chunk_disassembler_constant_instruction(char const *, chunk_t *, int32_t, uint32_t);
+static int32_t chunk_disassembler_for_each_instruction(chunk_t *, int32_t, uint32_t);
+static int32_t chunk_disassembler_hash_jump_instruction(chunk_t *, int32_t);
+static int chunk_disassembler_invoke_instruction(char const *, chunk_t *, int32_t, uint32_t);
+static int32_t chunk_disassembler_jump_instruction(char const *, int32_t, chunk_t *, int32_t, uint32_t);
+static int32_t chunk_disassembler_jump_table_instruction(chunk_t *, int32_t);
 static void chunk_disassembler_print_chunk_metadata(chunk_t *, char const *, uint32_t);
+static inline uint32_t chunk_disassembler_read_u32(uint8_t const *);
 static int32_t chunk_disassembler_simple_instruction(char const *, int32_t);
 
 void chunk_disassembler_disassemble_chunk(chunk_t * chunk, char const * name, uint32_t arity) {
@@ -49,39 +54,37 @@ int32_t chunk_disassembler_disassemble_instruction(chunk_t * chunk, int32_t offs
     } else {
         printf("%4d ", chunk_determine_line_by_index(chunk, offset));
     }
+    // The prefixes are shown together with the instruction whose first operand they widen
+    uint32_t extendedArg = 0u;
+    while (chunk->code[offset] == OP_EXTENDED_ARG) {
+        printf("EXTENDED_ARG %02X ", chunk->code[offset + 1]);
+        extendedArg = chunk_next_extended_arg(chunk, offset, extendedArg);
+        offset += 2;
+    }
     // Instruction specific behaviour
     uint8_t instruction = chunk->code[offset];
     printf(" OP_%02X: ", instruction);
     switch (instruction) {
     case OP_ADD:
         return chunk_disassembler_simple_instruction("ADD", offset);
+    case OP_ADD_IN_PLACE:
+        return chunk_disassembler_simple_instruction("ADD_IN_PLACE", offset);
+    case OP_ARRAY_CONSTANT:
+        return chunk_disassembler_constant_instruction("ARRAY_CONSTANT", chunk, offset, extendedArg);
     case OP_ARRAY_LITERAL:
-        return chunk_disassembler_byte_instruction("DYNAMIC_ARRAY_LITERAL", chunk, offset);
+        return chunk_disassembler_byte_instruction("DYNAMIC_ARRAY_LITERAL", chunk, offset, extendedArg);
     case OP_CALL:
-        return chunk_disassembler_byte_instruction("CALL", chunk, offset);
+        return chunk_disassembler_byte_instruction("CALL", chunk, offset, extendedArg);
     case OP_CLASS:
-        return chunk_disassembler_constant_instruction("CLASS", chunk, offset);
+        return chunk_disassembler_constant_instruction("CLASS", chunk, offset, extendedArg);
     case OP_CLOSURE:
-        {
-            offset++;
-            uint8_t constant = chunk->code[offset++];
-            printf("%-16s %04X ", "CLOSURE", constant);
-            value_print(chunk->constants.values[constant]);
-            printf("\n");
-            object_function_t * function = AS_FUNCTION(chunk->constants.values[constant]);
-            for (uint32_t j = 0; j < function->upvalueCount; j++) {
-                int32_t isLocal = chunk->code[offset++];
-                int32_t index = chunk->code[offset++];
-                printf("%04X      |                     %s %d\n", offset - 2, isLocal ? "local" : "upvalue", index);
-            }
-            return offset;
-        }
+        return chunk_disassembler_closure_instruction(chunk, offset, extendedArg);
     case OP_CLOSE_UPVALUE:
         return chunk_disassembler_simple_instruction("CLOSE_UPVALUE", offset);
     case OP_CONSTANT:
-        return chunk_disassembler_constant_instruction("CONSTANT", chunk, offset);
+        return chunk_disassembler_constant_instruction("CONSTANT", chunk, offset, extendedArg);
     case OP_DEFINE_GLOBAL:
-        return chunk_disassembler_constant_instruction("DEFINE_GLOBAL", chunk, offset);
+        return chunk_disassembler_constant_instruction("DEFINE_GLOBAL", chunk, offset, extendedArg);
     case OP_DIVIDE:
         return chunk_disassembler_simple_instruction("DIVIDE", offset);
     case OP_EQUAL:
@@ -90,36 +93,42 @@ int32_t chunk_disassembler_disassemble_instruction(chunk_t * chunk, int32_t offs
         return chunk_disassembler_simple_instruction("EXPONENT", offset);
     case OP_FALSE:
         return chunk_disassembler_simple_instruction("FALSE", offset);
+    case OP_FOR_EACH:
+        return chunk_disassembler_for_each_instruction(chunk, offset, extendedArg);
     case OP_GET_GLOBAL:
-        return chunk_disassembler_constant_instruction("GET_GLOBAL", chunk, offset);
+        return chunk_disassembler_constant_instruction("GET_GLOBAL", chunk, offset, extendedArg);
     case OP_GET_INDEX_OF:
         return chunk_disassembler_simple_instruction("GET_INDEX_OF", offset);
     case OP_GET_LOCAL:
-        return chunk_disassembler_byte_instruction("GET_LOCAL", chunk, offset);
+        return chunk_disassembler_byte_instruction("GET_LOCAL", chunk, offset, extendedArg);
     case OP_GET_PROPERTY:
-        return chunk_disassembler_constant_instruction("GET_PROPERTY", chunk, offset);
+        return chunk_disassembler_constant_instruction("GET_PROPERTY", chunk, offset, extendedArg);
     case OP_GET_SLICE_OF:
         return chunk_disassembler_simple_instruction("GET_RANGE_OF", offset);
     case OP_GET_SUPER:
-        return chunk_disassembler_constant_instruction("GET_SUPER", chunk, offset);
+        return chunk_disassembler_constant_instruction("GET_SUPER", chunk, offset, extendedArg);
     case OP_GET_UPVALUE:
-        return chunk_disassembler_byte_instruction("GET_UPVALUE", chunk, offset);
+        return chunk_disassembler_byte_instruction("GET_UPVALUE", chunk, offset, extendedArg);
     case OP_GREATER:
         return chunk_disassembler_simple_instruction("GREATER", offset);
+    case OP_HASH_JUMP:
+        return chunk_disassembler_hash_jump_instruction(chunk, offset);
     case OP_INHERIT:
         return chunk_disassembler_simple_instruction("INHERIT", offset);
     case OP_INVOKE:
-        return chunk_disassembler_invoke_instruction("INVOKE", chunk, offset);
+        return chunk_disassembler_invoke_instruction("INVOKE", chunk, offset, extendedArg);
     case OP_JUMP:
-        return chunk_disassembler_jump_instruction("JUMP", 1, chunk, offset);
+        return chunk_disassembler_jump_instruction("JUMP", 1, chunk, offset, extendedArg);
     case OP_JUMP_IF_FALSE:
-        return chunk_disassembler_jump_instruction("JUMP_IF_FALSE", 1, chunk, offset);
+        return chunk_disassembler_jump_instruction("JUMP_IF_FALSE", 1, chunk, offset, extendedArg);
+    case OP_JUMP_TABLE:
+        return chunk_disassembler_jump_table_instruction(chunk, offset);
     case OP_LESS:
         return chunk_disassembler_simple_instruction("LESS", offset);
     case OP_LOOP:
-        return chunk_disassembler_jump_instruction("LOOP", -1, chunk, offset);
+        return chunk_disassembler_jump_instruction("LOOP", -1, chunk, offset, extendedArg);
     case OP_METHOD:
-        return chunk_disassembler_constant_instruction("METHOD", chunk, offset);
+        return chunk_disassembler_constant_instruction("METHOD", chunk, offset, extendedArg);
     case OP_MODULO:
         return chunk_disassembler_simple_instruction("MODULO", offset);
     case OP_MULTIPLY:
@@ -135,19 +144,19 @@ int32_t chunk_disassembler_disassemble_instruction(chunk_t * chunk, int32_t offs
     case OP_RETURN:
         return chunk_disassembler_simple_instruction("RETURN", offset);
     case OP_SET_GLOBAL:
-        return chunk_disassembler_constant_instruction("SET_GLOBAL", chunk, offset);
+        return chunk_disassembler_constant_instruction("SET_GLOBAL", chunk, offset, extendedArg);
     case OP_SET_INDEX_OF:
         return chunk_disassembler_simple_instruction("SET INDEX OF", offset);
     case OP_SET_LOCAL:
-        return chunk_disassembler_byte_instruction("SET_LOCAL", chunk, offset);
+        return chunk_disassembler_byte_instruction("SET_LOCAL", chunk, offset, extendedArg);
     case OP_SET_UPVALUE:
-        return chunk_disassembler_byte_instruction("SET_UPVALUE", chunk, offset);
+        return chunk_disassembler_byte_instruction("SET_UPVALUE", chunk, offset, extendedArg);
     case OP_SET_PROPERTY:
-        return chunk_disassembler_constant_instruction("SET_PROPERTY", chunk, offset);
+        return chunk_disassembler_constant_instruction("SET_PROPERTY", chunk, offset, extendedArg);
     case OP_SUBTRACT:
         return chunk_disassembler_simple_instruction("SUBTRACT", offset);
     case OP_SUPER_INVOKE:
-        return chunk_disassembler_invoke_instruction("SUPER_INVOKE", chunk, offset);
+        return chunk_disassembler_invoke_instruction("SUPER_INVOKE", chunk, offset, extendedArg);
     case OP_TRUE:
         return chunk_disassembler_simple_instruction("TRUE", offset);
     default:
@@ -161,29 +170,76 @@ int32_t chunk_disassembler_disassemble_instruction(chunk_t * chunk, int32_t offs
 /// @param chunk The chunk where the local variable is stored
 /// @param offset The offset of the local variable, used for getting the local variable
 /// @return The index of the next bytecode instruction in the chunk
-static int32_t chunk_disassembler_byte_instruction(char const * name, chunk_t * chunk, int32_t offset) {
-    uint8_t slot = *(chunk->code + offset + 1);
+static int32_t chunk_disassembler_byte_instruction(char const * name, chunk_t * chunk, int32_t offset,
+                                                  uint32_t extendedArg) {
+    uint32_t slot = extendedArg | *(chunk->code + offset + 1);
     printf("%-16s %04X\n", name, slot);
     return offset + 2;
 }
 
+/// @brief Dissasembles a closure instruction and the descriptions of the upvalues that are stored in its operands
+static int32_t chunk_disassembler_closure_instruction(chunk_t * chunk, int32_t offset, uint32_t extendedArg) {
+    uint32_t constant = extendedArg | chunk->code[offset + 1];
+    printf("%-16s %04X ", "CLOSURE", constant);
+    value_print(chunk->constants.values[constant]);
+    printf("\n");
+    offset += 2;
+    object_function_t * function = AS_FUNCTION(chunk->constants.values[constant]);
+    for (uint32_t j = 0; j < function->upvalueCount; j++, offset += 3) {
+        int32_t isLocal = chunk->code[offset];
+        int32_t index = chunk->code[offset + 1] << 8 | chunk->code[offset + 2];
+        printf("%04X      |                     %s %d\n", offset, isLocal ? "local" : "upvalue", index);
+    }
+    return offset;
+}
+
 /// @brief Dissasembles a constant instruction - OP_CONSTANT
 /// @param name The name of the constant
 /// @param chunk The chunk where the constant is located
 /// @param offset The offset of the constant
 /// @return The
-static int32_t chunk_disassembler_constant_instruction(char const * name, chunk_t * chunk, int32_t offset) {
-    uint8_t constant = chunk->code[offset + 1];
+static int32_t chunk_disassembler_constant_instruction(char const * name, chunk_t * chunk, int32_t offset,
+                                                      uint32_t extendedArg) {
+    uint32_t constant = extendedArg | chunk->code[offset + 1];
     printf("%-16s %04X '", name, constant);
     value_print(chunk->constants.values[constant]);
     printf("'\n");
     return offset + 2;
 }
 
+/// @brief Dissasembles a for-each instruction
+/// @details The first operand is the jump offset to the end of the loop, followed by the 16-bit slot of the collection
+/// (the cursor is stored in the following slot)
+static int32_t chunk_disassembler_for_each_instruction(chunk_t * chunk, int32_t offset, uint32_t extendedArg) {
+    uint32_t jump = extendedArg << 8 | (uint32_t)(chunk->code[offset + 1] << 8 | chunk->code[offset + 2]);
+    uint16_t slot = (uint16_t)(chunk->code[offset + 3] << 8 | chunk->code[offset + 4]);
+    printf("%-16s %04X %04X -> %04X\n", "FOR_EACH", slot, offset, offset + 5 + jump);
+    return offset + 5;
+}
+
+/// @brief Dissasembles a hash jump instruction and the hashtable of case labels that is stored in its operands
+static int32_t chunk_disassembler_hash_jump_instruction(chunk_t * chunk, int32_t offset) {
+    int32_t end = offset + (int32_t)chunk_switch_instruction_length(chunk, offset);
+    int32_t defaultJump = (int32_t)chunk_disassembler_read_u32(chunk->code + offset + 1);
+    uint16_t slotCount = (uint16_t)(chunk->code[offset + 5] << 8 | chunk->code[offset + 6]);
+    printf("%-16s %04X -> %04X (%d slots)\n", "HASH_JUMP", offset, end - defaultJump, slotCount);
+    for (int32_t slot = offset + 7; slot < end; slot += 6) {
+        int32_t jump = (int32_t)chunk_disassembler_read_u32(chunk->code + slot + 2);
+        if (!jump) {
+            continue;
+        }
+        printf("%04X      |                     '", slot);
+        value_print(chunk->constants.values[chunk->code[slot] << 8 | chunk->code[slot + 1]]);
+        printf("' -> %04X\n", end - jump);
+    }
+    return end;
+}
+
 /// @brief Dissasembles a invoke instruction
 /// @details This can either be a INVOKE or a SUPER_INVOKE Instruction
-static int chunk_disassembler_invoke_instruction(char const * name, chunk_t * chunk, int32_t offset) {
-    uint8_t constant = *(chunk->code + offset + 1);
+static int chunk_disassembler_invoke_instruction(char const * name, chunk_t * chunk, int32_t offset,
+                                                uint32_t extendedArg) {
+    uint32_t constant = extendedArg | *(chunk->code + offset + 1);
     uint8_t argCount = *(chunk->code + offset + 2);
     printf("%-16s (%d args) %04X '", name, argCount, constant);
     value_print(chunk->constants.values[constant]);
@@ -191,14 +247,29 @@ static int chunk_disassembler_invoke_instruction(char const * name, chunk_t * ch
     return offset + 3;
 }
 
-/// Dissasembles a jump instruction (with a 16-bit operand)
-static int32_t chunk_disassembler_jump_instruction(char const * name, int32_t sign, chunk_t * chunk, int32_t offset) {
-    uint16_t jump = (uint16_t)(*(chunk->code + offset + 1) << 8);
+/// Dissasembles a jump instruction (with a 16-bit operand that can be widened by prefixes)
+static int32_t chunk_disassembler_jump_instruction(char const * name, int32_t sign, chunk_t * chunk, int32_t offset,
+                                                  uint32_t extendedArg) {
+    int32_t jump = (int32_t)(extendedArg << 8 | *(chunk->code + offset + 1) << 8);
     jump |= *(chunk->code + offset + 2);
     printf("%-16s %04X -> %04X\n", name, offset, offset + 3 + sign * jump);
     return offset + 3;
 }
 
+/// @brief Dissasembles a jump table instruction and the jump offsets that are stored in its operands
+static int32_t chunk_disassembler_jump_table_instruction(chunk_t * chunk, int32_t offset) {
+    int32_t end = offset + (int32_t)chunk_switch_instruction_length(chunk, offset);
+    int32_t defaultJump = (int32_t)chunk_disassembler_read_u32(chunk->code + offset + 1);
+    int32_t minimum = (int32_t)chunk_disassembler_read_u32(chunk->code + offset + 5);
+    printf("%-16s %04X -> %04X\n", "JUMP_TABLE", offset, end - defaultJump);
+    int32_t entry = 0;
+    for (int32_t slot = offset + 11; slot < end; slot += 4, entry++) {
+        int32_t jump = (int32_t)chunk_disassembler_read_u32(chunk->code + slot);
+        printf("%04X      |                     %d -> %04X\n", slot, minimum + entry, end - jump);
+    }
+    return end;
+}
+
 /// @brief Provides additional metadata to a chunk and prints it to the stdandard output
 /// @param chunk The chunk that is examined
 /// @param name The name of the top level function of the chunk
@@ -220,46 +291,16 @@ static void chunk_disassembler_print_chunk_metadata(chunk_t * chunk, char const
             numberCount++;
         }
     }
-    for (uint32_t j = 0; j < chunk->byteCodeCount; j++) {
-        switch (chunk->code[j]) {
-        case OP_CONSTANT:
-            if (j + 1 == chunk->byteCodeCount) {
-                break;
-            }
-            if (IS_STRING(chunk->constants.values[chunk->code[j + 1]])) {
-                stringCount++;
-            }
-            break;
-        case OP_CLASS:
-            if (j + 1 == chunk->byteCodeCount) {
-                break;
-            }
-            if (IS_STRING(chunk->constants.values[chunk->code[j + 1]])) {
-                classCount++;
-            }
-        case OP_ARRAY_LITERAL:
-        case OP_DEFINE_GLOBAL:
-        case OP_GET_GLOBAL:
-        case OP_GET_PROPERTY:
-        case OP_GET_SUPER:
-        case OP_METHOD:
-        case OP_SET_GLOBAL:
-        case OP_SET_PROPERTY:
-        case OP_CALL:
-        case OP_GET_LOCAL:
-        case OP_GET_UPVALUE:
-        case OP_SET_LOCAL:
-        case OP_SET_UPVALUE:
-            j++;
-            break;
-        case OP_INVOKE:
-        case OP_JUMP:
-            j += 2;
-            break;
-
-        default:
-            break;
+    uint32_t extendedArg = 0u;
+    for (uint32_t j = 0; j < chunk->byteCodeCount;) {
+        uint32_t length = chunk_instruction_length(chunk, j, extendedArg);
+        if (chunk->code[j] == OP_CONSTANT && IS_STRING(chunk->constants.values[extendedArg | chunk->code[j + 1]])) {
+            stringCount++;
+        } else if (chunk->code[j] == OP_CLASS && IS_STRING(chunk->constants.values[extendedArg | chunk->code[j + 1]])) {
+            classCount++;
         }
+        extendedArg = chunk_next_extended_arg(chunk, j, extendedArg);
+        j += length;
     }
 
     printf("%i %s, %i %s, %i %s, %i %s, %i %s\n", arity, arity == 1 ? "param" : "params", stringCount,
@@ -268,6 +309,13 @@ static void chunk_disassembler_print_chunk_metadata(chunk_t * chunk, char const
            functionCount == 1 ? "function" : "functions", classCount, classCount == 1 ? "class" : "classes");
 }
 
+/// @brief Reads a big endian unsigned 32-bit integer operand
+/// @param code Pointer to the first byte of the operand
+/// @return The value of the operand
+static inline uint32_t chunk_disassembler_read_u32(uint8_t const * code) {
+    return (uint32_t)code[0] << 24 | (uint32_t)code[1] << 16 | (uint32_t)code[2] << 8 | code[3];
+}
+
 /// Dissasembles a simple instruction
 static int32_t chunk_disassembler_simple_instruction(char const * name, int32_t offset) {
     printf("%s\n", name);
@@ -26,6 +26,7 @@
 
 #include "cellox_config.h"
 
+#include "../backend/virtual_machine.h"
 #include "../language-models/object.h"
 
 /// @brief Chunk segment prefixes
@@ -46,7 +47,11 @@ enum constant_type_prefix {
     /// Prefix of a numerical constant
     CONSTANT_TYPE_NUMBER,
     /// Prefix of a string constant
-    CONSTANT_TYPE_STRING
+    CONSTANT_TYPE_STRING,
+    /// Prefix of a constant array literal, followed by the amount of elements and the elements
+    CONSTANT_TYPE_ARRAY,
+    /// Placeholder of a function constant, the function itself is stored in the inner segment
+    CONSTANT_TYPE_FUNCTION
 };
 
 static void chunk_file_append_chunk(chunk_t, chunk_file_compile_flag, FILE *);
@@ -63,7 +68,7 @@ static void chunk_file_append_u32(uint32_t, FILE *);
 static void chunk_file_append_u64(uint64_t, FILE *);
 static void chunk_file_parse_chunk(char const **, chunk_t *, size_t *, size_t);
 static void chunk_file_parse_code(char const **, chunk_t *, size_t *, size_t);
-static void chunk_file_parse_constant(char const **, chunk_t *, size_t *, size_t);
+static value_t chunk_file_parse_constant(char const **, chunk_t *, size_t *, size_t);
 static void chunk_file_parse_constants(char const **, chunk_t *, size_t *, size_t);
 static void chunk_file_parse_file(char const *, chunk_t *, size_t *, size_t);
 static void chunk_file_parse_inner(char const **, chunk_t *, size_t *, size_t);
@@ -137,6 +142,7 @@ static void chunk_file_append_chunk(chunk_t chunk, chunk_file_compile_flag flag,
     if (functions.count) {
         chunk_file_append_inner_segment(functions, flag, filePointer);
     }
+    dynamic_value_array_free(&functions);
     chunk_file_append_code_segment(chunk.code, chunk.byteCodeCount, filePointer);
 }
 
@@ -162,7 +168,16 @@ static void chunk_file_append_constant(value_t value, dynamic_value_array_t * fu
                                        FILE * filePointer) {
     if (IS_OBJECT(value)) {
         switch (OBJECT_TYPE(value)) {
+        case OBJECT_ARRAY:
+            fputc(CONSTANT_TYPE_ARRAY, filePointer);
+            chunk_file_append_u32(AS_ARRAY(value)->array.count, filePointer);
+            for (uint32_t i = 0; i < AS_ARRAY(value)->array.count; i++) {
+                chunk_file_append_constant(AS_ARRAY(value)->array.values[i], functions, flag, filePointer);
+            }
+            break;
         case OBJECT_FUNCTION:
+            // Only a placeholder is written, so the indices of the following constants are preserved
+            fputc(CONSTANT_TYPE_FUNCTION, filePointer);
             dynamic_value_array_write(functions, value);
             break;
         case OBJECT_STRING:
@@ -176,8 +191,12 @@ static void chunk_file_append_constant(value_t value, dynamic_value_array_t * fu
         }
     } else // Numbers
     {
+        // The bits of the double are stored, so negative and fractional numbers are preserved
+        double number = AS_NUMBER(value);
+        uint64_t bits;
+        memcpy(&bits, &number, sizeof(bits));
         fputc(CONSTANT_TYPE_NUMBER, filePointer);
-        chunk_file_append_u64(AS_NUMBER(value), filePointer);
+        chunk_file_append_u64(bits, filePointer);
     }
 }
 
@@ -193,14 +212,7 @@ static void chunk_file_append_constant_segment(dynamic_value_array_t constants,
         return;
     }
     fputc(CHUNK_SEGMENT_TYPE_CONSTANTS, filePointer);
-    uint32_t constantsCounter = constants.count;
-    for (size_t i = 0; i < constants.count; i++) {
-        if (IS_FUNCTION(constants.values[i])) {
-            constantsCounter--;
-        }
-    }
-
-    chunk_file_append_u32(constantsCounter, filePointer);
+    chunk_file_append_u32(constants.count, filePointer);
     for (size_t i = 0; i < constants.count; i++) {
         chunk_file_append_constant(constants.values[i], functions, flag, filePointer);
     }
@@ -327,14 +339,17 @@ static void chunk_file_parse_code(char const ** fileContent, chunk_t * result, s
     if (!codeCount) {
         return;
     }
-    uint32_t codeAbsoluteSize = fileSize - *bytesReadPointer;
-    result->code = malloc(sizeof(uint8_t) * codeAbsoluteSize);
+    // Only the code of this chunk is read, the code of an inner function is followed by the rest of its parent
+    if (codeCount > fileSize - *bytesReadPointer) {
+        chunk_file_error("Unexpected file ending");
+    }
+    result->code = malloc(sizeof(uint8_t) * codeCount);
     if (!result->code) {
         chunk_file_error("Could not create line info");
     }
     result->byteCodeCapacity = codeCount;
     result->byteCodeCount = codeCount;
-    for (uint32_t i = 0; i < codeAbsoluteSize; i++, (*bytesReadPointer)++) {
+    for (uint32_t i = 0; i < codeCount; i++, (*bytesReadPointer)++) {
         result->code[i] = *(*fileContent)++;
     }
 }
@@ -344,33 +359,52 @@ static void chunk_file_parse_code(char const ** fileContent, chunk_t * result, s
 /// @param result The resulting chunk of the parsing process
 /// @param bytesReadPointer Pointer to the bytes read counter
 /// @param fileSize The size of the file in bytes
-static void chunk_file_parse_constant(char const ** fileContent, chunk_t * result, size_t * bytesReadPointer,
-                                      size_t fileSize) {
+/// @return The value of the constant
+static value_t chunk_file_parse_constant(char const ** fileContent, chunk_t * result, size_t * bytesReadPointer,
+                                         size_t fileSize) {
     if (*bytesReadPointer > fileSize) {
         chunk_file_error("Unexpected file ending");
     }
     switch (*(*fileContent)++) {
     case CONSTANT_TYPE_NUMBER:
-        dynamic_value_array_write(&result->constants,
-                                  NUMBER_VAL(chunk_file_parse_u64(fileContent, result, bytesReadPointer, fileSize)));
-        break;
+        {
+            uint64_t bits = chunk_file_parse_u64(fileContent, result, bytesReadPointer, fileSize);
+            double number;
+            memcpy(&number, &bits, sizeof(number));
+            return value_from_number(number);
+        }
     case CONSTANT_TYPE_STRING:
         {
             size_t stringLength = strlen(*fileContent);
             if (*bytesReadPointer > fileSize - stringLength) {
                 chunk_file_error("Unexpected file ending");
             }
-            char * stringLiteral = malloc(stringLength + 1);
-            strcpy(stringLiteral, *fileContent);
-            stringLiteral[stringLength] = '\0';
-            dynamic_value_array_write(&result->constants, OBJECT_VAL(object_take_string(stringLiteral, stringLength)));
+            value_t string = OBJECT_VAL(object_copy_string(*fileContent, stringLength, false));
             *fileContent += stringLength + 1;
             *bytesReadPointer += stringLength + 2;
-            break;
+            return string;
         }
-
+    case CONSTANT_TYPE_ARRAY:
+        {
+            uint32_t count = chunk_file_parse_u32(fileContent, result, bytesReadPointer, fileSize);
+            object_dynamic_value_array_t * array = object_new_dynamic_value_array();
+            // The array is kept on the stack while its elements are parsed, so it is not collected
+            virtual_machine_push(OBJECT_VAL(array));
+            for (uint32_t i = 0; i < count; i++) {
+                value_t element = chunk_file_parse_constant(fileContent, result, bytesReadPointer, fileSize);
+                object_array_write(array, element);
+            }
+            virtual_machine_pop();
+            (*bytesReadPointer)++;
+            return OBJECT_VAL(array);
+        }
+    case CONSTANT_TYPE_FUNCTION:
+        // Replaced by the function when the inner segment is parsed
+        (*bytesReadPointer)++;
+        return NULL_VAL;
     default:
         chunk_file_error("Unknown constant type");
+        return NULL_VAL;
     }
 }
 
@@ -384,7 +418,8 @@ static void chunk_file_parse_constants(char const ** fileContent, chunk_t * resu
     uint32_t constantCounter = chunk_file_parse_u32(fileContent, result, bytesReadPointer, fileSize);
     dynamic_value_array_init(&result->constants);
     for (uint32_t i = 0; i < constantCounter; i++) {
-        chunk_file_parse_constant(fileContent, result, bytesReadPointer, fileSize);
+        dynamic_value_array_write(&result->constants,
+                                  chunk_file_parse_constant(fileContent, result, bytesReadPointer, fileSize));
     }
 }
 
@@ -410,22 +445,27 @@ static void chunk_file_parse_file(char const * fileContent, chunk_t * result, si
 static void chunk_file_parse_inner(char const ** fileContent, chunk_t * result, size_t * bytesReadPointer,
                                    size_t fileSize) {
     uint32_t innerCounter = chunk_file_parse_u32(fileContent, result, bytesReadPointer, fileSize);
+    uint32_t constantIndex = 0;
     for (size_t i = 0; i < innerCounter; i++) {
         size_t functionNameLength = strlen(*fileContent);
         if (*bytesReadPointer > fileSize - functionNameLength) {
             chunk_file_error("Unexpected file ending");
         }
         object_function_t * function = object_new_function();
-        char * functionName = malloc(functionNameLength + 1);
-        memcpy(functionName, (*fileContent), functionNameLength);
-        functionName[functionNameLength] = '\0';
-        function->name = object_take_string(functionName, functionNameLength);
+        function->name = object_copy_string(*fileContent, functionNameLength, false);
         *fileContent += functionNameLength + 1;
         *bytesReadPointer += functionNameLength + 2;
         function->arity = chunk_file_parse_u32(fileContent, result, bytesReadPointer, fileSize);
         function->upvalueCount = chunk_file_parse_u32(fileContent, result, bytesReadPointer, fileSize);
         chunk_file_parse_chunk(fileContent, &function->chunk, bytesReadPointer, fileSize);
-        dynamic_value_array_write(&result->constants, OBJECT_VAL(function));
+        // The functions are stored in the order of their placeholders in the constants segment
+        while (constantIndex < result->constants.count && !IS_NULL(result->constants.values[constantIndex])) {
+            constantIndex++;
+        }
+        if (constantIndex == result->constants.count) {
+            chunk_file_error("Function without a placeholder in the constants segment");
+        }
+        result->constants.values[constantIndex++] = OBJECT_VAL(function);
     }
 }
 
@@ -481,7 +521,7 @@ static uint32_t chunk_file_parse_u32(char const ** fileContent, chunk_t * result
     }
     uint32_t number = 0;
     for (int i = 0; i < 4; i++) {
-        number |= *(*fileContent)++ << (24 - 8 * i);
+        number |= (uint32_t)(uint8_t) * (*fileContent)++ << (24 - 8 * i);
     }
     (*bytesReadPointer) += 4;
     return number;
@@ -500,7 +540,7 @@ static uint64_t chunk_file_parse_u64(char const ** fileContent, chunk_t * result
     }
     uint64_t number = 0;
     for (int i = 0; i < 8; i++) {
-        number |= ((uint64_t) * (*fileContent)++) << (56 - 8 * i);
+        number |= ((uint64_t)(uint8_t) * (*fileContent)++) << (56 - 8 * i);
     }
     (*bytesReadPointer) += 8;
     return number;
@@ -26,6 +26,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "backend/garbage_collector_policy.h"
 #include "common.h"
 #include "initializer.h"
 
@@ -64,14 +65,24 @@ static command_line_option_type_config_t optionConfigs[] = {
         .shortRepresentation = "-v", .longRepresentation = "--version", .exclusionaryOption = true}};
 
 static void command_line_argument_parser_error(char const *, ...);
+static inline bool command_line_argument_parser_is_garbage_collector_setting(char const *);
 static inline bool command_line_argument_parser_is_option(char const *);
 static void command_line_argument_parser_parse_option(char const *, command_line_option_type *);
 static inline void command_line_argument_parser_show_usage(void);
 
 void command_line_argument_parser_parse(int argc, char const ** argv) {
     command_line_option_type currentOption = OPTION_NO_OPTION;
+    // Settings of the garbage collector that are specified as arguments override the environment variables
+    char const * invalidEnvironmentVariable = garbage_collector_policy_load_environment();
+    if (invalidEnvironmentVariable) {
+        command_line_argument_parser_error("Invalid value for the environment variable %s", invalidEnvironmentVariable);
+    }
     for (int i = 1; i < argc; i++) {
-        if (command_line_argument_parser_is_option(argv[i])) {
+        if (command_line_argument_parser_is_garbage_collector_setting(argv[i])) {
+            if (!garbage_collector_policy_set_from_argument(argv[i])) {
+                command_line_argument_parser_error("Invalid garbage collector setting %s", argv[i]);
+            }
+        } else if (command_line_argument_parser_is_option(argv[i])) {
             command_line_argument_parser_parse_option(argv[i], &currentOption);
         } else {
             // Only a single argument is supported at the moment
@@ -118,6 +129,14 @@ static void command_line_argument_parser_error(char const * format, ...) {
     exit(EXIT_CODE_COMMAND_LINE_USAGE_ERROR);
 }
 
+/// @brief Determines whether the argument is a setting of the garbage collector
+/// @param argument The argument that is checked
+/// @return true if it is a setting of the garbage collector, false if not
+static inline bool command_line_argument_parser_is_garbage_collector_setting(char const * argument) {
+    return !strncmp(argument, GARBAGE_COLLECTOR_POLICY_ARGUMENT_PREFIX,
+                    strlen(GARBAGE_COLLECTOR_POLICY_ARGUMENT_PREFIX));
+}
+
 /// @brief Determines whether the argument is an option
 /// @param argument The argument that is checked
 /// @return true if it is an option, false if not
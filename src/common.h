@@ -47,7 +47,10 @@ typedef enum {
 // Typedefs for exact-width-integer types from the C99 standard
 #include <stdint.h>
 
-/// Maximum number of values in a dynamic array of upvalues or locals
-#define UINT8_COUNT (256)
+/// Number of values that can be addressed by an unsigned 8-bit operand
+#define UINT8_COUNT  (256)
+
+/// Maximum number of constants, locals or upvalues of a function, their indices are widened to 16 bits by a prefix
+#define UINT16_COUNT (65536)
 
 #endif // CELLOX_COMMON_H_
@@ -102,7 +102,7 @@ typedef struct {
 /// @brief An upvalue structure
 typedef struct {
     /// Index of the upvalue
-    uint8_t index;
+    uint16_t index;
     /// Flag that indicates whether the value is a local value
     bool isLocal;
 } upvalue_t;
@@ -130,11 +130,15 @@ typedef struct compiler_t {
     /// @brief The type of the function that is currently executed
     function_type type;
     /// @brief The locals that were declared in the current scope
-    local_t locals[UINT8_COUNT];
+    local_t * locals;
     // @brief The amount of local values that where declared in the current scope
     int32_t localCount;
+    /// @brief The amount of locals the array can hold before it is grown
+    uint32_t localCapacity;
     /// @brief The upvalues of the current scope (part of a closure)
-    upvalue_t upvalues[UINT8_COUNT];
+    upvalue_t * upvalues;
+    /// @brief The amount of upvalues the array can hold before it is grown
+    uint32_t upvalueCapacity;
     /// @brief The scopedepth
     /// @details Used to determine whether a declared variable is a global or a local variable
     int32_t scopeDepth;
@@ -149,6 +153,16 @@ typedef struct class_compiler_t {
     bool hasSuperclass;
 } class_compiler_t;
 
+/// @brief A case label of a switch statement
+typedef struct {
+    /// The value of the label
+    value_t value;
+    /// Index of the first instruction of the body that belongs to the label
+    int32_t bodyStart;
+    /// Index of the constant that stores the label (-1 if it has not been stored yet)
+    int32_t constant;
+} switch_case_t;
+
 /// @brief Global parser variable
 parser_t parser;
 
@@ -160,7 +174,7 @@ compiler_t * current = NULL;
 class_compiler_t * currentClass = NULL;
 
 static void compiler_add_local(token_t);
-static uint32_t compiler_add_upvalue(compiler_t *, uint8_t, bool);
+static uint32_t compiler_add_upvalue(compiler_t *, uint16_t, bool);
 static void compiler_advance(void);
 static void compiler_and(bool);
 static uint8_t compiler_argument_list(void);
@@ -169,13 +183,15 @@ static void compiler_binary(bool);
 static inline void compiler_binary_number(bool);
 static void compiler_block(void);
 static inline void compiler_call(bool);
+static void compiler_case_label(switch_case_t *, uint32_t *, int32_t);
 static inline bool compiler_check(tokentype);
 static void compiler_class_declaration();
+static bool compiler_constant_array(uint32_t, uint32_t, uint8_t);
 static void compiler_consume(tokentype, char const *);
 static inline chunk_t * compiler_current_chunk(void);
 static void compiler_declaration(void);
 static void compiler_declare_variable(void);
-static void compiler_define_variable(uint8_t);
+static void compiler_define_variable(uint32_t);
 static void compiler_do_while_statement(void);
 static void compiler_dot(bool);
 static void compiler_dynamic_array(bool);
@@ -183,38 +199,44 @@ static uint8_t compiler_dynamic_array_argument_list(void);
 static void compiler_emit_byte(uint8_t);
 static void compiler_emit_bytes(uint8_t, uint8_t);
 static inline void compiler_emit_constant(value_t);
+static void compiler_emit_hash_jump(switch_case_t *, uint32_t, int32_t);
+static void compiler_emit_index_instruction(uint8_t, uint32_t);
 static int32_t compiler_emit_jump(uint8_t);
+static void compiler_emit_jump_table(switch_case_t *, uint32_t, int32_t, int32_t);
 static void compiler_emit_loop(int32_t);
 static void compiler_emit_return(void);
+static void compiler_emit_switch_offset(int32_t, int32_t);
 static object_function_t * compiler_end(void);
 static void compiler_end_scope(void);
 static inline void compiler_error(char const *, ...);
 static void compiler_error_at(token_t *, char const *, ...);
 static void compiler_error_at_current(char const *, ...);
 static void compiler_expression();
+static void compiler_free(compiler_t *);
 static void compiler_expression_statement(void);
+static void compiler_for_each_statement(token_t);
 static void compiler_for_statement(void);
 static void compiler_function(function_type);
 static void compiler_function_declaration();
 static inline parse_rule_t * compiler_get_rule(tokentype);
 static void compiler_grouping(bool);
 static inline void compiler_hex_number(bool);
-static uint8_t compiler_identifier_constant(token_t *);
+static uint32_t compiler_identifier_constant(token_t *);
 static bool compiler_identifiers_equal(token_t *, token_t *);
 static void compiler_if_statement();
 static void compiler_init(compiler_t *, function_type);
 static void compiler_index_of(bool, uint8_t, uint32_t);
 static void compiler_literal(bool);
 static void compiler_mark_initialized(void);
-static uint8_t compiler_make_constant(value_t);
+static uint32_t compiler_make_constant(value_t);
 static bool compiler_match_token(tokentype);
 static void compiler_method(void);
 static void compiler_named_variable(token_t, bool);
-static void compiler_nondirect_assignment(uint8_t, uint8_t, uint8_t, uint8_t);
+static void compiler_nondirect_assignment(uint8_t, uint8_t, uint8_t, uint32_t);
 static inline void compiler_number(bool);
 static void compiler_or(bool);
 static void compiler_parse_precedence(precedence);
-static uint8_t compiler_parse_variable(char const *);
+static uint32_t compiler_parse_variable(char const *);
 static void compiler_patch_jump(int32_t);
 static int32_t compiler_resolve_local(compiler_t *, token_t *);
 static int32_t compiler_resolve_upvalue(compiler_t *, token_t *);
@@ -222,11 +244,13 @@ static void compiler_return_statement();
 static void compiler_statement(void);
 static void compiler_string(bool);
 static void compiler_super(bool);
+static void compiler_switch_statement(void);
 static void compiler_synchronize(void);
 static token_t compiler_synthetic_token(char const *);
 static void compiler_this(bool);
 static void compiler_unary(bool);
 static void compiler_var_declaration(void);
+static void compiler_var_initializer(uint32_t);
 static inline void compiler_variable(bool);
 static void compiler_while_statement(void);
 
@@ -236,8 +260,10 @@ static parse_rule_t rules[] = {
     [TOKEN_BANG] = {.prefix = compiler_unary, .infix = NULL, .precedence = PREC_UNARY},
     [TOKEN_BANG_EQUAL] = {.prefix = NULL, .infix = compiler_binary, .precedence = PREC_EQUALITY},
     [TOKEN_BINARY_NUMBER] = {.prefix = compiler_binary_number, .infix = NULL, .precedence = PREC_NONE},
+    [TOKEN_CASE] = {.prefix = NULL, .infix = NULL, .precedence = PREC_NONE},
     [TOKEN_CLASS] = {.prefix = NULL, .infix = NULL, .precedence = PREC_NONE},
     [TOKEN_COMMA] = {.prefix = NULL, .infix = NULL, .precedence = PREC_NONE},
+    [TOKEN_DEFAULT] = {.prefix = NULL, .infix = NULL, .precedence = PREC_NONE},
     [TOKEN_DO] = {.prefix = NULL, .infix = NULL, .precedence = PREC_NONE},
     [TOKEN_DOT] = {.prefix = NULL, .infix = compiler_dot, .precedence = PREC_CALL},
     [TOKEN_EOF] = {.prefix = NULL, .infix = NULL, .precedence = PREC_NONE},
@@ -281,6 +307,7 @@ static parse_rule_t rules[] = {
     [TOKEN_STAR_STAR] = {.prefix = NULL, .infix = compiler_binary, .precedence = PREC_FACTOR},
     [TOKEN_STRING] = {.prefix = compiler_string, .infix = NULL, .precedence = PREC_NONE},
     [TOKEN_SUPER] = {.prefix = compiler_super, .infix = NULL, .precedence = PREC_NONE},
+    [TOKEN_SWITCH] = {.prefix = NULL, .infix = NULL, .precedence = PREC_NONE},
     [TOKEN_THIS] = {.prefix = compiler_this, .infix = NULL, .precedence = PREC_NONE},
     [TOKEN_TRUE] = {.prefix = compiler_literal, .infix = NULL, .precedence = PREC_NONE},
     [TOKEN_VAR] = {.prefix = NULL, .infix = NULL, .precedence = PREC_NONE},
@@ -298,6 +325,7 @@ object_function_t * compiler_compile(char const * program) {
         compiler_declaration();
     }
     object_function_t * function = compiler_end();
+    compiler_free(&compiler);
     return parser.hadError ? NULL : function;
 }
 
@@ -309,13 +337,23 @@ void compiler_mark_roots(void) {
     }
 }
 
+void compiler_reset(void) {
+    current = NULL;
+    currentClass = NULL;
+}
+
 /// Adds a new local variable to the stack
 static void compiler_add_local(token_t name) {
-    if (current->localCount == UINT8_COUNT) {
-        // We can only have 255 local variable on the stack 😔
+    if (current->localCount == UINT16_COUNT) {
+        // The index of a local variable can be widened to 16 bits, but not further 😔
         compiler_error("Too many local variables in function.");
         return;
     }
+    if (current->localCapacity < (uint32_t)current->localCount + 1u) {
+        uint32_t oldCapacity = current->localCapacity;
+        current->localCapacity = GROW_CAPACITY(oldCapacity);
+        current->locals = GROW_ARRAY(local_t, current->locals, oldCapacity, current->localCapacity);
+    }
     local_t * local = &current->locals[current->localCount++];
     local->name = name;
     local->depth = -1;
@@ -327,7 +365,7 @@ static void compiler_add_local(token_t name) {
 /// @param index The index of the upvalue
 /// @param isLocal A boolean value that indicates whether the upvalue comes from a local variable
 /// @return The index of the upvalue
-static uint32_t compiler_add_upvalue(compiler_t * compiler, uint8_t index, bool isLocal) {
+static uint32_t compiler_add_upvalue(compiler_t * compiler, uint16_t index, bool isLocal) {
     uint32_t upvalueCount = compiler->function->upvalueCount;
 
     for (uint32_t i = 0; i < upvalueCount; i++) {
@@ -336,10 +374,15 @@ static uint32_t compiler_add_upvalue(compiler_t * compiler, uint8_t index, bool
             return i;
         }
     }
-    if (upvalueCount == UINT8_COUNT) {
+    if (upvalueCount == UINT16_COUNT) {
         compiler_error("Too many closure variables in function.");
         return 0;
     }
+    if (compiler->upvalueCapacity < upvalueCount + 1u) {
+        uint32_t oldCapacity = compiler->upvalueCapacity;
+        compiler->upvalueCapacity = GROW_CAPACITY(oldCapacity);
+        compiler->upvalues = GROW_ARRAY(upvalue_t, compiler->upvalues, oldCapacity, compiler->upvalueCapacity);
+    }
 
     compiler->upvalues[upvalueCount].isLocal = isLocal;
     compiler->upvalues[upvalueCount].index = index;
@@ -447,7 +490,7 @@ static void compiler_binary(bool canAssign) {
 /// @param canAssign  Unused for binary number literal expressions
 static inline void compiler_binary_number(bool canAssign) {
     double value = strtol(parser.previous.start + 2, NULL, 2);
-    compiler_emit_constant(NUMBER_VAL(value));
+    compiler_emit_constant(value_from_number(value));
 }
 
 /// @brief Compiles a block statement to bytecode instructions
@@ -467,6 +510,62 @@ static inline void compiler_call(bool canAssign) {
     compiler_emit_bytes(OP_CALL, argCount);
 }
 
+/// @brief Compiles the label of a case in a switch statement
+/// @param cases The labels of the switch statement that have been compiled so far
+/// @param caseCount Pointer to the amount of labels that have been compiled so far
+/// @param bodyStart Index of the first instruction of the body that belongs to the label
+/// @details A label is a number literal, that can be negated, or a string literal. String labels are stored as
+/// constants right away, number labels are only stored if the switch statement is compiled to a hash jump.
+static void compiler_case_label(switch_case_t * cases, uint32_t * caseCount, int32_t bodyStart) {
+    bool negate = compiler_match_token(TOKEN_MINUS);
+    value_t value;
+    int32_t constant = -1;
+    switch (parser.current.type) {
+    case TOKEN_BINARY_NUMBER:
+        value = value_from_number((negate ? -1 : 1) * (double)strtol(parser.current.start + 2, NULL, 2));
+        break;
+    case TOKEN_HEX_NUMBER:
+        value = value_from_number((negate ? -1 : 1) * (double)strtol(parser.current.start + 2, NULL, 16));
+        break;
+    case TOKEN_NUMBER:
+        value = value_from_number((negate ? -1 : 1) * strtod(parser.current.start, NULL));
+        break;
+    case TOKEN_STRING:
+        {
+            if (negate) {
+                compiler_error_at_current("Can't negate a string case label.");
+                return;
+            }
+            object_string_t * string = object_copy_string(parser.current.start + 1, parser.current.length - 2, true);
+            if (!string) {
+                compiler_error_at_current("Unknown escape sequence in string");
+                return;
+            }
+            value = OBJECT_VAL(string);
+            constant = compiler_make_constant(value);
+            break;
+        }
+    default:
+        compiler_error_at_current("Expect a number or a string as case label.");
+        return;
+    }
+    compiler_advance();
+    for (uint32_t i = 0; i < *caseCount; i++) {
+        if (value_values_equal(cases[i].value, value)) {
+            compiler_error("Duplicate case label in switch statement.");
+            return;
+        }
+    }
+    if (*caseCount == UINT8_COUNT) {
+        compiler_error("Can't have more than 256 case labels in a switch statement.");
+        return;
+    }
+    cases[*caseCount].value = value;
+    cases[*caseCount].bodyStart = bodyStart;
+    cases[*caseCount].constant = constant;
+    (*caseCount)++;
+}
+
 /// @brief  Checks if the next Token is of a given type
 /// @param type The type that the token is matched against
 /// @return True if the next token matches the type, false if not
@@ -480,9 +579,9 @@ static void compiler_class_declaration(void) {
     // Compiles the name of the class
     compiler_consume(TOKEN_IDENTIFIER, "Expect class name.");
     token_t className = parser.previous;
-    uint8_t nameConstant = compiler_identifier_constant(&parser.previous);
+    uint32_t nameConstant = compiler_identifier_constant(&parser.previous);
     compiler_declare_variable();
-    compiler_emit_bytes(OP_CLASS, nameConstant);
+    compiler_emit_index_instruction(OP_CLASS, nameConstant);
     compiler_define_variable(nameConstant);
     class_compiler_t classCompiler;
     // If this class has a superclass we will set this to true later
@@ -516,6 +615,62 @@ static void compiler_class_declaration(void) {
     currentClass = currentClass->enclosing;
 }
 
+/// @brief Replaces the instructions of an array literal whose elements are all constants with a copy of an array that
+/// is built once at compile time
+/// @param start The index of the first instruction of the elements
+/// @param firstConstant The index of the first constant that was added for the elements
+/// @param count The amount of elements of the array literal
+/// @return true if the array literal was replaced, false if the elements are pushed at runtime
+/// @details Elements are constant if they are number or string literals or negated number literals. Nested arrays are
+/// not constant, because the copies would share them.
+static bool compiler_constant_array(uint32_t start, uint32_t firstConstant, uint8_t count) {
+    chunk_t * chunk = compiler_current_chunk();
+    if (!count || parser.hadError || chunk->constants.count != firstConstant + count) {
+        return false;
+    }
+    uint32_t offset = start;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t extendedArg = 0u;
+        if (offset + 1u < chunk->byteCodeCount && chunk->code[offset] == OP_EXTENDED_ARG) {
+            extendedArg = chunk->code[offset + 1u] << 8;
+            offset += 2u;
+        }
+        if (offset + 1u >= chunk->byteCodeCount || chunk->code[offset] != OP_CONSTANT ||
+            (extendedArg | chunk->code[offset + 1u]) != firstConstant + i) {
+            return false;
+        }
+        offset += 2u;
+        if (offset < chunk->byteCodeCount && chunk->code[offset] == OP_NEGATE) {
+            if (!IS_NUMBER(chunk->constants.values[firstConstant + i])) {
+                return false;
+            }
+            offset++;
+        }
+    }
+    if (offset != chunk->byteCodeCount) {
+        return false;
+    }
+    // The array is kept on the stack while its values are allocated, the elements are still stored as constants
+    object_dynamic_value_array_t * array = object_new_dynamic_value_array();
+    virtual_machine_push(OBJECT_VAL(array));
+    array->array.values = ALLOCATE(value_t, count);
+    array->array.capacity = count;
+    offset = start;
+    for (uint32_t i = 0; i < count; i++) {
+        value_t value = chunk->constants.values[firstConstant + i];
+        offset += chunk->code[offset] == OP_EXTENDED_ARG ? 4u : 2u;
+        if (offset < chunk->byteCodeCount && chunk->code[offset] == OP_NEGATE) {
+            value = value_negate(value);
+            offset++;
+        }
+        object_array_write(array, value);
+    }
+    chunk_truncate(chunk, start, firstConstant);
+    compiler_emit_index_instruction(OP_ARRAY_CONSTANT, compiler_make_constant(OBJECT_VAL(array)));
+    virtual_machine_pop();
+    return true;
+}
+
 /// @brief Consumes a Token and emits a error message if the type of the token doesn't match the specified type
 /// @param type The expected type of the token
 /// @param message The error message that is displayed, if the compiler is not of the specified type
@@ -577,14 +732,14 @@ static void compiler_declare_variable(void) {
 
 /// @brief Compiles the definition of a variable
 /// @param global The slot of the value
-static void compiler_define_variable(uint8_t global) {
+static void compiler_define_variable(uint32_t global) {
     if (current->scopeDepth > 0) {
         // Marks the variable as initialized (only used for local variables)
         compiler_mark_initialized();
         return;
     }
     // The variable has been declared at the global / top level scope
-    compiler_emit_bytes(OP_DEFINE_GLOBAL, global);
+    compiler_emit_index_instruction(OP_DEFINE_GLOBAL, global);
 }
 
 /// @brief Compiles a do while statement
@@ -616,24 +771,28 @@ static void compiler_do_while_statement(void) {
 /// or invoking a method of a cellox object instance.
 static void compiler_dot(bool canAssign) {
     compiler_consume(TOKEN_IDENTIFIER, "Expect property name after '.'.");
-    uint8_t name = compiler_identifier_constant(&parser.previous);
+    uint32_t name = compiler_identifier_constant(&parser.previous);
 
     if (canAssign && compiler_match_token(TOKEN_EQUAL)) {
         compiler_expression();
-        compiler_emit_bytes(OP_SET_PROPERTY, name);
+        compiler_emit_index_instruction(OP_SET_PROPERTY, name);
     } else if (compiler_match_token(TOKEN_LEFT_PAREN)) {
         uint8_t argCount = compiler_argument_list();
-        compiler_emit_bytes(OP_INVOKE, name);
+        compiler_emit_index_instruction(OP_INVOKE, name);
         compiler_emit_byte(argCount);
     } else {
-        compiler_emit_bytes(OP_GET_PROPERTY, name);
+        compiler_emit_index_instruction(OP_GET_PROPERTY, name);
     }
 }
 
-/// @brief
+/// @brief Compiles an array literal
 static void compiler_dynamic_array(bool canAssign) {
+    uint32_t start = compiler_current_chunk()->byteCodeCount;
+    uint32_t firstConstant = compiler_current_chunk()->constants.count;
     uint8_t argCount = compiler_dynamic_array_argument_list();
-    compiler_emit_bytes(OP_ARRAY_LITERAL, argCount);
+    if (!compiler_constant_array(start, firstConstant, argCount)) {
+        compiler_emit_bytes(OP_ARRAY_LITERAL, argCount);
+    }
 }
 
 /// @brief Compiles a List of argument of a call expression to bytecode instructions
@@ -673,30 +832,116 @@ static void compiler_emit_bytes(uint8_t byte1, uint8_t byte2) {
 /// @param value The value of the constant
 /// This can either be a numerical value or a cellox object
 static inline void compiler_emit_constant(value_t value) {
-    compiler_emit_bytes(OP_CONSTANT, compiler_make_constant(value));
+    compiler_emit_index_instruction(OP_CONSTANT, compiler_make_constant(value));
+}
+
+/// @brief Emits a hash jump instruction that dispatches a switch statement
+/// @param cases The labels of the switch statement
+/// @param caseCount The amount of labels
+/// @param defaultStart Index of the first instruction of the default body (-1 if there is no default case)
+/// @details The hashtable of the labels is built at compile time. It uses the hash function and the linear probing of
+/// the value map and is at most half full, so a lookup that misses always ends at an empty slot.
+static void compiler_emit_hash_jump(switch_case_t * cases, uint32_t caseCount, int32_t defaultStart) {
+    uint32_t slotCount = 2u;
+    while (slotCount < 2u * caseCount) {
+        slotCount <<= 1u;
+    }
+    uint16_t slotConstants[2 * UINT8_COUNT];
+    int32_t slotTargets[2 * UINT8_COUNT];
+    for (uint32_t i = 0; i < slotCount; i++) {
+        slotConstants[i] = 0u;
+        slotTargets[i] = -1;
+    }
+    for (uint32_t i = 0; i < caseCount; i++) {
+        if (cases[i].constant == -1) {
+            cases[i].constant = compiler_make_constant(cases[i].value);
+        }
+        uint32_t index = value_map_hash_key(cases[i].value) & (slotCount - 1u);
+        while (slotTargets[index] != -1) {
+            index = (index + 1u) & (slotCount - 1u);
+        }
+        slotConstants[index] = (uint16_t)cases[i].constant;
+        slotTargets[index] = cases[i].bodyStart;
+    }
+    int32_t end = compiler_current_chunk()->byteCodeCount + 7 + 6 * (int32_t)slotCount;
+    compiler_emit_byte(OP_HASH_JUMP);
+    compiler_emit_switch_offset(end, defaultStart);
+    compiler_emit_bytes((slotCount >> 8) & 0xff, slotCount & 0xff);
+    for (uint32_t i = 0; i < slotCount; i++) {
+        compiler_emit_bytes((slotConstants[i] >> 8) & 0xff, slotConstants[i] & 0xff);
+        compiler_emit_switch_offset(end, slotTargets[i]);
+    }
 }
 
-/// @brief Emits a bytecode instruction of the type jump (jump or jump-if-false) and writes a placeholder to the jump
-/// offset
+/// @brief Emits an instruction whose first operand is an index (of a constant, a local variable or an upvalue)
+/// @param instruction The bytecode instruction that is emitted
+/// @param index The index that is used as operand
+/// @details Indices that do not fit into a byte are widened by an OP_EXTENDED_ARG prefix
+static void compiler_emit_index_instruction(uint8_t instruction, uint32_t index) {
+    if (index > UINT8_MAX) {
+        compiler_emit_bytes(OP_EXTENDED_ARG, (index >> 8) & 0xff);
+    }
+    compiler_emit_bytes(instruction, index & 0xff);
+}
+
+/// @brief Emits a bytecode instruction of the type jump (jump, jump-if-false or for-each) and writes a placeholder to
+/// the jump offset
 /// @param instruction The bytecode instruction that is emitted
 /// @return offset (start address) of the then or else branch
+/// @details The offset is not known yet, so the instruction gets two OP_EXTENDED_ARG prefixes that widen the offset to
+/// 32 bits. The optimizer removes the prefixes of the jumps that do not need them.
 static int32_t compiler_emit_jump(uint8_t instruction) {
+    compiler_emit_bytes(OP_EXTENDED_ARG, 0xff);
+    compiler_emit_bytes(OP_EXTENDED_ARG, 0xff);
     compiler_emit_byte(instruction);
     compiler_emit_byte(0xff);
     compiler_emit_byte(0xff);
     return compiler_current_chunk()->byteCodeCount - 2;
 }
 
+/// @brief Emits a jump table instruction that dispatches a switch statement
+/// @param cases The labels of the switch statement (integers that are in the range of a signed 32-bit integer)
+/// @param caseCount The amount of labels
+/// @param minimum The smallest label
+/// @param defaultStart Index of the first instruction of the default body (-1 if there is no default case)
+/// @details The table has an entry for every integer between the smallest and the largest label. The entries of the
+/// integers that are not used as labels jump to the default body.
+static void compiler_emit_jump_table(switch_case_t * cases, uint32_t caseCount, int32_t minimum, int32_t defaultStart) {
+    int32_t targets[2 * UINT8_COUNT];
+    uint32_t count = 0u;
+    for (uint32_t i = 0; i < caseCount; i++) {
+        uint32_t index = (uint32_t)((int64_t)AS_NUMBER(cases[i].value) - minimum);
+        while (count <= index) {
+            targets[count++] = defaultStart;
+        }
+        targets[index] = cases[i].bodyStart;
+    }
+    int32_t end = compiler_current_chunk()->byteCodeCount + 11 + 4 * (int32_t)count;
+    compiler_emit_byte(OP_JUMP_TABLE);
+    compiler_emit_switch_offset(end, defaultStart);
+    compiler_emit_bytes(((uint32_t)minimum >> 24) & 0xff, ((uint32_t)minimum >> 16) & 0xff);
+    compiler_emit_bytes(((uint32_t)minimum >> 8) & 0xff, (uint32_t)minimum & 0xff);
+    compiler_emit_bytes((count >> 8) & 0xff, count & 0xff);
+    for (uint32_t i = 0; i < count; i++) {
+        compiler_emit_switch_offset(end, targets[i]);
+    }
+}
+
 /// Emits the bytecode instructions for creating a loop
+/// @details Loop bodies that are larger than 65535 bytes are jumped over with a widened offset, every OP_EXTENDED_ARG
+/// prefix adds 8 bits to it
 static void compiler_emit_loop(int32_t loopStart) {
-    compiler_emit_byte(OP_LOOP);
-    int32_t offset = compiler_current_chunk()->byteCodeCount - loopStart + 2;
-    if (offset > (int32_t)UINT16_MAX) {
-        compiler_error(
-            "Loop body too large."); // There can only be 65535 lines betweem a jump instruction because we use a short
+    uint32_t prefixCount = 0u;
+    uint32_t offset = compiler_current_chunk()->byteCodeCount - loopStart + 3u;
+    while (prefixCount < 2u && offset >> (16u + 8u * prefixCount)) {
+        prefixCount++;
+        offset += 2u;
+    }
+    for (uint32_t prefix = prefixCount; prefix > 0u; prefix--) {
+        compiler_emit_bytes(OP_EXTENDED_ARG, (offset >> (8u + 8u * prefix)) & 0xff);
     }
-    compiler_emit_byte((offset >> 8) & 0xff);
-    compiler_emit_byte(offset & 0xff);
+    compiler_emit_byte(OP_LOOP);
+    compiler_emit_bytes((offset >> 8) & 0xff, offset & 0xff);
 }
 
 /// @brief Emits a return bytecode instruction
@@ -709,6 +954,17 @@ static void compiler_emit_return(void) {
     compiler_emit_byte(OP_RETURN);
 }
 
+/// @brief Emits the jump offset of a case in a switch instruction
+/// @param end Index of the instruction after the switch instruction
+/// @param target Index of the first instruction of the case body (-1 leaves the switch statement)
+/// @details The case bodies are compiled in front of the switch instruction, so the offset is subtracted from the index
+/// of the next instruction when the case is dispatched
+static void compiler_emit_switch_offset(int32_t end, int32_t target) {
+    uint32_t offset = target == -1 ? 0u : (uint32_t)(end - target);
+    compiler_emit_bytes((offset >> 24) & 0xff, (offset >> 16) & 0xff);
+    compiler_emit_bytes((offset >> 8) & 0xff, offset & 0xff);
+}
+
 /// @brief Yields a newly created function object after the compilation process finished
 /// @return The newly created function object
 static object_function_t * compiler_end(void) {
@@ -803,14 +1059,63 @@ static void compiler_expression_statement(void) {
     compiler_emit_byte(OP_POP);
 }
 
+/// @brief Compiles a for-each statement
+/// @param name The name of the loop variable
+/// @details The generated bytecode has the following structure
+/// collection
+/// cursor (null)
+/// modification count of a map (null)
+/// start:
+/// Push the next element or jump to the end if there are no elements left
+/// Instructions in the loop body
+/// Jump to start
+/// end:
+/// The collection, the cursor and the modification count are stored in hidden locals, whose names can not be used by
+/// an identifier. Every iteration gets a new loop variable, so closures that capture it do not observe the following
+/// elements.
+static void compiler_for_each_statement(token_t name) {
+    compiler_expression();
+    compiler_consume(TOKEN_RIGHT_PAREN, "Expect ')' after for-each collection.");
+    uint32_t iteratorSlot = (uint32_t)current->localCount;
+    compiler_add_local(compiler_synthetic_token("for collection"));
+    compiler_mark_initialized();
+    compiler_emit_byte(OP_NULL);
+    compiler_add_local(compiler_synthetic_token("for cursor"));
+    compiler_mark_initialized();
+    compiler_emit_byte(OP_NULL);
+    compiler_add_local(compiler_synthetic_token("for modification count"));
+    compiler_mark_initialized();
+    int32_t loopStart = compiler_current_chunk()->byteCodeCount;
+    int32_t exitJump = compiler_emit_jump(OP_FOR_EACH);
+    compiler_emit_bytes((iteratorSlot >> 8) & 0xff, iteratorSlot & 0xff);
+    compiler_begin_scope();
+    // The element is pushed by the for-each instruction
+    compiler_add_local(name);
+    compiler_mark_initialized();
+    compiler_statement();
+    compiler_end_scope();
+    compiler_emit_loop(loopStart);
+    compiler_patch_jump(exitJump);
+}
+
 /// @brief Compiles a for-statement
+/// @details If the variable declaration in the initializer clause is followed by a colon a for-each statement is
+/// compiled instead
 static void compiler_for_statement(void) {
     compiler_begin_scope();
     compiler_consume(TOKEN_LEFT_PAREN, "Expect '(' after 'for'.");
 
     // Initializer clause
     if (compiler_match_token(TOKEN_VAR)) {
-        compiler_var_declaration();
+        compiler_consume(TOKEN_IDENTIFIER, "Expect variable name.");
+        token_t name = parser.previous;
+        if (compiler_match_token(TOKEN_DOUBLEDOT)) {
+            compiler_for_each_statement(name);
+            compiler_end_scope();
+            return;
+        }
+        compiler_declare_variable();
+        compiler_var_initializer(0);
     } else if (!compiler_match_token(TOKEN_SEMICOLON)) {
         compiler_expression_statement();
     }
@@ -867,7 +1172,7 @@ static void compiler_function(function_type type) {
             if (current->function->arity > 255) {
                 compiler_error_at_current("Can't have more than 255 parameters.");
             }
-            uint8_t constant = compiler_parse_variable("Expect parameter name.");
+            uint32_t constant = compiler_parse_variable("Expect parameter name.");
             compiler_define_variable(constant);
         } while (compiler_match_token(TOKEN_COMMA));
     }
@@ -876,22 +1181,30 @@ static void compiler_function(function_type type) {
     // Compiles the statements inside a the function body
     compiler_block();
     object_function_t * function = compiler_end();
-    compiler_emit_bytes(OP_CLOSURE, compiler_make_constant(OBJECT_VAL(function)));
+    compiler_emit_index_instruction(OP_CLOSURE, compiler_make_constant(OBJECT_VAL(function)));
     for (int32_t i = 0; i < function->upvalueCount; i++) {
         compiler_emit_byte(compiler.upvalues[i].isLocal ? 1 : 0);
-        compiler_emit_byte(compiler.upvalues[i].index);
+        compiler_emit_bytes((compiler.upvalues[i].index >> 8) & 0xff, compiler.upvalues[i].index & 0xff);
     }
+    compiler_free(&compiler);
 }
 
 /// @brief Compiles a function statement and defines the function in the current environment
 static void compiler_function_declaration(void) {
-    uint8_t global = compiler_parse_variable("Expect function name.");
+    uint32_t global = compiler_parse_variable("Expect function name.");
     compiler_mark_initialized();
     compiler_function(TYPE_FUNCTION);
     // Defines the function at the specified slot
     compiler_define_variable(global);
 }
 
+/// @brief Frees the locals and upvalues of a compiler after its function has been emitted
+/// @param compiler The compiler whose arrays are freed
+static void compiler_free(compiler_t * compiler) {
+    FREE_ARRAY(local_t, compiler->locals, compiler->localCapacity);
+    FREE_ARRAY(upvalue_t, compiler->upvalues, compiler->upvalueCapacity);
+}
+
 /// @brief Gets the parsing rule for a specific token type
 /// @param type The type of the token
 /// @return The parsing rule for the token type
@@ -910,13 +1223,13 @@ static void compiler_grouping(bool canAssign) {
 /// @param canAssign  Unused for hexadezimal number expressions
 static inline void compiler_hex_number(bool canAssign) {
     double value = strtol(parser.previous.start + 2, NULL, 16);
-    compiler_emit_constant(NUMBER_VAL(value));
+    compiler_emit_constant(value_from_number(value));
 }
 
 /// @brief Used to create a string object from an identifier token
 /// @param name The name of the token
 /// @return A byte code instruction that defines the constant
-static uint8_t compiler_identifier_constant(token_t * name) {
+static uint32_t compiler_identifier_constant(token_t * name) {
     return compiler_make_constant(OBJECT_VAL(object_copy_string(name->start, name->length, false)));
 }
 
@@ -939,6 +1252,8 @@ static void compiler_if_statement(void) {
     compiler_consume(TOKEN_RIGHT_PAREN, "Expect ')' after condition.");
     // Offset to the instruction that corresponds to the body of the then block
     int32_t thenJump = compiler_emit_jump(OP_JUMP_IF_FALSE);
+    // The condition is popped in both branches, otherwise every executed then block would leak a stack slot
+    compiler_emit_byte(OP_POP);
     compiler_statement();
     // Offset to the instruction that corresponds to the body of the else block
     int32_t elseJump = compiler_emit_jump(OP_JUMP);
@@ -960,22 +1275,17 @@ static void compiler_init(compiler_t * compiler, function_type type) {
     compiler->function = NULL;
     compiler->type = type;
     compiler->localCount = compiler->scopeDepth = 0;
+    compiler->localCapacity = compiler->upvalueCapacity = 0u;
+    compiler->locals = NULL;
+    compiler->upvalues = NULL;
     compiler->function = object_new_function();
     current = compiler;
     if (type != TYPE_SCRIPT) {
         current->function->name = object_copy_string(parser.previous.start, parser.previous.length, false);
     }
-    local_t * local = &current->locals[current->localCount++];
-    local->depth = 0;
-    local->isCaptured = false;
     // In a method we refer to the memebers with this so we add it to the local values that are accessible
-    if (type != TYPE_FUNCTION) {
-        local->name.start = "this";
-        local->name.length = 4;
-    } else {
-        local->name.start = "";
-        local->name.length = 0;
-    }
+    compiler_add_local(compiler_synthetic_token(type != TYPE_FUNCTION ? "this" : ""));
+    current->locals[0].depth = 0;
 }
 
 /// @brief Compiles a index of expression
@@ -983,7 +1293,7 @@ static void compiler_init(compiler_t * compiler, function_type type) {
 /// @param getOp Indicates whether the index of gets a value or sets a value
 /// @param arg The index of the constant
 static void compiler_index_of(bool canAssign, uint8_t getOp, uint32_t arg) {
-    compiler_emit_bytes(getOp, (uint8_t)arg);
+    compiler_emit_index_instruction(getOp, arg);
     compiler_expression();
     if (compiler_match_token(TOKEN_RANGE)) {
         compiler_expression();
@@ -1040,14 +1350,14 @@ static void compiler_mark_initialized(void) {
 /// @brief Emits a constant bytecode instruction with the value that was passed as an argument up opon the function call
 /// @param value The value of the constant
 /// @return The index off the constant
-static uint8_t compiler_make_constant(value_t value) {
+static uint32_t compiler_make_constant(value_t value) {
     int32_t constant = chunk_add_constant(compiler_current_chunk(), value);
-    if (constant > (int32_t)UINT8_MAX) {
-        // A chunk can only contain 255 constants
+    if (constant > (int32_t)UINT16_MAX) {
+        // A chunk can only contain 65536 constants, because a prefix widens the index to 16 bits
         compiler_error("Too many constants in one chunk.");
         return 0;
     }
-    return (uint8_t)constant;
+    return (uint32_t)constant;
 }
 
 /// @brief Determines whether the next Token is from the specified TokenTypes and advances a position further, if that
@@ -1065,13 +1375,13 @@ static bool compiler_match_token(tokentype type) {
 /// @brief Compiles a method declaration
 static void compiler_method(void) {
     compiler_consume(TOKEN_IDENTIFIER, "Expect method name.");
-    uint8_t constant = compiler_identifier_constant(&parser.previous);
+    uint32_t constant = compiler_identifier_constant(&parser.previous);
     function_type type = TYPE_METHOD;
     if (parser.previous.length == 4 && !memcmp(parser.previous.start, "init", 4)) {
         type = TYPE_INITIALIZER; // The initializer method, also called constructor in other languages, of a class.
     }
     compiler_function(type);
-    compiler_emit_bytes(OP_METHOD, constant);
+    compiler_emit_index_instruction(OP_METHOD, constant);
 }
 
 /// @brief Handles getting and setting a variable (locals, globals and upvalues)
@@ -1093,9 +1403,10 @@ static void compiler_named_variable(token_t name, bool canAssign) {
     }
     if (canAssign && compiler_match_token(TOKEN_EQUAL)) {
         compiler_expression();
-        compiler_emit_bytes(setOp, (uint8_t)arg);
+        compiler_emit_index_instruction(setOp, arg);
     } else if (canAssign && compiler_match_token(TOKEN_PLUS_EQUAL)) {
-        compiler_nondirect_assignment(OP_ADD, getOp, setOp, arg);
+        // Arrays are extended in place instead of being copied
+        compiler_nondirect_assignment(OP_ADD_IN_PLACE, getOp, setOp, arg);
     } else if (canAssign && compiler_match_token(TOKEN_MINUS_EQUAL)) {
         compiler_nondirect_assignment(OP_SUBTRACT, getOp, setOp, arg);
     } else if (canAssign && compiler_match_token(TOKEN_STAR_EQUAL)) {
@@ -1109,7 +1420,7 @@ static void compiler_named_variable(token_t name, bool canAssign) {
     } else if (compiler_match_token(TOKEN_LEFT_BRACKET)) {
         compiler_index_of(canAssign, getOp, arg);
     } else {
-        compiler_emit_bytes(getOp, (uint8_t)arg);
+        compiler_emit_index_instruction(getOp, arg);
     }
 }
 
@@ -1118,18 +1429,19 @@ static void compiler_named_variable(token_t name, bool canAssign) {
 /// @param getOp The left operand (x += 5 -> x)
 /// @param setOp The left operand (x += 5 -> x)
 /// @param arg The right operand (x += 5 -> 5)
-static void compiler_nondirect_assignment(uint8_t assignmentType, uint8_t getOp, uint8_t setOp, uint8_t arg) {
-    compiler_emit_bytes(getOp, arg);
+static void compiler_nondirect_assignment(uint8_t assignmentType, uint8_t getOp, uint8_t setOp, uint32_t arg) {
+    compiler_emit_index_instruction(getOp, arg);
     compiler_expression();
     compiler_emit_byte(assignmentType);
-    compiler_emit_bytes(setOp, arg);
+    compiler_emit_index_instruction(setOp, arg);
 }
 
 /// @brief compiles a number literal expression
 /// @param canAssign Unused for number literal expressions
 static inline void compiler_number(bool canAssign) {
     double value = strtod(parser.previous.start, NULL);
-    compiler_emit_constant(NUMBER_VAL(value));
+    // Integral literals are stored as integers, so integer arithmetic does not need the floating point unit
+    compiler_emit_constant(value_from_number(value));
 }
 
 /// @brief Compiles an or expression
@@ -1173,7 +1485,7 @@ static void compiler_parse_precedence(precedence precedence) {
 /// @brief Parses a variable statement
 /// @param errorMessage The error message that is shown if the identifier is not valid
 /// @return The slot of the local variable
-static uint8_t compiler_parse_variable(char const * errorMessage) {
+static uint32_t compiler_parse_variable(char const * errorMessage) {
     compiler_consume(TOKEN_IDENTIFIER, errorMessage);
     compiler_declare_variable();
     if (current->scopeDepth > 0) {
@@ -1185,14 +1497,14 @@ static uint8_t compiler_parse_variable(char const * errorMessage) {
 /// @brief Replaces the instruction at the given location with the calculated jump offset
 /// @param offset The offset if the instruction
 static void compiler_patch_jump(int32_t offset) {
-    // -2 to adjust for the bytecode for the jump offset itself.
-    int32_t jump = compiler_current_chunk()->byteCodeCount - offset - 2;
-    if (jump > (int32_t)UINT16_MAX) {
-        compiler_error("Too much code to jump over."); // More than 65,535 bytes of code
-    }
-    // Jump offset (16-bit value) is split into two bytes
-    compiler_current_chunk()->code[offset] = (jump >> 8) & 0xff;
-    compiler_current_chunk()->code[offset + 1] = jump & 0xff;
+    uint8_t * code = compiler_current_chunk()->code;
+    // -2 to adjust for the bytecode for the jump offset itself, the slot of a for-each instruction follows the offset
+    uint32_t jump = compiler_current_chunk()->byteCodeCount - offset - (code[offset - 1] == OP_FOR_EACH ? 4u : 2u);
+    // Jump offset (32-bit value) is split into the operands of the two prefixes and two bytes
+    code[offset - 4] = (jump >> 24) & 0xff;
+    code[offset - 2] = (jump >> 16) & 0xff;
+    code[offset] = (jump >> 8) & 0xff;
+    code[offset + 1] = jump & 0xff;
 }
 
 /// @brief Resolves a local variable name
@@ -1223,12 +1535,12 @@ static int32_t compiler_resolve_upvalue(compiler_t * compiler, token_t * name) {
     int32_t local = compiler_resolve_local(compiler->enclosing, name);
     if (local != -1) {
         compiler->enclosing->locals[local].isCaptured = true;
-        return compiler_add_upvalue(compiler, (uint8_t)local, true);
+        return compiler_add_upvalue(compiler, (uint16_t)local, true);
     }
     // Resolution of a local variable failed in the current environent -> look in the enclosing environment
     int32_t upvalue = compiler_resolve_upvalue(compiler->enclosing, name);
     if (upvalue != -1) {
-        return compiler_add_upvalue(compiler, (uint8_t)upvalue, false);
+        return compiler_add_upvalue(compiler, (uint16_t)upvalue, false);
     }
     // not found
     return -1;
@@ -1253,7 +1565,7 @@ static void compiler_return_statement(void) {
 }
 
 ///@brief Compiles a statement
-/// @details This can be either a for, an if, a return, a while, or a block statement.
+/// @details This can be either a for, an if, a return, a switch, a while, or a block statement.
 /// If no statement was specified, the next expression is instead compiled
 static void compiler_statement(void) {
     if (compiler_match_token(TOKEN_FOR)) {
@@ -1262,6 +1574,8 @@ static void compiler_statement(void) {
         compiler_if_statement();
     } else if (compiler_match_token(TOKEN_RETURN)) {
         compiler_return_statement();
+    } else if (compiler_match_token(TOKEN_SWITCH)) {
+        compiler_switch_statement();
     } else if (compiler_match_token(TOKEN_WHILE)) {
         compiler_while_statement();
     } else if (compiler_match_token(TOKEN_DO)) {
@@ -1301,17 +1615,89 @@ static void compiler_super(bool canAssign) {
     }
     compiler_consume(TOKEN_DOT, "Expect '.' after 'super'.");
     compiler_consume(TOKEN_IDENTIFIER, "Expect superclass method name.");
-    uint8_t name = compiler_identifier_constant(&parser.previous);
+    uint32_t name = compiler_identifier_constant(&parser.previous);
     compiler_named_variable(compiler_synthetic_token("this"), false);
     // Compiles arguments of the super expression
     if (compiler_match_token(TOKEN_LEFT_PAREN)) {
         uint8_t argCount = compiler_argument_list();
         compiler_named_variable(compiler_synthetic_token("super"), false);
-        compiler_emit_bytes(OP_SUPER_INVOKE, name);
+        compiler_emit_index_instruction(OP_SUPER_INVOKE, name);
         compiler_emit_byte(argCount);
     } else {
         compiler_named_variable(compiler_synthetic_token("super"), false);
-        compiler_emit_bytes(OP_GET_SUPER, name);
+        compiler_emit_index_instruction(OP_GET_SUPER, name);
+    }
+}
+
+/// @brief Compiles a switch statement
+/// @details The generated bytecode has the following structure
+/// subject
+/// Jump to dispatch
+/// Instructions of the case bodies, each followed by a jump to the end
+/// dispatch: OP_JUMP_TABLE or OP_HASH_JUMP
+/// end:
+/// Cases do not fall through, consecutive labels share the body that follows them. A switch statement over integer
+/// labels that cover at least half of their range is dispatched with a jump table, otherwise the labels are looked up
+/// in a hashtable. Both dispatch the cases in constant time.
+static void compiler_switch_statement(void) {
+    compiler_consume(TOKEN_LEFT_PAREN, "Expect '(' after 'switch'.");
+    compiler_expression();
+    compiler_consume(TOKEN_RIGHT_PAREN, "Expect ')' after switch subject.");
+    compiler_consume(TOKEN_LEFT_BRACE, "Expect '{' before switch cases.");
+    int32_t dispatchJump = compiler_emit_jump(OP_JUMP);
+    switch_case_t cases[UINT8_COUNT];
+    int32_t endJumps[UINT8_COUNT];
+    uint32_t caseCount = 0u, bodyCount = 0u;
+    int32_t defaultStart = -1;
+    while (!compiler_check(TOKEN_RIGHT_BRACE) && !compiler_check(TOKEN_EOF)) {
+        int32_t bodyStart = compiler_current_chunk()->byteCodeCount;
+        if (!compiler_check(TOKEN_CASE) && !compiler_check(TOKEN_DEFAULT)) {
+            compiler_error_at_current("Expect 'case' or 'default' in switch statement.");
+        }
+        while (compiler_check(TOKEN_CASE) || compiler_check(TOKEN_DEFAULT)) {
+            if (compiler_match_token(TOKEN_CASE)) {
+                compiler_case_label(cases, &caseCount, bodyStart);
+            } else {
+                compiler_advance();
+                if (defaultStart != -1) {
+                    compiler_error("Can't have more than one default case in a switch statement.");
+                }
+                defaultStart = bodyStart;
+            }
+            compiler_consume(TOKEN_DOUBLEDOT, "Expect ':' after case label.");
+        }
+        compiler_begin_scope();
+        while (!compiler_check(TOKEN_CASE) && !compiler_check(TOKEN_DEFAULT) && !compiler_check(TOKEN_RIGHT_BRACE) &&
+               !compiler_check(TOKEN_EOF)) {
+            compiler_declaration();
+        }
+        compiler_end_scope();
+        if (bodyCount == UINT8_COUNT) {
+            compiler_error("Can't have more than 256 case bodies in a switch statement.");
+        } else {
+            endJumps[bodyCount++] = compiler_emit_jump(OP_JUMP);
+        }
+    }
+    compiler_consume(TOKEN_RIGHT_BRACE, "Expect '}' after switch cases.");
+    compiler_patch_jump(dispatchJump);
+    // Integer labels between the smallest and the largest label are dense enough for a jump table
+    bool integral = true;
+    int64_t minimum = caseCount ? INT32_MAX : 0, maximum = caseCount ? INT32_MIN : -1;
+    for (uint32_t i = 0; i < caseCount && integral; i++) {
+        double number = IS_NUMBER(cases[i].value) ? AS_NUMBER(cases[i].value) : 0.5;
+        integral = number >= INT32_MIN && number <= INT32_MAX && number == (double)(int32_t)number;
+        if (integral) {
+            minimum = number < minimum ? (int64_t)number : minimum;
+            maximum = number > maximum ? (int64_t)number : maximum;
+        }
+    }
+    if (integral && maximum - minimum < 2 * (int64_t)caseCount) {
+        compiler_emit_jump_table(cases, caseCount, (int32_t)minimum, defaultStart);
+    } else {
+        compiler_emit_hash_jump(cases, caseCount, defaultStart);
+    }
+    for (uint32_t i = 0; i < bodyCount; i++) {
+        compiler_patch_jump(endJumps[i]);
     }
 }
 
@@ -1332,6 +1718,7 @@ static void compiler_synchronize(void) {
         case TOKEN_IF:
         case TOKEN_WHILE:
         case TOKEN_RETURN:
+        case TOKEN_SWITCH:
             return;
 
         default:
@@ -1382,7 +1769,12 @@ static void compiler_unary(bool canAssign) {
 
 /// @brief Compiles a variable declaration
 static void compiler_var_declaration(void) {
-    uint8_t global = compiler_parse_variable("Expect variable name.");
+    compiler_var_initializer(compiler_parse_variable("Expect variable name."));
+}
+
+/// @brief Compiles the initializer of a variable declaration and defines the variable
+/// @param global The slot of the value
+static void compiler_var_initializer(uint32_t global) {
     if (compiler_match_token(TOKEN_EQUAL)) {
         // Variable was initialzed
         if (!compiler_match_token(TOKEN_LEFT_BRACE)) {
@@ -36,4 +36,8 @@ object_function_t * compiler_compile(char const * code);
 /// reference in some other object.
 void compiler_mark_roots(void);
 
+/// @brief Resets the state of the compiler
+/// @details Used if the compilation process was aborted (e.g. because the heap limit was exceeded)
+void compiler_reset(void);
+
 #endif
@@ -183,8 +183,26 @@ static tokentype lexer_identifier_type(void) {
         return lexer_check_keyword(start, length, rest, token);
     switch (lexer.start[0]) {
         CASE_KEYWORD('a', 1, 2, "nd", TOKEN_AND);
-        CASE_KEYWORD('c', 1, 4, "lass", TOKEN_CLASS);
-        CASE_KEYWORD('d', 1, 1, "o", TOKEN_DO);
+    case 'c':
+        if (lexer.current - lexer.start > 1) {
+            switch (lexer.start[1]) {
+            case 'a':
+                return lexer_check_keyword(2, 2, "se", TOKEN_CASE);
+            case 'l':
+                return lexer_check_keyword(2, 3, "ass", TOKEN_CLASS);
+            }
+        }
+        break;
+    case 'd':
+        if (lexer.current - lexer.start > 1) {
+            switch (lexer.start[1]) {
+            case 'e':
+                return lexer_check_keyword(2, 5, "fault", TOKEN_DEFAULT);
+            case 'o':
+                return lexer_check_keyword(2, 0, "", TOKEN_DO);
+            }
+        }
+        break;
         CASE_KEYWORD('e', 1, 3, "lse", TOKEN_ELSE);
     case 'f':
         if (lexer.current - lexer.start > 1) {
@@ -202,7 +220,16 @@ static tokentype lexer_identifier_type(void) {
         CASE_KEYWORD('n', 1, 3, "ull", TOKEN_NULL);
         CASE_KEYWORD('o', 1, 1, "r", TOKEN_OR);
         CASE_KEYWORD('r', 1, 5, "eturn", TOKEN_RETURN);
-        CASE_KEYWORD('s', 1, 4, "uper", TOKEN_SUPER);
+    case 's':
+        if (lexer.current - lexer.start > 1) {
+            switch (lexer.start[1]) {
+            case 'u':
+                return lexer_check_keyword(2, 3, "per", TOKEN_SUPER);
+            case 'w':
+                return lexer_check_keyword(2, 4, "itch", TOKEN_SWITCH);
+            }
+        }
+        break;
     case 't':
         if (lexer.current - lexer.start > 1) {
             switch (lexer.start[1]) {
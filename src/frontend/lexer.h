@@ -34,15 +34,19 @@ typedef enum {
     TOKEN_BANG_EQUAL,
     /// A number literal specified in binary
     TOKEN_BINARY_NUMBER,
+    /// case
+    TOKEN_CASE,
     /// class
     TOKEN_CLASS,
     /// ,
     TOKEN_COMMA,
+    /// default
+    TOKEN_DEFAULT,
     /// do
     TOKEN_DO,
     /// &sdot;
     TOKEN_DOT,
-    /// : (Used for inheritance)
+    /// : (Used for inheritance and case labels)
     TOKEN_DOUBLEDOT,
     /// else
     TOKEN_ELSE,
@@ -130,6 +134,8 @@ typedef enum {
     TOKEN_STRING,
     /// super
     TOKEN_SUPER,
+    /// switch
+    TOKEN_SWITCH,
     /// this
     TOKEN_THIS,
     /// Boolean literal true
@@ -127,6 +127,14 @@ void initializer_show_help(void) {
     printf("  -c, --compile\t\tConverts the specified file to bytecode and stores the result as a seperate file\n");
     printf("  -h, --help\t\tDisplay this help and exit\n");
     printf("  -v, --version\t\tShows the version of the installed compiler and exit\n\n");
+    printf("Garbage collector settings (can also be set using the environment variables in brackets)\n");
+    printf("  --gc-initial-heap=SIZE\tHeap size that triggers the first collection, e.g. 4M "
+           "(CELLOX_GC_INITIAL_HEAP)\n");
+    printf("  --gc-growth-factor=F\tFactor the heap grows by after a collection (CELLOX_GC_GROWTH_FACTOR)\n");
+    printf("  --gc-max-heap=SIZE\tMaximum heap size, 0 means unlimited (CELLOX_GC_MAX_HEAP)\n");
+    printf("  --gc-adaptive[=on|off]\tTunes the growth factor based on pause times and survival rates "
+           "(CELLOX_GC_ADAPTIVE)\n");
+    printf("  --gc-report[=on|off]\tPrints statistics about the garbage collector at exit (CELLOX_GC_REPORT)\n\n");
 }
 
 void initializer_show_version(void) {
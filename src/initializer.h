@@ -30,7 +30,8 @@ extern "C" {
 #include <stdbool.h>
 
 /// Message that explains the usage of the cellox compiler
-#define CELLOX_USAGE_MESSAGE ("Usage: Cellox ((-h|--help|-v|--version) | ((-c | --compile) [path])\n")
+#define CELLOX_USAGE_MESSAGE \
+    ("Usage: Cellox ((-h|--help|-v|--version) | ([--gc-<setting>=<value>...] [(-c | --compile)] [path]))\n")
 
 /** @brief Run with repl
  * @details
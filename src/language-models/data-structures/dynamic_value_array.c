@@ -32,14 +32,35 @@ void dynamic_value_array_init(dynamic_value_array_t * array) {
     array->count = array->capacity = 0u;
 }
 
+void dynamic_value_array_insert(dynamic_value_array_t * array, size_t index, value_t value) {
+    if (index > array->count) {
+        return;
+    }
+    dynamic_value_array_reserve(array, array->count + 1u);
+    // The regions overlap, so the values have to be moved instead of copied
+    memmove(array->values + index + 1, array->values + index, (array->count - index) * sizeof(value_t));
+    array->values[index] = value;
+    array->count++;
+}
+
 void dynamic_value_array_remove(dynamic_value_array_t * array, size_t index) {
     if (index >= array->count) {
         return;
     }
-    memcpy(array->values + index, array->values + index + 1, array->count - (index + 1));
+    memmove(array->values + index, array->values + index + 1, (array->count - (index + 1)) * sizeof(value_t));
     array->count--;
 }
 
+void dynamic_value_array_reserve(dynamic_value_array_t * array, uint32_t capacity) {
+    if (array->capacity >= capacity) {
+        return;
+    }
+    uint32_t oldCapacity = array->capacity;
+    uint32_t grownCapacity = GROW_CAPACITY(oldCapacity);
+    array->capacity = grownCapacity > capacity ? grownCapacity : capacity;
+    array->values = GROW_ARRAY(value_t, array->values, oldCapacity, array->capacity);
+}
+
 void dynamic_value_array_write(dynamic_value_array_t * array, value_t value) {
     if (array->capacity < array->count + 1u) {
         uint32_t oldCapacity = array->capacity;
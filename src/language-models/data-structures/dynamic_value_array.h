@@ -43,8 +43,24 @@ void dynamic_value_array_free(dynamic_value_array_t * array);
 /// @param array The array that is inititialized
 void dynamic_value_array_init(dynamic_value_array_t * array);
 
+/// @brief Inserts a value into the dynamic array
+/// @param array The array where the value is inserted
+/// @param index The index of the inserted value, the values at and after the index are shifted back by one
+/// @param value The value that is inserted into the array
+/// @note Nothing is inserted if the index is bigger than the amount of values stored in the array
+void dynamic_value_array_insert(dynamic_value_array_t * array, size_t index, value_t value);
+
+/// @brief Removes a value from the dynamic array
+/// @param array The array where the value is removed
+/// @param index The index of the removed value, the values after the index are shifted forward by one
 void dynamic_value_array_remove(dynamic_value_array_t * array, size_t index);
 
+/// @brief Ensures that the dynamic array can store at least the given amount of values without being reallocated
+/// @param array The array whose capacity is increased
+/// @param capacity The capacity the array has at least afterwards
+/// @details The capacity grows geometrically, so appending to an array repeatedly takes amortized constant time
+void dynamic_value_array_reserve(dynamic_value_array_t * array, uint32_t capacity);
+
 /// @brief Adds a value to the dynamic array
 /// @param array The array where the value is added
 /// @param value The value that is added to the array
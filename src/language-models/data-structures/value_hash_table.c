@@ -26,21 +26,61 @@
 #include "../../backend/memory_mutator.h"
 #include "../object.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#define HASH_TABLE_SSE2
+#include <emmintrin.h>
+#endif
+
 /// @brief The max load factor of the hashtable
 /// @details If the max load factor multiplied with the capacity is reached we grow the hashtable
-#define TABLE_MAX_LOAD 0.75
+#define TABLE_MAX_LOAD             0.875
+
+/// @brief The min load factor of the hashtable
+/// @details If less entries than the min load factor multiplied with the capacity are stored we shrink the hashtable
+#define TABLE_MIN_LOAD             0.125
+
+/// The smallest capacity a hashtable is shrunk to
+#define TABLE_MIN_CAPACITY         (8u)
+
+/// The number of control bytes that are probed at once
+#define HASH_TABLE_GROUP_WIDTH     (16u)
+
+/// Control byte of a slot that has never been used
+#define HASH_TABLE_CONTROL_EMPTY   ((uint8_t)0x80)
+
+/// Control byte of a slot whose entry has been deleted
+#define HASH_TABLE_CONTROL_DELETED ((uint8_t)0xFE)
+
+/// Determines the part of the hash that selects the slot where the probing starts
+#define HASH_TABLE_H1(hash)        (hash)
+
+/// Determines the part of the hash that is stored in the control byte of a slot (the upper 7 bits)
+#define HASH_TABLE_H2(hash)        ((uint8_t)((hash) >> 25u))
 
-static void hash_table_adjust_capacity(value_hash_table_t *, int32_t);
-static value_hash_table_entry_t * hash_table_find_entry(value_hash_table_entry_t *, int32_t, object_string_t *);
+static void hash_table_adjust_capacity(value_hash_table_t *, uint32_t);
+static void hash_table_delete_slot(value_hash_table_t *, uint32_t);
+static int64_t hash_table_find_slot(value_hash_table_t *, object_string_t *);
+static uint32_t hash_table_find_free_slot(uint8_t const *, uint32_t, uint32_t);
+static uint32_t hash_table_group_match(uint8_t const *, uint8_t);
+static uint32_t hash_table_group_match_empty(uint8_t const *);
+static uint32_t hash_table_group_match_free(uint8_t const *);
+static uint32_t hash_table_leading_zero_bits(uint32_t);
+static uint32_t hash_table_lowest_bit(uint32_t);
+static void hash_table_set_control(uint8_t *, uint32_t, uint32_t, uint8_t);
+static uint32_t hash_table_shrunk_capacity(value_hash_table_t *);
 
 void value_hash_table_free(value_hash_table_t * table) {
     FREE_ARRAY(value_hash_table_entry_t, table->entries, table->capacity);
+    if (table->control) {
+        FREE_ARRAY(uint8_t, table->control, table->capacity + HASH_TABLE_GROUP_WIDTH);
+    }
     value_hash_table_init(table);
 }
 
 void value_hash_table_init(value_hash_table_t * table) {
-    table->count = table->capacity = 0;
+    table->count = table->capacity = table->tombstones = table->deletions = 0;
     table->entries = NULL;
+    table->control = NULL;
 }
 
 void value_hash_table_mark(value_hash_table_t * table) {
@@ -64,14 +104,14 @@ bool value_hash_table_delete(value_hash_table_t * table, object_string_t * key)
     if (!table->count) {
         return false;
     }
-    // Find the entry.
-    value_hash_table_entry_t * entry = hash_table_find_entry(table->entries, table->capacity, key);
-    if (!entry->key) {
+    int64_t slot = hash_table_find_slot(table, key);
+    if (slot < 0) {
         return false;
     }
-    // Replace the entry with a tombstone
-    entry->key = NULL;
-    entry->value = BOOL_VAL(true);
+    hash_table_delete_slot(table, (uint32_t)slot);
+    if (table->capacity > TABLE_MIN_CAPACITY && table->count < table->capacity * TABLE_MIN_LOAD) {
+        hash_table_adjust_capacity(table, hash_table_shrunk_capacity(table));
+    }
     return true;
 }
 
@@ -80,21 +120,22 @@ object_string_t * value_hash_table_find_string(value_hash_table_t * table, char
     if (!table->count) {
         return NULL;
     }
-
-    uint32_t index = hash & (table->capacity - 1);
-    for (;;) {
-        value_hash_table_entry_t * entry = &table->entries[index];
-        if (!entry->key) {
-            // Stop if we find an empty non-tombstone entry.
-            if (IS_NULL(entry->value)) {
-                return NULL;
+    uint32_t mask = table->capacity - 1;
+    uint8_t h2 = HASH_TABLE_H2(hash);
+    uint32_t position = HASH_TABLE_H1(hash) & mask;
+    for (uint32_t stride = HASH_TABLE_GROUP_WIDTH;; stride += HASH_TABLE_GROUP_WIDTH) {
+        uint8_t const * group = table->control + position;
+        for (uint32_t matches = hash_table_group_match(group, h2); matches; matches &= matches - 1) {
+            object_string_t * key = table->entries[(position + hash_table_lowest_bit(matches)) & mask].key;
+            if (key->length == length && key->hash == hash && !memcmp(key->chars, chars, length)) {
+                return key; // We found the string
             }
-        } else if (entry->key->length == length && entry->key->hash == hash &&
-                   !memcmp(entry->key->chars, chars, length)) {
-            return entry->key; /// We found the string
         }
-        // We look in the next bucket but eventually we also have to wrap around the array when we reach the end
-        index = (index + 1) & (table->capacity - 1);
+        // An empty slot ends the probe sequence, the string would have been inserted there
+        if (hash_table_group_match_empty(group)) {
+            return NULL;
+        }
+        position = (position + stride) & mask;
     }
 }
 
@@ -102,99 +143,250 @@ bool value_hash_table_get(value_hash_table_t * table, object_string_t * key, val
     if (!table->count) {
         return false;
     }
-
-    value_hash_table_entry_t * entry = hash_table_find_entry(table->entries, table->capacity, key);
-    // The entry we found does not correspond to the key
-    if (!entry->key) {
+    int64_t slot = hash_table_find_slot(table, key);
+    if (slot < 0) {
         return false;
     }
-
-    *value = entry->value;
+    *value = table->entries[slot].value;
     return true;
 }
 
 void value_hash_table_remove_white(value_hash_table_t * table) {
+    // The table is not shrunk here, because memory can not be allocated during a garbage collection
     for (uint32_t i = 0; i < table->capacity; i++) {
         value_hash_table_entry_t * entry = &table->entries[i];
-        if (entry->key && !entry->key->obj.isMarked) {
-            value_hash_table_delete(table, entry->key);
+        if (entry->key && !object_is_marked(&entry->key->obj)) {
+            hash_table_delete_slot(table, i);
         }
     }
 }
 
+void value_hash_table_reserve(value_hash_table_t * table, uint32_t count) {
+    uint32_t capacity = table->capacity ? table->capacity : TABLE_MIN_CAPACITY;
+    while (count > capacity * TABLE_MAX_LOAD) {
+        capacity *= HASH_TABLE_GROWTH_FACTOR;
+    }
+    if (capacity > table->capacity) {
+        hash_table_adjust_capacity(table, capacity);
+    }
+}
+
 bool value_hash_table_set(value_hash_table_t * table, object_string_t * key, value_t value) {
-    if (table->count + 1 > table->capacity * TABLE_MAX_LOAD) {
-        uint32_t capacity = GROW_HASHTABLE_CAPACITY(table->capacity);
+    if (table->count + table->tombstones + 1 > table->capacity * TABLE_MAX_LOAD) {
+        // If most of the used slots are tombstones, rehashing the table at the same capacity is sufficient
+        uint32_t capacity = (table->count + 1) * 2 > table->capacity * TABLE_MAX_LOAD
+                                ? GROW_HASHTABLE_CAPACITY(table->capacity)
+                                : table->capacity;
         hash_table_adjust_capacity(table, capacity);
+    } else if (table->deletions && table->capacity > TABLE_MIN_CAPACITY &&
+               table->count < table->capacity * TABLE_MIN_LOAD) {
+        // Entries that were removed during a garbage collection can leave the table sparse
+        hash_table_adjust_capacity(table, hash_table_shrunk_capacity(table));
     }
-    value_hash_table_entry_t * entry = hash_table_find_entry(table->entries, table->capacity, key);
-    bool isNewKey = !entry->key;
-    if (isNewKey && IS_NULL(entry->value)) {
-        table->count++;
+    int64_t slot = hash_table_find_slot(table, key);
+    if (slot >= 0) {
+        table->entries[slot].value = value;
+        return false;
     }
-    entry->key = key;
-    entry->value = value;
-    return isNewKey;
+    uint32_t index = hash_table_find_free_slot(table->control, table->capacity, key->hash);
+    if (table->control[index] == HASH_TABLE_CONTROL_DELETED) {
+        table->tombstones--;
+    }
+    table->count++;
+    hash_table_set_control(table->control, table->capacity, index, HASH_TABLE_H2(key->hash));
+    table->entries[index].key = key;
+    table->entries[index].value = value;
+    return true;
 }
 
 /// @brief Adjusts the capicity of a hashtable
 /// @param table The hashtable where the capacity is changed
 /// @param capacity The new capacity of the hashtable
-/// @details  We grow the hashtable when it becomes 75% is filled,
-/// so we can wrap around the entries when we look for a key,
-/// without risking an infinite loop when the hashtable is full.
-static void hash_table_adjust_capacity(value_hash_table_t * table, int32_t capacity) {
+/// @details  We grow the hashtable when it becomes 87.5% is filled,
+/// so there is always an empty slot that ends the probe sequence of a key that is not present.
+static void hash_table_adjust_capacity(value_hash_table_t * table, uint32_t capacity) {
     value_hash_table_entry_t * entries = ALLOCATE(value_hash_table_entry_t, capacity);
+    uint8_t * control = ALLOCATE(uint8_t, capacity + HASH_TABLE_GROUP_WIDTH);
     for (uint32_t i = 0; i < capacity; i++) {
         entries[i].key = NULL;
         entries[i].value = NULL_VAL;
     }
-    table->count = 0;
+    memset(control, HASH_TABLE_CONTROL_EMPTY, capacity + HASH_TABLE_GROUP_WIDTH);
+    table->count = table->tombstones = table->deletions = 0;
     for (uint32_t i = 0; i < table->capacity; i++) {
         value_hash_table_entry_t * entry = table->entries + i;
         if (!entry->key) {
             continue;
         }
-        value_hash_table_entry_t * dest = hash_table_find_entry(entries, capacity, entry->key);
-        dest->key = entry->key;
-        dest->value = entry->value;
+        uint32_t index = hash_table_find_free_slot(control, capacity, entry->key->hash);
+        hash_table_set_control(control, capacity, index, HASH_TABLE_H2(entry->key->hash));
+        entries[index] = *entry;
         table->count++;
     }
     FREE_ARRAY(value_hash_table_entry_t, table->entries, table->capacity);
+    if (table->control) {
+        FREE_ARRAY(uint8_t, table->control, table->capacity + HASH_TABLE_GROUP_WIDTH);
+    }
     table->entries = entries;
+    table->control = control;
     table->capacity = capacity;
 }
 
-/// @brief Looks up an entry in the hashtable
-/// @param entries The entries of the hashtable that is searched
-/// @param capacity The capacity of the hashtable
+/// @brief Deletes the entry that is stored in a slot of the hashtable
+/// @param table The hashtable where the entry is deleted
+/// @param index The index of the slot
+/// @details A probe sequence only continues after a group without empty slots. If the slot is part of a run of less
+/// than a group of non-empty slots, no probe sequence has ever passed it and the slot can be marked as empty again.
+/// Otherwise the control byte is replaced with a tombstone.
+static void hash_table_delete_slot(value_hash_table_t * table, uint32_t index) {
+    uint32_t mask = table->capacity - 1;
+    uint32_t emptyAfter = hash_table_group_match_empty(table->control + index);
+    uint32_t emptyBefore = hash_table_group_match_empty(table->control + ((index - HASH_TABLE_GROUP_WIDTH) & mask));
+    // Tables that are smaller than a group always contain an empty slot in every group
+    bool wasNeverFull = table->capacity < HASH_TABLE_GROUP_WIDTH ||
+                        (emptyAfter && emptyBefore &&
+                         hash_table_lowest_bit(emptyAfter) + hash_table_leading_zero_bits(emptyBefore) <
+                             HASH_TABLE_GROUP_WIDTH);
+    if (wasNeverFull) {
+        hash_table_set_control(table->control, table->capacity, index, HASH_TABLE_CONTROL_EMPTY);
+    } else {
+        hash_table_set_control(table->control, table->capacity, index, HASH_TABLE_CONTROL_DELETED);
+        table->tombstones++;
+    }
+    table->count--;
+    table->deletions++;
+    table->entries[index].key = NULL;
+    table->entries[index].value = NULL_VAL;
+}
+
+/// @brief Looks up the slot of a key in the hashtable
+/// @param table The hashtable that is searched
 /// @param key The key of the hashtable that is looked up
-/// @return Returns the entry or NULL if the value has already been deleted
-static value_hash_table_entry_t * hash_table_find_entry(value_hash_table_entry_t * entries, int32_t capacity,
-                                                        object_string_t * key) {
-    uint32_t index = key->hash & (capacity - 1);
-    value_hash_table_entry_t * tombstone = NULL;
-    for (;;) {
-        value_hash_table_entry_t * entry = &entries[index];
-        if (!entry->key) {
-            if (IS_NULL(entry->value)) {
-                /// Empty entry.
-                return tombstone != NULL ? tombstone : entry;
-            } else {
-                /* We found a tombstone. 😱
-                 * A tombstone marks the slot of a value that has already been deleted.
-                 * This is done so because when we look up an entry that has been moved by a collision,
-                 * the entry that has occupied the slot where the collision occured has been deleted,
-                 * so we need a value to indicate that another value prevouisly occupied the slot so we don't stop
-                 * looking for the entry
-                 */
-                if (!tombstone) {
-                    tombstone = entry;
-                }
+/// @return The index of the slot or -1 if the key is not present
+static int64_t hash_table_find_slot(value_hash_table_t * table, object_string_t * key) {
+    uint32_t mask = table->capacity - 1;
+    uint8_t h2 = HASH_TABLE_H2(key->hash);
+    uint32_t position = HASH_TABLE_H1(key->hash) & mask;
+    for (uint32_t stride = HASH_TABLE_GROUP_WIDTH;; stride += HASH_TABLE_GROUP_WIDTH) {
+        uint8_t const * group = table->control + position;
+        for (uint32_t matches = hash_table_group_match(group, h2); matches; matches &= matches - 1) {
+            uint32_t index = (position + hash_table_lowest_bit(matches)) & mask;
+            if (table->entries[index].key == key) {
+                return index; // We found the key 🔑
             }
-        } else if (entry->key == key) {
-            return entry; // We found the key 🔑
         }
-        index = (index + 1) & (capacity - 1);
+        if (hash_table_group_match_empty(group)) {
+            return -1;
+        }
+        position = (position + stride) & mask;
+    }
+}
+
+/// @brief Finds the first empty or deleted slot in the probe sequence of a hashvalue
+/// @param control The control bytes of the hashtable
+/// @param capacity The capacity of the hashtable
+/// @param hash The hashvalue
+/// @return The index of the slot
+static uint32_t hash_table_find_free_slot(uint8_t const * control, uint32_t capacity, uint32_t hash) {
+    uint32_t mask = capacity - 1;
+    uint32_t position = HASH_TABLE_H1(hash) & mask;
+    for (uint32_t stride = HASH_TABLE_GROUP_WIDTH;; stride += HASH_TABLE_GROUP_WIDTH) {
+        uint32_t matches = hash_table_group_match_free(control + position);
+        if (matches) {
+            return (position + hash_table_lowest_bit(matches)) & mask;
+        }
+        position = (position + stride) & mask;
+    }
+}
+
+/// @brief Determines the slots of a group whose control byte is equal to the given hash fragment
+/// @param group The control bytes of the group
+/// @param h2 The hash fragment
+/// @return A bitmask where bit i is set if the i-th slot of the group matches
+static uint32_t hash_table_group_match(uint8_t const * group, uint8_t h2) {
+#ifdef HASH_TABLE_SSE2
+    __m128i controlBytes = _mm_loadu_si128((__m128i const *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(controlBytes, _mm_set1_epi8((char)h2)));
+#else
+    uint32_t matches = 0u;
+    for (uint32_t i = 0; i < HASH_TABLE_GROUP_WIDTH; i++) {
+        matches |= (uint32_t)(group[i] == h2) << i;
+    }
+    return matches;
+#endif
+}
+
+/// @brief Determines the slots of a group that have never been used
+/// @param group The control bytes of the group
+/// @return A bitmask where bit i is set if the i-th slot of the group is empty
+static uint32_t hash_table_group_match_empty(uint8_t const * group) {
+    return hash_table_group_match(group, HASH_TABLE_CONTROL_EMPTY);
+}
+
+/// @brief Determines the slots of a group that are either empty or deleted
+/// @param group The control bytes of the group
+/// @return A bitmask where bit i is set if the i-th slot of the group can be used for a new entry
+static uint32_t hash_table_group_match_free(uint8_t const * group) {
+#ifdef HASH_TABLE_SSE2
+    // The highest bit of the control byte is only set for empty and deleted slots
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((__m128i const *)group));
+#else
+    uint32_t matches = 0u;
+    for (uint32_t i = 0; i < HASH_TABLE_GROUP_WIDTH; i++) {
+        matches |= (uint32_t)(group[i] >> 7u) << i;
+    }
+    return matches;
+#endif
+}
+
+/// @brief Determines the number of leading zero bits in the bitmask of a group
+/// @param bits The bitmask of the group
+/// @return The number of consecutive slots at the end of the group whose bit is not set
+static uint32_t hash_table_leading_zero_bits(uint32_t bits) {
+    uint32_t count = 0u;
+    for (uint32_t bit = 1u << (HASH_TABLE_GROUP_WIDTH - 1u); bit && !(bits & bit); bit >>= 1u) {
+        count++;
+    }
+    return count;
+}
+
+/// @brief Determines the index of the lowest bit that is set in a non-zero bitmask
+/// @param bits The bitmask
+/// @return The index of the lowest set bit
+static uint32_t hash_table_lowest_bit(uint32_t bits) {
+#if defined(COMPILER_GCC) || defined(COMPILER_CLANG)
+    return (uint32_t)__builtin_ctz(bits);
+#else
+    uint32_t index = 0u;
+    while (!(bits & 1u)) {
+        bits >>= 1u;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/// @brief Sets the control byte of a slot
+/// @param control The control bytes of the hashtable
+/// @param capacity The capacity of the hashtable
+/// @param index The index of the slot
+/// @param value The new value of the control byte
+/// @details The control bytes after the last slot mirror the first slots, so a group can be loaded at every position
+/// without wrapping around. Tables that are smaller than a group contain every slot multiple times.
+static void hash_table_set_control(uint8_t * control, uint32_t capacity, uint32_t index, uint8_t value) {
+    control[index] = value;
+    for (uint32_t mirror = index + capacity; mirror < capacity + HASH_TABLE_GROUP_WIDTH; mirror += capacity) {
+        control[mirror] = value;
+    }
+}
+
+/// @brief Determines the capacity a sparse hashtable is shrunk to
+/// @param table The hashtable
+/// @return The halved capacity until the table is at least filled to a quarter or the min capacity is reached
+static uint32_t hash_table_shrunk_capacity(value_hash_table_t * table) {
+    uint32_t capacity = table->capacity;
+    while (capacity > TABLE_MIN_CAPACITY && (table->count + 1) * 4 < capacity) {
+        capacity /= 2;
     }
+    return capacity;
 }
@@ -34,14 +34,26 @@ typedef struct {
 } value_hash_table_entry_t;
 
 /// @brief A hashtable
-/// @details The hashtable uses seperate chaining if a hashcollision occurs
+/// @details The hashtable is organized as a swiss table. Besides the entries the hashtable stores a control byte for
+/// every slot. The control byte contains the lower 7 bits of the hashvalue of the key or marks the slot as empty or
+/// deleted. The control bytes are probed in groups of 16 slots, so most lookups never touch an entry whose key does
+/// not match. Slots without a key always have a NULL key, so the entries can be iterated directly.
+/// Deleted slots only become tombstones if a probe sequence might have passed them. The tombstones are dropped by an
+/// in-place rehash when they fill up the table and tables that became sparse through deletions are shrunk when the next
+/// entry is inserted.
 typedef struct {
     /// Number of entries in the hashtable
     uint32_t count;
     /// The capacity of the hashtable
     uint32_t capacity;
+    /// Number of slots that are marked as deleted
+    uint32_t tombstones;
+    /// Number of entries that were deleted since the capacity has been adjusted the last time
+    uint32_t deletions;
     /// Pointer to the first entry that is stored in the hashtable
     value_hash_table_entry_t * entries;
+    /// The control bytes of the slots, followed by a copy of the first group
+    uint8_t * control;
 } value_hash_table_t;
 
 /// @brief Dealocates the memory used by the hashtable
@@ -88,6 +100,11 @@ bool value_hash_table_get(value_hash_table_t * table, object_string_t * key, val
 /// @param table The table where all the values marked as white (not reachable) are removed
 void value_hash_table_remove_white(value_hash_table_t * table);
 
+/// @brief Grows the hashtable, so the given amount of entries can be stored without growing it again
+/// @param table The hashtable that is grown
+/// @param count The amount of entries
+void value_hash_table_reserve(value_hash_table_t * table, uint32_t count);
+
 /// @brief Changes the value corresponding to the key or creates a new entry if no entry corespronding to the key has
 /// been found
 /// @param table The table where the entry is changed or inserted
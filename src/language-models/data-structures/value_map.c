@@ -0,0 +1,204 @@
+/****************************************************************************
+ * Copyright (C) 2022 by Frederik Tobner                                    *
+ *                                                                          *
+ * This file is part of Cellox.                                             *
+ *                                                                          *
+ * Permission to use, copy, modify, and distribute this software and its    *
+ * documentation under the terms of the GNU General Public License is       *
+ * hereby granted.                                                          *
+ * No representations are made about the suitability of this software for   *
+ * any purpose.                                                             *
+ * It is provided "as is" without express or implied warranty.              *
+ * See the <https://www.gnu.org/licenses/gpl-3.0.html/>GNU General Public   *
+ * License for more details.                                                *
+ ****************************************************************************/
+
+/**
+ * @file value_map.c
+ * @brief File containing the implementation of the hashtable that maps arbitrary values to values
+ */
+#include "value_map.h"
+
+#include <string.h>
+
+#include "../../backend/garbage_collector.h"
+#include "../../backend/memory_mutator.h"
+#include "../object.h"
+
+/// @brief Determines whether a map with the given capacity needs to grow before it can store count entries
+/// @details The map grows when it becomes 75% filled, so a probe sequence always ends at an empty entry
+#define VALUE_MAP_EXCEEDS_MAX_LOAD(count, capacity) ((uint64_t)(count)*4u > (uint64_t)(capacity)*3u)
+
+static void value_map_adjust_capacity(value_map_t *, uint32_t);
+static value_map_entry_t * value_map_find_entry(value_map_entry_t *, uint32_t, value_t, uint32_t);
+static inline bool value_map_keys_equal(value_t, value_t);
+
+bool value_map_delete(value_map_t * map, value_t key) {
+    if (!map->count) {
+        return false;
+    }
+    value_map_entry_t * entry = value_map_find_entry(map->entries, map->capacity, key, value_map_hash_key(key));
+    if (!entry->hash) {
+        return false;
+    }
+    uint32_t mask = map->capacity - 1u;
+    uint32_t hole = (uint32_t)(entry - map->entries);
+    // The following entries of the probe sequence are moved into the hole, if they would be skipped otherwise
+    for (uint32_t next = (hole + 1u) & mask; map->entries[next].hash; next = (next + 1u) & mask) {
+        uint32_t home = map->entries[next].hash & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            map->entries[hole] = map->entries[next];
+            hole = next;
+        }
+    }
+    map->entries[hole].key = map->entries[hole].value = NULL_VAL;
+    map->entries[hole].hash = 0u;
+    map->count--;
+    map->modificationCount++;
+    return true;
+}
+
+void value_map_free(value_map_t * map) {
+    FREE_ARRAY(value_map_entry_t, map->entries, map->capacity);
+    value_map_init(map);
+}
+
+bool value_map_get(value_map_t * map, value_t key, value_t * value) {
+    if (!map->count) {
+        return false;
+    }
+    value_map_entry_t * entry = value_map_find_entry(map->entries, map->capacity, key, value_map_hash_key(key));
+    if (!entry->hash) {
+        return false;
+    }
+    *value = entry->value;
+    return true;
+}
+
+uint32_t value_map_hash_key(value_t key) {
+    uint64_t bits;
+    if (IS_STRING(key)) {
+        bits = object_string_hash(AS_STRING(key));
+    } else if (IS_NUMBER(key)) {
+        // Adding zero turns negative zero into positive zero, because both are equal
+        double number = AS_NUMBER(key) + 0.0;
+        memcpy(&bits, &number, sizeof(bits));
+    } else if (IS_BOUND_METHOD(key)) {
+        // Equal bound methods are different objects that bind the same method to the same receiver
+        bits = value_map_hash_key(AS_BOUND_METHOD(key)->receiver) ^ (uint64_t)(uintptr_t)AS_BOUND_METHOD(key)->method;
+    } else if (IS_OBJECT(key)) {
+        bits = (uint64_t)(uintptr_t)AS_OBJECT(key);
+    } else if (IS_BOOL(key)) {
+        bits = AS_BOOL(key) ? 1u : 2u;
+    } else {
+        bits = 3u;
+    }
+    // The bits are mixed (finalizer of MurmurHash3), so similar keys do not end up in the same probe sequence
+    bits ^= bits >> 33u;
+    bits *= 0xff51afd7ed558ccdull;
+    bits ^= bits >> 33u;
+    uint32_t hash = (uint32_t)bits;
+    return hash ? hash : 1u;
+}
+
+void value_map_init(value_map_t * map) {
+    map->count = map->capacity = map->modificationCount = 0u;
+    map->entries = NULL;
+}
+
+void value_map_mark(value_map_t * map) {
+    for (uint32_t i = 0; i < map->capacity; i++) {
+        value_map_entry_t * entry = map->entries + i;
+        if (entry->hash) {
+            garbage_collector_mark_value(entry->key);
+            garbage_collector_mark_value(entry->value);
+        }
+    }
+}
+
+void value_map_reserve(value_map_t * map, uint32_t count) {
+    uint32_t capacity = map->capacity ? map->capacity : 8u;
+    while (VALUE_MAP_EXCEEDS_MAX_LOAD(count, capacity) && capacity < (1u << 31)) {
+        capacity *= HASH_TABLE_GROWTH_FACTOR;
+    }
+    if (capacity > map->capacity) {
+        value_map_adjust_capacity(map, capacity);
+    }
+}
+
+bool value_map_set(value_map_t * map, value_t key, value_t value) {
+    // The key is hashed first, because hashing a rope flattens it
+    uint32_t hash = value_map_hash_key(key);
+    value_map_entry_t * entry = map->capacity ? value_map_find_entry(map->entries, map->capacity, key, hash) : NULL;
+    bool isNewKey = !entry || !entry->hash;
+    if (isNewKey) {
+        // The map only grows if a key is added, so changing the value of a key never moves the entries
+        if (VALUE_MAP_EXCEEDS_MAX_LOAD(map->count + 1u, map->capacity)) {
+            value_map_adjust_capacity(map, GROW_HASHTABLE_CAPACITY(map->capacity));
+            entry = value_map_find_entry(map->entries, map->capacity, key, hash);
+        }
+        entry->key = key;
+        entry->hash = hash;
+        map->count++;
+        map->modificationCount++;
+    }
+    entry->value = value;
+    return isNewKey;
+}
+
+/// @brief Adjusts the capacity of a map
+/// @param map The map where the capacity is changed
+/// @param capacity The new capacity of the map
+static void value_map_adjust_capacity(value_map_t * map, uint32_t capacity) {
+    value_map_entry_t * entries = ALLOCATE(value_map_entry_t, capacity);
+    for (uint32_t i = 0; i < capacity; i++) {
+        entries[i].key = entries[i].value = NULL_VAL;
+        entries[i].hash = 0u;
+    }
+    for (uint32_t i = 0; i < map->capacity; i++) {
+        value_map_entry_t * entry = map->entries + i;
+        if (!entry->hash) {
+            continue;
+        }
+        // The keys are unique, so the entry is stored in the first empty entry of its probe sequence
+        uint32_t index = entry->hash & (capacity - 1u);
+        while (entries[index].hash) {
+            index = (index + 1u) & (capacity - 1u);
+        }
+        entries[index] = *entry;
+    }
+    FREE_ARRAY(value_map_entry_t, map->entries, map->capacity);
+    map->entries = entries;
+    map->capacity = capacity;
+    map->modificationCount++;
+}
+
+/// @brief Looks up an entry in the map
+/// @param entries The entries of the map that is searched
+/// @param capacity The capacity of the map
+/// @param key The key that is looked up
+/// @param hash The hash value of the key
+/// @return The entry that contains the key or the empty entry where the key would be stored
+static value_map_entry_t * value_map_find_entry(value_map_entry_t * entries, uint32_t capacity, value_t key,
+                                                uint32_t hash) {
+    uint32_t index = hash & (capacity - 1u);
+    for (;;) {
+        value_map_entry_t * entry = entries + index;
+        if (!entry->hash || (entry->hash == hash && value_map_keys_equal(entry->key, key))) {
+            return entry;
+        }
+        index = (index + 1u) & (capacity - 1u);
+    }
+}
+
+/// @brief Determines whether two keys are equal
+/// @param a The first key
+/// @param b The second key
+/// @return true if the keys are equal, false if not
+static inline bool value_map_keys_equal(value_t a, value_t b) {
+    // Arrays are compared by their identity, otherwise changing an array would change the hash value of a key
+    if (IS_ARRAY(a) || IS_ARRAY(b)) {
+        return IS_ARRAY(a) && IS_ARRAY(b) && AS_ARRAY(a) == AS_ARRAY(b);
+    }
+    return value_values_equal(a, b);
+}
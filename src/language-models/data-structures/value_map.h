@@ -0,0 +1,99 @@
+/****************************************************************************
+ * Copyright (C) 2022 by Frederik Tobner                                    *
+ *                                                                          *
+ * This file is part of Cellox.                                             *
+ *                                                                          *
+ * Permission to use, copy, modify, and distribute this software and its    *
+ * documentation under the terms of the GNU General Public License is       *
+ * hereby granted.                                                          *
+ * No representations are made about the suitability of this software for   *
+ * any purpose.                                                             *
+ * It is provided "as is" without express or implied warranty.              *
+ * See the <https://www.gnu.org/licenses/gpl-3.0.html/>GNU General Public   *
+ * License for more details.                                                *
+ ****************************************************************************/
+
+/**
+ * @file value_map.h
+ * @brief Header file for the hashtable that maps arbitrary values to values
+ */
+
+#ifndef CELLOX_VALUE_MAP_H_
+#define CELLOX_VALUE_MAP_H_
+
+#include "../../common.h"
+#include "../value.h"
+
+/// @brief An entry in a value map
+typedef struct {
+    /// The key of the entry
+    value_t key;
+    /// The value that is associated with the key
+    value_t value;
+    /// The hash value of the key (zero if the entry is empty)
+    uint32_t hash;
+} value_map_entry_t;
+
+/// @brief A hashtable that maps values to values
+/// @details The map uses open addressing with linear probing. Entries are deleted by shifting the following entries of
+/// the probe sequence backwards, so no tombstones are left behind.
+/// Strings are compared by their content, bound methods by their method and receiver, arrays and all other objects by
+/// their identity.
+typedef struct {
+    /// Number of entries in the map
+    uint32_t count;
+    /// The capacity of the map (always a power of two)
+    uint32_t capacity;
+    /// Pointer to the first entry that is stored in the map
+    value_map_entry_t * entries;
+    /// Incremented whenever a key is added or removed or the entries are moved, so a loop that iterates over the
+    /// entries can detect that the map was changed
+    uint32_t modificationCount;
+} value_map_t;
+
+/// @brief Deletes an entry in the map
+/// @param map The map where the entry is deleted
+/// @param key The key of the entry that is deleted
+/// @return A boolean value that indicates whether an entry was deleted
+bool value_map_delete(value_map_t * map, value_t key);
+
+/// @brief Dealocates the memory used by the map
+/// @param map The map where the contents are freed
+void value_map_free(value_map_t * map);
+
+/// @brief Reads the value that is associated with a key
+/// @param map The map where the entry is looked up
+/// @param key The key that is used for searching for the entry
+/// @param value Stores the value corresponding to the key in the passed value parameter
+/// @return true if an entry coresponding to the given key has been found
+bool value_map_get(value_map_t * map, value_t key, value_t * value);
+
+/// @brief Calculates the hash value of a key
+/// @param key The key that is hashed
+/// @return The hash value of the key (never zero, because zero marks empty entries)
+/// @note Hashing a rope flattens it, so the key has to be reachable
+uint32_t value_map_hash_key(value_t key);
+
+/// @brief Initializes the map
+/// @param map The map that is initialized
+void value_map_init(value_map_t * map);
+
+/// @brief Marks all the keys and values in the map
+/// @param map The map where all the objects are marked
+void value_map_mark(value_map_t * map);
+
+/// @brief Grows the map, so the given amount of entries can be stored without growing it again
+/// @param map The map that is grown
+/// @param count The amount of entries
+void value_map_reserve(value_map_t * map, uint32_t count);
+
+/// @brief Changes the value corresponding to the key or creates a new entry
+/// @param map The map where the entry is changed or inserted
+/// @param key The key of the entry
+/// @param value The value that is associated with the key
+/// @return true if a new entry has been created
+/// @note Hashing the key and growing the map might trigger a garbage collection, so the map, the key and the value have
+/// to be reachable
+bool value_map_set(value_map_t * map, value_t key, value_t value);
+
+#endif
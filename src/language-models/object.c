@@ -24,57 +24,99 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../backend/garbage_collector_statistics.h"
 #include "../backend/memory_mutator.h"
 #include "../backend/virtual_machine.h"
 #include "../string_utils.h"
 
 /// Marko for allocating a new object
-#define ALLOCATE_OBJECT(type, objectType) (type *)object_allocate_object(sizeof(type), objectType)
+#define ALLOCATE_OBJECT(type, objectType)   (type *)object_allocate_object(sizeof(type), objectType)
+
+/// Maximal amount of fields the field table of a new instance is pre-sized for
+#define OBJECT_INSTANCE_MAX_RESERVED_FIELDS (64u)
+
+/// Minimal length of a concatenation that is represented by a rope (shorter results are copied right away)
+#define OBJECT_ROPE_MINIMUM_LENGTH          (64u)
+
+/// Minimal length of a slice that references its parent instead of copying the characters / values
+#define OBJECT_SLICE_MINIMUM_LENGTH         (64u)
+
+/// Slices that are this many times smaller than their parent are copied, so they don't keep the parent alive
+#define OBJECT_SLICE_PARENT_RATIO           (8u)
+
+// The object header has to fit into a single word (compile time assertion, C99 has no static_assert)
+typedef char object_header_size_check_t[sizeof(object_t) <= sizeof(uint64_t) ? 1 : -1];
 
 /// The object types of cellox as a string
-static char const * objectTypesStringified[] = {"method",          "class",  "closure", "array",  "function",
-                                                "native function", "string", "upvalue", "unknown"};
+static char const * objectTypesStringified[] = {"method", "class",  "closure",     "array",   "function", "map",
+                                                "native function", "string", "typed array", "upvalue", "unknown"};
 
 static object_t * object_allocate_object(size_t, object_type);
-static object_string_t * object_allocate_string(char *, uint32_t, uint32_t);
+static object_string_t * object_allocate_string_of_kind(size_t, object_string_kind);
+static object_string_t * object_intern_characters(char const *, uint32_t);
 static void object_print_function(object_function_t *);
+static void object_print_quoted(value_t);
+static void object_print_string_part(char const *, uint32_t, void *);
+static void object_rope_copy_part(char const *, uint32_t, void *);
+static void object_rope_traverse(object_rope_t *, void (*)(char const *, uint32_t, void *), void *);
+
+object_string_t * object_allocate_string(uint32_t length) {
+    object_string_t * string = (object_string_t *)object_allocate_object(OBJECT_STRING_SIZE(length), OBJECT_STRING);
+    string->length = length;
+    string->hash = 0u;
+    string->chars[length] = '\0';
+    return string;
+}
+
+object_string_t * object_concatenate_strings(object_string_t * a, object_string_t * b) {
+    if (!a->length) {
+        return b;
+    }
+    if (!b->length) {
+        return a;
+    }
+    uint32_t length = a->length + b->length;
+    if (length < OBJECT_ROPE_MINIMUM_LENGTH) {
+        char const * aChars = object_string_chars(a);
+        char const * bChars = object_string_chars(b);
+        object_string_t * result = object_allocate_string(length);
+        memcpy(result->chars, aChars, a->length);
+        memcpy(result->chars + a->length, bChars, b->length);
+        return result;
+    }
+    // The characters are only copied when the rope is flattened, so appending in a loop takes linear time
+    object_rope_t * rope =
+        (object_rope_t *)object_allocate_string_of_kind(sizeof(object_rope_t), OBJECT_STRING_KIND_ROPE);
+    rope->length = length;
+    rope->hash = 0u;
+    rope->left = a;
+    rope->right = b;
+    return (object_string_t *)rope;
+}
 
 object_string_t * object_copy_string(char const * chars, uint32_t length, bool removeBackSlash) {
-    uint32_t hash;
-    object_string_t * interned;
-    char * heapChars;
-
-    if (!string_utils_contains_character_restricted(chars, '\\', length)) {
-        hash = string_utils_hash_string(chars, length);
-        interned = value_hash_table_find_string(&virtualMachine.strings, chars, length, hash);
-        if (interned) {
-            return interned;
-        }
-        heapChars = ALLOCATE(char, length + 1);
-        memcpy(heapChars, chars, length);
-        heapChars[length] = '\0';
-    } else {
-        heapChars = ALLOCATE(char, length + 1);
-        memcpy(heapChars, chars, length);
-        heapChars[length] = '\0';
-        char * next = NULL;
-        for (uint32_t i = 0; i < length; i++) {
-            if (heapChars[i] == '\\') {
-                if (string_utils_resolve_escape_sequence(&heapChars[i], &length)) {
-                    return NULL;
-                }
+    if (!removeBackSlash || !string_utils_contains_character_restricted(chars, '\\', length)) {
+        return object_intern_characters(chars, length);
+    }
+    // The escape sequences are resolved in a null-terminated buffer, because resolving them shortens the string
+    char * buffer = (char *)malloc(length + 1u);
+    if (!buffer) {
+        virtual_machine_out_of_memory(length + 1u);
+    }
+    memcpy(buffer, chars, length);
+    buffer[length] = '\0';
+    uint32_t resolvedLength = length;
+    for (uint32_t i = 0; i < resolvedLength; i++) {
+        if (buffer[i] == '\\') {
+            if (string_utils_resolve_escape_sequence(&buffer[i], &resolvedLength)) {
+                free(buffer);
+                return NULL;
             }
         }
-        // We have to look again for duplicates in the hashtable storing the strings allocated by the virtualMachine
-        hash = string_utils_hash_string(heapChars, length);
-        interned = value_hash_table_find_string(&virtualMachine.strings, heapChars, length, hash);
-        if (interned) {
-            free(heapChars);
-            return interned;
-        }
     }
-
-    return object_allocate_string(heapChars, strlen(heapChars), hash);
+    object_string_t * string = object_intern_characters(buffer, resolvedLength);
+    free(buffer);
+    return string;
 }
 
 object_bound_method_t * object_new_bound_method(value_t receiver, object_closure_t * method) {
@@ -87,25 +129,29 @@ object_bound_method_t * object_new_bound_method(value_t receiver, object_closure
 object_class_t * object_new_class(object_string_t * name) {
     object_class_t * celloxClass = ALLOCATE_OBJECT(object_class_t, OBJECT_CLASS);
     celloxClass->name = name;
-    value_hash_table_init(&celloxClass->methods);
+    value_hash_table_init(&celloxClass->methodSlots);
+    dynamic_value_array_init(&celloxClass->methods);
+    celloxClass->initializer = NULL;
+    celloxClass->fieldCount = 0u;
     return celloxClass;
 }
 
 object_dynamic_value_array_t * object_new_dynamic_value_array(void) {
     object_dynamic_value_array_t * array = ALLOCATE_OBJECT(object_dynamic_value_array_t, OBJECT_ARRAY);
     dynamic_value_array_init(&array->array);
+    array->backing = NULL;
     return array;
 }
 
 object_closure_t * object_new_closure(object_function_t * function) {
-    object_upvalue_t ** upvalues = ALLOCATE(object_upvalue_t *, function->upvalueCount);
-    for (uint32_t i = 0; i < function->upvalueCount; i++) {
-        upvalues[i] = NULL;
-    }
-    object_closure_t * closure = ALLOCATE_OBJECT(object_closure_t, OBJECT_CLOSURE);
+    // The upvalues are stored inline, so a closure only needs a single allocation
+    object_closure_t * closure =
+        (object_closure_t *)object_allocate_object(OBJECT_CLOSURE_SIZE(function->upvalueCount), OBJECT_CLOSURE);
     closure->function = function;
-    closure->upvalues = upvalues;
     closure->upvalueCount = function->upvalueCount;
+    for (uint32_t i = 0; i < function->upvalueCount; i++) {
+        closure->upvalues[i] = NULL;
+    }
     return closure;
 }
 
@@ -122,6 +168,15 @@ object_instance_t * object_new_instance(object_class_t * celloxClass) {
     object_instance_t * instance = ALLOCATE_OBJECT(object_instance_t, OBJECT_INSTANCE);
     instance->celloxClass = celloxClass;
     value_hash_table_init(&instance->fields);
+    if (celloxClass->fieldCount) {
+        uint32_t fieldCount = celloxClass->fieldCount < OBJECT_INSTANCE_MAX_RESERVED_FIELDS
+                                  ? celloxClass->fieldCount
+                                  : OBJECT_INSTANCE_MAX_RESERVED_FIELDS;
+        // The instance stays on the stack, because reserving the field table might trigger a garbage collection
+        virtual_machine_push(OBJECT_VAL(instance));
+        value_hash_table_reserve(&instance->fields, fieldCount);
+        virtual_machine_pop();
+    }
     return instance;
 }
 
@@ -131,6 +186,101 @@ object_native_t * object_new_native(native_function_t function) {
     return native;
 }
 
+object_dynamic_value_array_t * object_new_array_copy(object_dynamic_value_array_t * constant) {
+    object_dynamic_value_array_t * array = object_new_dynamic_value_array();
+    // The constant owns its values and is never mutated, so it can be used as the backing array directly
+    array->backing = constant;
+    array->array.values = constant->array.values;
+    array->array.count = constant->array.count;
+    object_array_track_values(array, constant);
+    return array;
+}
+
+object_dynamic_value_array_t * object_new_array_slice(object_dynamic_value_array_t * array, uint32_t start,
+                                                      uint32_t count) {
+    object_dynamic_value_array_t * slice = object_new_dynamic_value_array();
+    virtual_machine_push(OBJECT_VAL(slice));
+    if (count < OBJECT_SLICE_MINIMUM_LENGTH || count < array->array.count / OBJECT_SLICE_PARENT_RATIO) {
+        slice->array.values = ALLOCATE(value_t, count);
+        slice->array.capacity = slice->array.count = count;
+        memcpy(slice->array.values, array->array.values + start, sizeof(value_t) * count);
+    } else {
+        if (!array->backing) {
+            // The values are handed over to a backing array that is shared by the array and all of its slices
+            object_dynamic_value_array_t * backing = object_new_dynamic_value_array();
+            object_array_track_values(backing, array);
+            backing->array = array->array;
+            array->backing = backing;
+            array->array.capacity = 0u;
+        }
+        slice->backing = array->backing;
+        slice->array.values = array->array.values + start;
+        slice->array.count = count;
+    }
+    // A slice of an array that only contains numbers only contains numbers as well
+    object_array_track_values(slice, array);
+    virtual_machine_pop();
+    return slice;
+}
+
+object_string_t * object_new_string(char const * chars, uint32_t length) {
+    object_string_t * string = object_allocate_string(length);
+    memcpy(string->chars, chars, length);
+    return string;
+}
+
+object_string_t * object_new_string_slice(object_string_t * string, uint32_t start, uint32_t length) {
+    char const * chars = object_string_chars(string);
+    object_string_t * parent = string;
+    uint32_t offset = start;
+    if (object_string_get_kind(string) == OBJECT_STRING_KIND_ROPE) {
+        // The rope has been flattened
+        parent = ((object_rope_t *)string)->left;
+    } else if (object_string_get_kind(string) == OBJECT_STRING_KIND_SLICE) {
+        // Slices always reference a flat string, so there are no chains of slices
+        parent = ((object_string_slice_t *)string)->parent;
+        offset += ((object_string_slice_t *)string)->offset;
+    }
+    if (length == 1u) {
+        return virtual_machine_character_string(chars[start]);
+    }
+    if (length < OBJECT_SLICE_MINIMUM_LENGTH || length < parent->length / OBJECT_SLICE_PARENT_RATIO) {
+        return object_new_string(chars + start, length);
+    }
+    object_string_slice_t * slice = (object_string_slice_t *)object_allocate_string_of_kind(
+        sizeof(object_string_slice_t), OBJECT_STRING_KIND_SLICE);
+    slice->length = length;
+    slice->hash = 0u;
+    slice->parent = parent;
+    slice->offset = offset;
+    return (object_string_t *)slice;
+}
+
+object_map_t * object_new_map(void) {
+    object_map_t * map = ALLOCATE_OBJECT(object_map_t, OBJECT_MAP);
+    value_map_init(&map->map);
+    return map;
+}
+
+object_typed_array_t * object_new_typed_array(object_typed_array_type type, uint32_t count) {
+    object_typed_array_t * array = ALLOCATE_OBJECT(object_typed_array_t, OBJECT_TYPED_ARRAY);
+    array->type = type;
+    array->count = 0u;
+    array->elements = array->allocation = NULL;
+    // The array is kept on the stack, because allocating the elements might trigger a garbage collection
+    virtual_machine_push(OBJECT_VAL(array));
+    size_t size = count * object_typed_array_element_size(type);
+    // The buffer is over-allocated, so the elements can start at an aligned address
+    array->allocation = ALLOCATE(uint8_t, size + OBJECT_TYPED_ARRAY_ALIGNMENT);
+    uintptr_t address = (uintptr_t)array->allocation;
+    address = (address + OBJECT_TYPED_ARRAY_ALIGNMENT - 1u) & ~(uintptr_t)(OBJECT_TYPED_ARRAY_ALIGNMENT - 1u);
+    array->elements = (void *)address;
+    memset(array->elements, 0, size);
+    array->count = count;
+    virtual_machine_pop();
+    return array;
+}
+
 object_upvalue_t * object_new_upvalue(value_t * slot) {
     // Allocating the memory used by the upvalue
     object_upvalue_t * upvalue = ALLOCATE_OBJECT(object_upvalue_t, OBJECT_UPVALUE);
@@ -183,13 +333,7 @@ void object_print(value_t value) {
             for (size_t i = 0; i < instance->fields.capacity; i++) {
                 if (instance->fields.entries[i].key != NULL) {
                     printf("%s: ", instance->fields.entries[i].key->chars);
-                    if (IS_STRING(instance->fields.entries[i].value)) {
-                        putc('"', stdout);
-                    }
-                    value_print(instance->fields.entries[i].value);
-                    if (IS_STRING(instance->fields.entries[i].value)) {
-                        putc('"', stdout);
-                    }
+                    object_print_quoted(instance->fields.entries[i].value);
                     if (fieldCounter-- > 1) {
                         printf(", ");
                     }
@@ -198,38 +342,144 @@ void object_print(value_t value) {
             putc('}', stdout);
             break;
         }
+    case OBJECT_MAP:
+        {
+            value_map_t * map = &AS_MAP(value)->map;
+            uint32_t entryCounter = map->count;
+            putc('{', stdout);
+            for (uint32_t i = 0; i < map->capacity; i++) {
+                if (map->entries[i].hash) {
+                    object_print_quoted(map->entries[i].key);
+                    printf(": ");
+                    object_print_quoted(map->entries[i].value);
+                    if (entryCounter-- > 1) {
+                        printf(", ");
+                    }
+                }
+            }
+            putc('}', stdout);
+            break;
+        }
     case OBJECT_NATIVE:
         printf("<native fn>");
         break;
     case OBJECT_STRING:
-        printf("%s", AS_CSTRING(value));
-        break;
+        {
+            object_string_t * string = AS_STRING(value);
+            if (object_string_get_kind(string) == OBJECT_STRING_KIND_ROPE) {
+                // Printing a rope does not flatten it, because objects are also printed during a garbage collection
+                object_rope_traverse((object_rope_t *)string, object_print_string_part, stdout);
+            } else {
+                object_print_string_part(object_string_chars(string), string->length, stdout);
+            }
+            break;
+        }
+    case OBJECT_TYPED_ARRAY:
+        {
+            object_typed_array_t * array = AS_TYPED_ARRAY(value);
+            putc('{', stdout);
+            for (uint32_t i = 0; i < array->count; i++) {
+                value_print(NUMBER_VAL(object_typed_array_get(array, i)));
+                if (i != array->count - 1) {
+                    printf(", ");
+                }
+            }
+            putc('}', stdout);
+            break;
+        }
     case OBJECT_UPVALUE:
         printf("upvalue");
         break;
     }
 }
 
-object_string_t * object_take_string(char * chars, uint32_t length) {
+void object_array_copy_borrowed_values(object_dynamic_value_array_t * array) {
+    // The backing array stays reachable through the array until the values have been copied
+    value_t * values = ALLOCATE(value_t, array->array.count);
+    memcpy(values, array->array.values, sizeof(value_t) * array->array.count);
+    array->array.values = values;
+    array->array.capacity = array->array.count;
+    array->backing = NULL;
+}
+
+char const * object_string_cstring(object_string_t * string) {
+    char const * chars = object_string_chars(string);
+    if (chars[string->length] == '\0') {
+        return chars;
+    }
+    // The slice ends before the end of its parent, so the characters are copied into a flat string
+    object_string_slice_t * slice = (object_string_slice_t *)string;
+    virtual_machine_push(OBJECT_VAL(string));
+    slice->parent = object_new_string(chars, string->length);
+    slice->offset = 0u;
+    virtual_machine_pop();
+    return slice->parent->chars;
+}
+
+char const * object_string_flatten(object_string_t * string) {
+    if (object_string_get_kind(string) != OBJECT_STRING_KIND_ROPE) {
+        return object_string_chars(string);
+    }
+    object_rope_t * rope = (object_rope_t *)string;
+    if (rope->right) {
+        // The rope has to stay reachable while the flat string is allocated
+        virtual_machine_push(OBJECT_VAL(string));
+        object_string_t * flat = object_allocate_string(rope->length);
+        char * destination = flat->chars;
+        object_rope_traverse(rope, object_rope_copy_part, &destination);
+        // The parts of the rope are no longer needed and can be reclaimed by the garbage collector
+        rope->left = flat;
+        rope->right = NULL;
+        virtual_machine_pop();
+    }
+    return rope->left->chars;
+}
+
+uint32_t object_string_compute_hash(object_string_t * string) {
+    string->hash = string_utils_hash_string(object_string_chars(string), string->length);
+    string->obj.header |= OBJECT_HEADER_HASHED_BIT;
+    return string->hash;
+}
+
+bool object_strings_equal(object_string_t * a, object_string_t * b) {
+    if (a == b) {
+        return true;
+    }
+    // Two different interned strings can not have the same character sequence
+    if (a->length != b->length || (object_string_is_interned(a) && object_string_is_interned(b))) {
+        return false;
+    }
+    // Hash values are only compared if they have already been calculated
+    if ((a->obj.header & b->obj.header & OBJECT_HEADER_HASHED_BIT) && a->hash != b->hash) {
+        return false;
+    }
+    char const * aChars = object_string_chars(a);
+    return !memcmp(aChars, object_string_chars(b), a->length);
+}
+
+/// @brief Allocates a string that does not store its character sequence inline
+/// @param size The size of the string object
+/// @param kind The kind of the string
+/// @return The allocated string
+static object_string_t * object_allocate_string_of_kind(size_t size, object_string_kind kind) {
+    object_string_t * string = (object_string_t *)object_allocate_object(size, OBJECT_STRING);
+    string->obj.header |= (uint64_t)kind << OBJECT_HEADER_STRING_KIND_SHIFT;
+    return string;
+}
+
+/// @brief Creates an interned string or looks up an equal string in the hashtable of the virtualMachine
+/// @param chars Pointer to the character sequence
+/// @param length The length of the character sequence
+/// @return The interned string
+static object_string_t * object_intern_characters(char const * chars, uint32_t length) {
     uint32_t hash = string_utils_hash_string(chars, length);
     object_string_t * interned = value_hash_table_find_string(&virtualMachine.strings, chars, length, hash);
     if (interned) {
-        FREE_ARRAY(char, chars, length + 1);
         return interned;
     }
-    return object_allocate_string(chars, length, hash);
-}
-
-/// @brief Creates a string allocates memory to store a string
-/// @param chars Pointer to the start of the string
-/// @param length The length of the string
-/// @param hash The hashvalue of the string
-/// @return The created string
-static object_string_t * object_allocate_string(char * chars, uint32_t length, uint32_t hash) {
-    object_string_t * string = ALLOCATE_OBJECT(object_string_t, OBJECT_STRING);
-    string->length = length;
-    string->chars = chars;
+    object_string_t * string = object_new_string(chars, length);
     string->hash = hash;
+    string->obj.header |= OBJECT_HEADER_HASHED_BIT | OBJECT_HEADER_INTERNED_BIT;
     virtual_machine_push(OBJECT_VAL(string));
     // Adds the string to hashtable storing all the strings allocated by the virtualMachine
     value_hash_table_set(&virtualMachine.strings, string, NULL_VAL);
@@ -244,13 +494,11 @@ static object_string_t * object_allocate_string(char * chars, uint32_t length, u
 static object_t * object_allocate_object(size_t size, object_type type) {
     // Allocates the memory used by the Object
     object_t * object = (object_t *)memory_mutator_reallocate(NULL, 0, size);
-    // Sets the type of the object
-    object->type = type;
-    // Disables mark so it is picked up by the Garbage Collection in the next cycle
-    object->isMarked = false;
-    // Adds the object at the start of the linked list storing the objects allocated by the virtualMachine
-    object->next = virtualMachine.objects;
+    // Sets the type of the object and disables the mark so it is picked up by the Garbage Collection in the next cycle.
+    // The object is added at the start of the linked list storing the objects allocated by the virtualMachine
+    object_init_header(object, type, virtualMachine.objects);
     virtualMachine.objects = object;
+    garbageCollectorStatistics.liveObjects[type]++;
 #ifdef DEBUG_LOG_GC
     printf("%p allocated %zu bytes for %d\n", (void *)object, size, type);
 #endif
@@ -269,8 +517,79 @@ static void object_print_function(object_function_t * function) {
     printf("<fun %s>", function->name->chars);
 }
 
+/// @brief Prints a value that is contained in a map or an instance (strings are put in quotes)
+/// @param value The value that is printed
+static void object_print_quoted(value_t value) {
+    if (IS_STRING(value)) {
+        putc('"', stdout);
+    }
+    value_print(value);
+    if (IS_STRING(value)) {
+        putc('"', stdout);
+    }
+}
+
+/// @brief Prints a flat part of a rope
+/// @param chars The character sequence of the part
+/// @param length The length of the part
+/// @param stream The stream where the part is printed
+static void object_print_string_part(char const * chars, uint32_t length, void * stream) {
+    fwrite(chars, sizeof(char), length, (FILE *)stream);
+}
+
+/// @brief Copies a flat part of a rope into the flat string that is created when the rope is flattened
+/// @param chars The character sequence of the part
+/// @param length The length of the part
+/// @param destination Pointer to the position in the flat string where the part is copied to
+static void object_rope_copy_part(char const * chars, uint32_t length, void * destination) {
+    char ** position = (char **)destination;
+    memcpy(*position, chars, length);
+    *position += length;
+}
+
+/// @brief Visits the flat parts of a rope from left to right
+/// @param rope The rope that is traversed
+/// @param visit The function that is called for every flat part
+/// @param context Context that is passed to the visit function
+/// @details Appending in a loop creates deeply nested ropes, so the rope is traversed without recursion
+static void object_rope_traverse(object_rope_t * rope, void (*visit)(char const *, uint32_t, void *), void * context) {
+    size_t capacity = 8u;
+    size_t count = 0u;
+    object_string_t ** pending = (object_string_t **)malloc(sizeof(object_string_t *) * capacity);
+    if (!pending) {
+        virtual_machine_out_of_memory(sizeof(object_string_t *) * capacity);
+    }
+    pending[count++] = (object_string_t *)rope;
+    while (count) {
+        object_string_t * part = pending[--count];
+        if (object_string_get_kind(part) == OBJECT_STRING_KIND_ROPE) {
+            object_rope_t * node = (object_rope_t *)part;
+            if (node->right) {
+                if (capacity < count + 2u) {
+                    capacity *= 2u;
+                    object_string_t ** grown =
+                        (object_string_t **)realloc(pending, sizeof(object_string_t *) * capacity);
+                    if (!grown) {
+                        free(pending);
+                        virtual_machine_out_of_memory(sizeof(object_string_t *) * capacity);
+                    }
+                    pending = grown;
+                }
+                // The right part is pushed first, so the left part is visited first
+                pending[count++] = node->right;
+                pending[count++] = node->left;
+                continue;
+            }
+            // The rope has already been flattened
+            part = node->left;
+        }
+        visit(object_string_chars(part), part->length, context);
+    }
+    free(pending);
+}
+
 char const * object_stringify_type(object_t * object) {
-    switch (object->type) {
+    switch (object_get_type(object)) {
     case OBJECT_BOUND_METHOD:
         return objectTypesStringified[0];
     case OBJECT_CLASS:
@@ -284,14 +603,18 @@ char const * object_stringify_type(object_t * object) {
     case OBJECT_INSTANCE:
         return ((object_instance_t *)object)->celloxClass->name->chars;
         ;
-    case OBJECT_NATIVE:
+    case OBJECT_MAP:
         return objectTypesStringified[5];
-    case OBJECT_STRING:
+    case OBJECT_NATIVE:
         return objectTypesStringified[6];
-    case OBJECT_UPVALUE:
+    case OBJECT_STRING:
         return objectTypesStringified[7];
-    default:
+    case OBJECT_TYPED_ARRAY:
         return objectTypesStringified[8];
+    case OBJECT_UPVALUE:
+        return objectTypesStringified[9];
+    default:
+        return objectTypesStringified[10];
         ;
     }
 }
@@ -25,10 +25,11 @@
 #include "../byte-code/chunk.h"
 #include "../common.h"
 #include "./data-structures/value_hash_table.h"
+#include "./data-structures/value_map.h"
 #include "value.h"
 
 /// Makro that determines the type of an object
-#define OBJECT_TYPE(value)     (AS_OBJECT(value)->type)
+#define OBJECT_TYPE(value)     (object_get_type(AS_OBJECT(value)))
 
 /// Makro that determines if the object has the object type array
 #define IS_ARRAY(value)        object_is_type(value, OBJECT_ARRAY)
@@ -46,6 +47,10 @@
 #define IS_NATIVE(value)       object_is_type(value, OBJECT_NATIVE)
 /// Makro that determines if the object has the object type string
 #define IS_STRING(value)       object_is_type(value, OBJECT_STRING)
+/// Makro that determines if the object has the object type map
+#define IS_MAP(value)          object_is_type(value, OBJECT_MAP)
+/// Makro that determines if the object has the object type typed array
+#define IS_TYPED_ARRAY(value)  object_is_type(value, OBJECT_TYPED_ARRAY)
 
 /// Makro that gets the value of an object as a dynamic value array
 #define AS_ARRAY(value)        ((object_dynamic_value_array_t *)AS_OBJECT(value))
@@ -58,13 +63,17 @@
 /// Makro that gets the value of an object as a closure
 #define AS_CLOSURE(value)      ((object_closure_t *)AS_OBJECT(value))
 /// Makro that gets the value of an object as a cstring
-#define AS_CSTRING(value)      (((object_string_t *)AS_OBJECT(value))->chars)
+#define AS_CSTRING(value)      (object_string_cstring(AS_STRING(value)))
 /// Makro that gets the value of an object as a function
 #define AS_FUNCTION(value)     ((object_function_t *)AS_OBJECT(value))
 /// Makro that gets the value of an object as a native function
 #define AS_NATIVE(value)       (((object_native_t *)AS_OBJECT(value))->function)
 /// Makro that gets the value of an object as a string
 #define AS_STRING(value)       ((object_string_t *)AS_OBJECT(value))
+/// Makro that gets the value of an object as a map
+#define AS_MAP(value)          ((object_map_t *)AS_OBJECT(value))
+/// Makro that gets the value of an object as a typed array
+#define AS_TYPED_ARRAY(value)  ((object_typed_array_t *)AS_OBJECT(value))
 
 /// @brief Different type of objects
 typedef enum {
@@ -80,22 +89,55 @@ typedef enum {
     OBJECT_CLOSURE,
     /// A cellox function
     OBJECT_FUNCTION,
+    /// A map that associates arbitrary values with values
+    OBJECT_MAP,
     /// A native function
     OBJECT_NATIVE,
     /// A string
     OBJECT_STRING,
+    /// An array whose elements have a fixed numerical type
+    OBJECT_TYPED_ARRAY,
     /// An upvalue
     OBJECT_UPVALUE,
 } object_type;
 
-/// @brief A cellox object
+/// The amount of different object types
+#define OBJECT_TYPE_COUNT               (OBJECT_UPVALUE + 1)
+
+/// Number of bits of the object header that are used to store the address of the next object
+#define OBJECT_HEADER_NEXT_BITS         (48u)
+/// Mask that is used to extract the address of the next object from the object header
+#define OBJECT_HEADER_NEXT_MASK         ((UINT64_C(1) << OBJECT_HEADER_NEXT_BITS) - 1u)
+/// Offset of the object type in the object header
+#define OBJECT_HEADER_TYPE_SHIFT        OBJECT_HEADER_NEXT_BITS
+/// Mask that is used to extract the type from the object header (after the header has been shifted)
+#define OBJECT_HEADER_TYPE_MASK         (UINT64_C(0xff))
+/// Bit of the object header that determines whether the object has already been marked by the garbage collector
+#define OBJECT_HEADER_MARK_BIT          (UINT64_C(1) << 56u)
+/// Offset of the kind of a string in the object header
+#define OBJECT_HEADER_STRING_KIND_SHIFT (57u)
+/// Mask that is used to extract the kind of a string from the object header (after the header has been shifted)
+#define OBJECT_HEADER_STRING_KIND_MASK  (UINT64_C(0x3))
+/// Bit of the object header that determines whether a string is stored in the hashtable of interned strings
+#define OBJECT_HEADER_INTERNED_BIT      (UINT64_C(1) << 59u)
+/// Bit of the object header that determines whether the hash value of a string has already been calculated
+#define OBJECT_HEADER_HASHED_BIT        (UINT64_C(1) << 60u)
+/// Bit of the object header that determines whether an array can contain values of any type (otherwise only numbers)
+#define OBJECT_HEADER_ARRAY_GENERIC_BIT (UINT64_C(1) << 61u)
+
+/**
+ * @brief A cellox object
+ * @details The header of an object is packed into a single 64-bit word.
+ * The lower 48 bits store the address of the next object in the linear sequence of objects stored on the heap,
+ * bits 48 - 55 store the type of the object and bit 56 is the mark bit that is used by the garbage collector.
+ * The bits 57 and 58 store the kind of a string, bit 59 determines whether a string is interned and bit 60 whether
+ * the hash value of a string has already been calculated.
+ * Like NaN boxing this relies on the fact that only the lower 48 bits of an address are used by all of the supported
+ * 64-bit platforms.
+ */
 struct object_t {
-    /// The type of the object
-    object_type type;
-    /// Determines whether the object has already been marked by the grabage collector
-    bool isMarked;
-    /// pointer to the next object in the linear sequence of objects stored on the heap
-    struct object_t * next;
+    /// The packed header of the object (next object, type and mark bit)
+    uint64_t header;
 };
 
 /// @brief A cellox function
@@ -126,12 +168,63 @@ struct object_string_t {
     object_t obj;
     /// The length of the string
     uint32_t length;
-    /// Pointer to the address in memory under that the string is stored
-    char * chars;
-    /// The hashValue of the string
+    /// The hashValue of the string (only valid if the hashed bit is set in the header, see object_string_hash)
     uint32_t hash;
+    /// The null-terminated character sequence of the string (stored inline after the header of the string)
+    char chars[];
 };
 
+/// Makro that determines the amount of memory that is occupied by a string object with a given length
+#define OBJECT_STRING_SIZE(length) (sizeof(object_string_t) + (length) + 1u)
+
+/// @brief Different kinds of strings
+typedef enum {
+    /// The character sequence is stored inline after the header of the string
+    OBJECT_STRING_KIND_FLAT,
+    /// The string is the lazy concatenation of two other strings
+    OBJECT_STRING_KIND_ROPE,
+    /// The string is a view of a part of the character sequence of another string
+    OBJECT_STRING_KIND_SLICE,
+} object_string_kind;
+
+/**
+ * @brief A string that is the lazy concatenation of two other strings
+ * @details Concatenating strings in a loop would copy the whole string in every iteration. A rope only references
+ * both of its parts, the characters are copied into a flat string when the rope is flattened.
+ * This happens the first time the character sequence of the rope is needed.
+ * The first fields of a rope have the same layout as the fields of object_string_t.
+ */
+typedef struct {
+    /// data that defines all types of objects
+    object_t obj;
+    /// The length of the string
+    uint32_t length;
+    /// The hashValue of the string (only valid if the hashed bit is set in the header, see object_string_hash)
+    uint32_t hash;
+    /// The left part of the rope or the flat string that stores the characters after the rope has been flattened
+    object_string_t * left;
+    /// The right part of the rope or NULL if the rope has already been flattened
+    object_string_t * right;
+} object_rope_t;
+
+/**
+ * @brief A string that references a part of the character sequence of a flat string instead of copying it
+ * @details The character sequence of a slice is not null-terminated, unless the slice ends at the end of its parent.
+ * The first fields of a slice have the same layout as the fields of object_string_t.
+ */
+typedef struct {
+    /// data that defines all types of objects
+    object_t obj;
+    /// The length of the string
+    uint32_t length;
+    /// The hashValue of the string (only valid if the hashed bit is set in the header, see object_string_hash)
+    uint32_t hash;
+    /// The flat string that stores the character sequence of the slice
+    object_string_t * parent;
+    /// The offset of the character sequence of the slice in the character sequence of the parent
+    uint32_t offset;
+} object_string_slice_t;
+
 /// @brief An object up-value structure (a local variable in an enclosing function)
 typedef struct object_upvalue_t {
     /// data that defines all types of objects
@@ -157,20 +250,32 @@ typedef struct {
     object_t obj;
     /// The function of the closure
     object_function_t * function;
-    /// The upvalues which are captured by the closure
-    object_upvalue_t ** upvalues;
     /// The amount of upvalues that is captured by the closure
     uint32_t upvalueCount;
+    /// The upvalues which are captured by the closure (stored inline after the header of the closure)
+    object_upvalue_t * upvalues[];
 } object_closure_t;
 
+/// Makro that determines the amount of memory that is occupied by a closure that captures the given amount of upvalues
+#define OBJECT_CLOSURE_SIZE(upvalueCount) (sizeof(object_closure_t) + sizeof(object_upvalue_t *) * (upvalueCount))
+
 /// @brief A class structure - a class in cellox
+/// @details The methods of a class are stored in a flat vector and the name of every method is mapped to its slot in
+/// the vector. A subclass starts with a copy of the vector and the slots of its superclass (copy-down), so inherited
+/// and overridden methods keep the slot they have in the superclass.
 typedef struct {
     /// data that defines all types of objects
     object_t obj;
     /// The name of the class
     object_string_t * name;
-    /// The methods that are defined in the class body
-    value_hash_table_t methods;
+    /// Maps the names of the methods to their slots in the method vector
+    value_hash_table_t methodSlots;
+    /// The closures of the methods that are defined in the class body or inherited, indexed by their slot
+    dynamic_value_array_t methods;
+    /// The initializer of the class or NULL if the class has no init method
+    object_closure_t * initializer;
+    /// The highest amount of fields an instance of the class has had, the fields of new instances are pre-sized for it
+    uint32_t fieldCount;
 } object_class_t;
 
 /// @brief A cellox class instance
@@ -193,15 +298,83 @@ typedef struct {
     object_closure_t * method;
 } object_bound_method_t;
 
-/// @brief A dynamic array
-typedef struct {
+/**
+ * @brief A dynamic array
+ * @details A slice of an array can borrow the values of the array it was created from instead of copying them.
+ * The borrowed values are owned by a hidden backing array that is never mutated.
+ * Before an array with borrowed values is mutated, the values are copied (copy on write).
+ * Every array has an elements kind that is stored in the object header. An array only contains numbers until the first
+ * value of another type is stored in it, afterwards its kind is generic and never changes back. With NaN boxing a
+ * number is either stored as the bits of its double or as an integer that is tagged inside a quiet NaN, so the values
+ * of a numeric array never reference an object and the garbage collector does not have to scan them.
+ */
+typedef struct object_dynamic_value_array_t {
     /// data that defines all types of objects
     object_t obj;
-    /// The underlying array
+    /// The underlying array (the capacity is zero if the values are borrowed)
     dynamic_value_array_t array;
+    /// The array that owns the values if they are borrowed, otherwise NULL
+    struct object_dynamic_value_array_t * backing;
 } object_dynamic_value_array_t;
 
+/// @brief A map that associates keys of any type with values
+typedef struct {
+    /// data that defines all types of objects
+    object_t obj;
+    /// The entries of the map
+    value_map_t map;
+} object_map_t;
+
+/// Alignment of the elements of a typed array in bytes (the width of an AVX register)
+#define OBJECT_TYPED_ARRAY_ALIGNMENT (32u)
+
+/// @brief The types of the elements of a typed array
+typedef enum {
+    /// 64-bit floating point numbers
+    OBJECT_TYPED_ARRAY_FLOAT64,
+    /// 32-bit signed integers
+    OBJECT_TYPED_ARRAY_INT32,
+    /// 8-bit unsigned integers
+    OBJECT_TYPED_ARRAY_UINT8,
+} object_typed_array_type;
+
+/**
+ * @brief An array whose elements have a fixed numerical type
+ * @details The elements are stored unboxed in a contiguous buffer that is aligned for vector instructions.
+ * Numbers that are stored in an integer array are truncated and wrap around like a cast in C.
+ */
+typedef struct {
+    /// data that defines all types of objects
+    object_t obj;
+    /// The type of the elements
+    object_typed_array_type type;
+    /// The amount of elements stored in the array
+    uint32_t count;
+    /// The aligned elements of the array (points into the allocation)
+    void * elements;
+    /// The allocated buffer that contains the elements
+    void * allocation;
+} object_typed_array_t;
+
+/// @brief Allocates a string object that can store a character sequence with the given length
+/// @param length The length of the character sequence
+/// @return The allocated string
+/// @details The character sequence of the string is stored inline and has to be written by the caller before the next
+/// allocation. Strings that are created at runtime are neither hashed nor interned.
+object_string_t * object_allocate_string(uint32_t length);
+
+/// @brief Concatenates two strings
+/// @param a The first string
+/// @param b The second string that is appended to the first one
+/// @return The concatenation of both strings
+/// @details Short results are copied into a flat string that is not interned, longer ones are represented by a rope
+/// that is only flattened when the character sequence is needed.
+/// Both strings have to be reachable by the garbage collector.
+object_string_t * object_concatenate_strings(object_string_t * a, object_string_t * b);
+
 /// @brief Copys the value of a string in the hashtable of the virtualMachine
+/// @details Only constants and the names of properties and global variables are interned, because they are used as
+/// keys. Strings that are created at runtime are created using object_new_string.
 /// @param chars Pointer to the character sequence / string
 /// @param length The length of the character sequence
 /// @param removeBackSlash Boolean value that determines whether backslashes should be resolved
@@ -236,6 +409,7 @@ object_function_t * object_new_function(void);
 /// @brief Creates a new cellox class instance
 /// @param celloxClass The class of the instance
 /// @return The new instance that was created
+/// @details The field table is pre-sized for the highest amount of fields the instances of the class have had so far
 object_instance_t * object_new_instance(object_class_t * celloxClass);
 
 /// @brief Creates a new native function object
@@ -243,17 +417,82 @@ object_instance_t * object_new_instance(object_class_t * celloxClass);
 /// @return The new function that was created
 object_native_t * object_new_native(native_function_t function);
 
-/// @brief Creates a string or returns a string from the hashtable of the virtualMachine if it already exists
-/// @param chars Pointer to the character sequence
+/// @brief Creates an array that borrows the values of a constant array literal
+/// @param constant The array that was built when the array literal was compiled
+/// @return The created array
+/// @details The values are copied when the array is mutated for the first time (copy on write), so the constant is
+/// never changed
+object_dynamic_value_array_t * object_new_array_copy(object_dynamic_value_array_t * constant);
+
+/// @brief Creates a slice of an array
+/// @param array The array the slice is created from
+/// @param start The index of the first value of the slice
+/// @param count The amount of values in the slice
+/// @return The created slice
+/// @details Large slices borrow the values of the array, small ones are copied so they do not keep a much larger
+/// array alive. The array has to be reachable by the garbage collector.
+object_dynamic_value_array_t * object_new_array_slice(object_dynamic_value_array_t * array, uint32_t start,
+                                                      uint32_t count);
+
+/// @brief Creates a new string at runtime
+/// @param chars Pointer to the character sequence that is copied
 /// @param length The length of the character sequence
-/// @return The string that was created or found
-object_string_t * object_take_string(char * chars, uint32_t length);
+/// @return The created string
+/// @details The string is neither hashed nor interned, the hash value is calculated when it is used for the first time
+object_string_t * object_new_string(char const * chars, uint32_t length);
+
+/// @brief Creates a slice of a string
+/// @param string The string the slice is created from
+/// @param start The index of the first character of the slice
+/// @param length The length of the slice
+/// @return The created slice
+/// @details Large slices reference the character sequence of the string, small ones are copied so they do not keep a
+/// much larger string alive. The string has to be reachable by the garbage collector.
+object_string_t * object_new_string_slice(object_string_t * string, uint32_t start, uint32_t length);
+
+/// @brief Creates a new empty map
+/// @return The created map
+object_map_t * object_new_map(void);
+
+/// @brief Creates a new typed array whose elements are zero
+/// @param type The type of the elements
+/// @param count The amount of elements
+/// @return The created typed array
+object_typed_array_t * object_new_typed_array(object_typed_array_type type, uint32_t count);
 
 /// @brief Creates a new upvalue
 /// @param slot The slot where the value will be placed
 /// @return The upvalue that was created
 object_upvalue_t * object_new_upvalue(value_t * slot);
 
+/// @brief Copies the values that are borrowed by a slice, so the array can be mutated
+/// @param array The array whose values are copied
+/// @note Use object_array_prepare_mutation, that only copies the values if they are borrowed
+void object_array_copy_borrowed_values(object_dynamic_value_array_t * array);
+
+/// @brief Gets the character sequence of a string as a null-terminated string
+/// @param string The string whose character sequence is determined
+/// @return The null-terminated character sequence of the string
+/// @note Ropes are flattened and slices that do not end at the end of their parent are copied
+char const * object_string_cstring(object_string_t * string);
+
+/// @brief Flattens a rope so the character sequence is stored contiguously in memory
+/// @param string The rope that is flattened
+/// @return The null-terminated character sequence of the rope
+/// @details Ropes are flattened once, the flat string is cached in the rope afterwards
+char const * object_string_flatten(object_string_t * string);
+
+/// @brief Calculates the hash value of a string and caches it in the string
+/// @param string The string whose hash value is calculated
+/// @return The hash value of the string
+uint32_t object_string_compute_hash(object_string_t * string);
+
+/// @brief Determines whether two strings have the same character sequence
+/// @param a The first string
+/// @param b The second string
+/// @return true if both strings are equal, false if not
+bool object_strings_equal(object_string_t * a, object_string_t * b);
+
 /// @brief Prints the object
 /// @param value The value that is printed
 void object_print(value_t value);
@@ -263,12 +502,206 @@ void object_print(value_t value);
 /// @return A character pointer that represents the type
 char const * object_stringify_type(object_t * object);
 
+/// @brief Gets the type of an object
+/// @param object The object whose type is determined
+/// @return The type of the object
+static inline object_type object_get_type(object_t const * object) {
+    return (object_type)((object->header >> OBJECT_HEADER_TYPE_SHIFT) & OBJECT_HEADER_TYPE_MASK);
+}
+
+/// @brief Gets the next object in the linear sequence of objects stored on the heap
+/// @param object The object whose successor is determined
+/// @return The next object or NULL if the object is the last one
+static inline object_t * object_get_next(object_t const * object) {
+    return (object_t *)(uintptr_t)(object->header & OBJECT_HEADER_NEXT_MASK);
+}
+
+/// @brief Determines whether an object has already been marked by the garbage collector
+/// @param object The object that is checked
+/// @return true if the object is marked, false if not
+static inline bool object_is_marked(object_t const * object) {
+    return (object->header & OBJECT_HEADER_MARK_BIT) != 0;
+}
+
+/// @brief Initializes the header of an object
+/// @param object The object whose header is initialized
+/// @param type The type of the object
+/// @param next The next object in the linear sequence of objects stored on the heap
+static inline void object_init_header(object_t * object, object_type type, object_t * next) {
+    object->header = ((uint64_t)(uintptr_t)next & OBJECT_HEADER_NEXT_MASK) |
+                     (((uint64_t)type & OBJECT_HEADER_TYPE_MASK) << OBJECT_HEADER_TYPE_SHIFT);
+}
+
+/// @brief Sets the next object in the linear sequence of objects stored on the heap
+/// @param object The object whose successor is set
+/// @param next The next object
+static inline void object_set_next(object_t * object, object_t * next) {
+    object->header =
+        (object->header & ~OBJECT_HEADER_NEXT_MASK) | ((uint64_t)(uintptr_t)next & OBJECT_HEADER_NEXT_MASK);
+}
+
+/// @brief Sets or clears the mark bit of an object
+/// @param object The object that is marked or unmarked
+/// @param isMarked Determines whether the object is marked
+static inline void object_set_marked(object_t * object, bool isMarked) {
+    if (isMarked) {
+        object->header |= OBJECT_HEADER_MARK_BIT;
+    } else {
+        object->header &= ~OBJECT_HEADER_MARK_BIT;
+    }
+}
+
+/// @brief Gets the kind of a string
+/// @param string The string whose kind is determined
+/// @return The kind of the string
+static inline object_string_kind object_string_get_kind(object_string_t const * string) {
+    return (object_string_kind)((string->obj.header >> OBJECT_HEADER_STRING_KIND_SHIFT) &
+                                OBJECT_HEADER_STRING_KIND_MASK);
+}
+
+/// @brief Determines whether a string is stored in the hashtable of interned strings
+/// @param string The string that is checked
+/// @return true if the string is interned, false if not
+static inline bool object_string_is_interned(object_string_t const * string) {
+    return (string->obj.header & OBJECT_HEADER_INTERNED_BIT) != 0;
+}
+
+/// @brief Gets the character sequence of a string
+/// @param string The string whose character sequence is determined
+/// @return The character sequence of the string (not null-terminated for slices, see object_string_cstring)
+/// @note Ropes are flattened which might trigger a garbage collection
+static inline char const * object_string_chars(object_string_t * string) {
+    switch (object_string_get_kind(string)) {
+    case OBJECT_STRING_KIND_SLICE:
+        {
+            object_string_slice_t * slice = (object_string_slice_t *)string;
+            return slice->parent->chars + slice->offset;
+        }
+    case OBJECT_STRING_KIND_ROPE:
+        return object_string_flatten(string);
+    default:
+        return string->chars;
+    }
+}
+
+/// @brief Gets the hash value of a string
+/// @param string The string whose hash value is determined
+/// @return The hash value of the string
+/// @note The hash value is calculated lazily, when it is needed for the first time
+static inline uint32_t object_string_hash(object_string_t * string) {
+    return (string->obj.header & OBJECT_HEADER_HASHED_BIT) ? string->hash : object_string_compute_hash(string);
+}
+
+/// @brief Determines the amount of memory that is occupied by a string object
+/// @param string The string whose size is determined
+/// @return The size of the string object in bytes
+static inline size_t object_string_size(object_string_t const * string) {
+    switch (object_string_get_kind(string)) {
+    case OBJECT_STRING_KIND_ROPE:
+        return sizeof(object_rope_t);
+    case OBJECT_STRING_KIND_SLICE:
+        return sizeof(object_string_slice_t);
+    default:
+        return OBJECT_STRING_SIZE(string->length);
+    }
+}
+
+/// @brief Prepares an array for being mutated
+/// @param array The array that is mutated afterwards
+/// @note If the values of the array are borrowed from another array they are copied which might trigger a garbage
+/// collection
+static inline void object_array_prepare_mutation(object_dynamic_value_array_t * array) {
+    if (array->backing) {
+        object_array_copy_borrowed_values(array);
+    }
+}
+
+/// @brief Determines whether an array only contains numbers
+/// @param array The array whose elements kind is determined
+/// @return true if the array only contains numbers, false if it can contain values of any type
+static inline bool object_array_is_numeric(object_dynamic_value_array_t const * array) {
+    return !(array->obj.header & OBJECT_HEADER_ARRAY_GENERIC_BIT);
+}
+
+/// @brief Updates the elements kind of an array for a value that is stored in it
+/// @param array The array the value is stored in
+/// @param value The value that is stored in the array
+static inline void object_array_track_value(object_dynamic_value_array_t * array, value_t value) {
+    if (!IS_NUMBER(value)) {
+        array->obj.header |= OBJECT_HEADER_ARRAY_GENERIC_BIT;
+    }
+}
+
+/// @brief Updates the elements kind of an array for the values of another array that are stored in it
+/// @param array The array the values are stored in
+/// @param source The array the values are taken from
+static inline void object_array_track_values(object_dynamic_value_array_t * array,
+                                             object_dynamic_value_array_t const * source) {
+    array->obj.header |= source->obj.header & OBJECT_HEADER_ARRAY_GENERIC_BIT;
+}
+
+/// @brief Appends a value to an array
+/// @param array The array the value is appended to
+/// @param value The value that is appended
+/// @note The array has to be prepared for the mutation before (see object_array_prepare_mutation)
+static inline void object_array_write(object_dynamic_value_array_t * array, value_t value) {
+    object_array_track_value(array, value);
+    dynamic_value_array_write(&array->array, value);
+}
+
+/// @brief Determines the size of a single element of a typed array
+/// @param type The type of the elements
+/// @return The size of an element in bytes
+static inline size_t object_typed_array_element_size(object_typed_array_type type) {
+    switch (type) {
+    case OBJECT_TYPED_ARRAY_FLOAT64:
+        return sizeof(double);
+    case OBJECT_TYPED_ARRAY_INT32:
+        return sizeof(int32_t);
+    default:
+        return sizeof(uint8_t);
+    }
+}
+
+/// @brief Gets an element of a typed array
+/// @param array The typed array
+/// @param index The index of the element
+/// @return The element converted to a double
+static inline double object_typed_array_get(object_typed_array_t const * array, uint32_t index) {
+    switch (array->type) {
+    case OBJECT_TYPED_ARRAY_FLOAT64:
+        return ((double const *)array->elements)[index];
+    case OBJECT_TYPED_ARRAY_INT32:
+        return ((int32_t const *)array->elements)[index];
+    default:
+        return ((uint8_t const *)array->elements)[index];
+    }
+}
+
+/// @brief Sets an element of a typed array
+/// @param array The typed array
+/// @param index The index of the element
+/// @param number The number that is converted to the type of the elements and stored
+static inline void object_typed_array_set(object_typed_array_t * array, uint32_t index, double number) {
+    if (array->type == OBJECT_TYPED_ARRAY_FLOAT64) {
+        ((double *)array->elements)[index] = number;
+        return;
+    }
+    // Not a number and numbers that can not be represented by a 64-bit integer are stored as zero
+    int64_t integer = number > (double)INT64_MIN && number < (double)INT64_MAX ? (int64_t)number : 0;
+    if (array->type == OBJECT_TYPED_ARRAY_INT32) {
+        ((int32_t *)array->elements)[index] = (int32_t)(uint32_t)integer;
+    } else {
+        ((uint8_t *)array->elements)[index] = (uint8_t)integer;
+    }
+}
+
 /// @brief Determines whether a value is of a given type
 /// @param value The value that is checked
 /// @param type The type that is used for checking the value
 /// @return true is the value is of the given type, false if not
 static inline bool object_is_type(value_t value, object_type type) {
-    return IS_OBJECT(value) && AS_OBJECT(value)->type == type;
+    return IS_OBJECT(value) && object_get_type(AS_OBJECT(value)) == type;
 }
 
 #endif
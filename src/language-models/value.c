@@ -87,7 +87,9 @@ char const * value_stringify_type(value_t value) {
 
 bool value_values_equal(value_t a, value_t b) {
 #ifdef NAN_BOXING
-    if (IS_NUMBER(a) && IS_NUMBER(b)) {
+    if (IS_INTEGER(a) && IS_INTEGER(b)) {
+        return a == b;
+    } else if (IS_NUMBER(a) && IS_NUMBER(b)) {
         return AS_NUMBER(a) == AS_NUMBER(b);
     } else if (IS_ARRAY(a) && IS_ARRAY(b)) {
         object_dynamic_value_array_t * firstArray = AS_ARRAY(a);
@@ -101,6 +103,12 @@ bool value_values_equal(value_t a, value_t b) {
             }
         }
         return true;
+    } else if (IS_STRING(a) && IS_STRING(b)) {
+        return object_strings_equal(AS_STRING(a), AS_STRING(b));
+    } else if (IS_BOUND_METHOD(a) && IS_BOUND_METHOD(b)) {
+        // Bound methods are reused, so they are compared by the method and the receiver instead of their identity
+        return AS_BOUND_METHOD(a)->method == AS_BOUND_METHOD(b)->method &&
+               value_values_equal(AS_BOUND_METHOD(a)->receiver, AS_BOUND_METHOD(b)->receiver);
     }
     return a == b;
 #else
@@ -128,6 +136,14 @@ bool value_values_equal(value_t a, value_t b) {
             }
             return true;
         }
+        if (IS_STRING(a) && IS_STRING(b)) {
+            return object_strings_equal(AS_STRING(a), AS_STRING(b));
+        }
+        if (IS_BOUND_METHOD(a) && IS_BOUND_METHOD(b)) {
+            // Bound methods are reused, so they are compared by the method and the receiver instead of their identity
+            return AS_BOUND_METHOD(a)->method == AS_BOUND_METHOD(b)->method &&
+                   value_values_equal(AS_BOUND_METHOD(a)->receiver, AS_BOUND_METHOD(b)->receiver);
+        }
         return AS_OBJECT(a) == AS_OBJECT(b);
     default:
         return false; // Unreachable.
@@ -21,6 +21,7 @@
 #ifndef CELLOX_VALUE_H_
 #define CELLOX_VALUE_H_
 
+#include <math.h>
 #include <string.h>
 
 #include "../common.h"
@@ -33,19 +34,22 @@ typedef struct object_string_t object_string_t;
 
 #ifdef NAN_BOXING
 
-#define SIGN_BIT  ((uint64_t)0x8000000000000000)
+#define SIGN_BIT    ((uint64_t)0x8000000000000000)
 
 /// quiet not a number 🤫
-#define QNAN      ((uint64_t)0x7ffc000000000000)
+#define QNAN        ((uint64_t)0x7ffc000000000000)
 
 /// Used to tag a null-value &frasl; undefiened value
-#define TAG_NULL  (0x1)
+#define TAG_NULL    (0x1)
 
 /// Used to tag a false-value
-#define TAG_FALSE (0x2)
+#define TAG_FALSE   (0x2)
 
 /// Used to tag a true-value
-#define TAG_TRUE  (0x3)
+#define TAG_TRUE    (0x3)
+
+/// Used to tag a 32-bit integer that is stored in the lower half of the value
+#define TAG_INTEGER ((uint64_t)0x0001000000000000)
 
 /// @brief An value type
 /// @details In Cellox a value can be either a numerical, a boolean or a undefiended value. Additionally a value can
@@ -53,33 +57,39 @@ typedef struct object_string_t object_string_t;
 typedef uint64_t value_t;
 
 /// Makro that determines whether a value is of the type bool
-#define IS_BOOL(value)   (((value) | 1) == TRUE_VAL)
+#define IS_BOOL(value)       (((value) | 1) == TRUE_VAL)
 /// Makro that determines whether a value is nil
-#define IS_NULL(value)   ((value) == NULL_VAL)
-/// Makro that determines whether a value is of the type number
-#define IS_NUMBER(value) (((value)&QNAN) != QNAN)
+#define IS_NULL(value)       ((value) == NULL_VAL)
+/// Makro that determines whether a value is a number that is stored as a 32-bit integer
+#define IS_INTEGER(value)    (((value) & (SIGN_BIT | QNAN | TAG_INTEGER)) == (QNAN | TAG_INTEGER))
+/// Makro that determines whether a value is of the type number (either a double or an integer)
+#define IS_NUMBER(value)     (((value)&QNAN) != QNAN || IS_INTEGER(value))
 /// Makro that determines whether a value is of the type obejct
-#define IS_OBJECT(value) (((value) & (QNAN | SIGN_BIT)) == (QNAN | SIGN_BIT))
+#define IS_OBJECT(value)     (((value) & (QNAN | SIGN_BIT)) == (QNAN | SIGN_BIT))
 
 /// Makro that yields the value of a boolean and converts to a c boolean
-#define AS_BOOL(value)   ((value) == TRUE_VAL)
+#define AS_BOOL(value)       ((value) == TRUE_VAL)
+/// Makro that yields the value of an integer (the value has to be an integer, see IS_INTEGER)
+#define AS_INTEGER(value)    ((int32_t)(uint32_t)(value))
 /// Makro that yields the value of a number and converts to a c double
-#define AS_NUMBER(value) valueToNum(value)
+#define AS_NUMBER(value)     valueToNum(value)
 /// Makro that yields the value of an object and converts to an object pointer
-#define AS_OBJECT(value) ((object_t *)(uintptr_t)((value) & ~(SIGN_BIT | QNAN)))
+#define AS_OBJECT(value)     ((object_t *)(uintptr_t)((value) & ~(SIGN_BIT | QNAN)))
 
 /// Makro that yields the boolean value stored in a Value
-#define BOOL_VAL(b)      ((b) ? TRUE_VAL : FALSE_VAL)
+#define BOOL_VAL(b)          ((b) ? TRUE_VAL : FALSE_VAL)
 /// Makro that yields a false value
-#define FALSE_VAL        ((value_t)(uint64_t)(QNAN | TAG_FALSE))
+#define FALSE_VAL            ((value_t)(uint64_t)(QNAN | TAG_FALSE))
 /// Makro that yields a true value
-#define TRUE_VAL         ((value_t)(uint64_t)(QNAN | TAG_TRUE))
+#define TRUE_VAL             ((value_t)(uint64_t)(QNAN | TAG_TRUE))
 /// Makro that yields null
-#define NULL_VAL         ((value_t)(uint64_t)(QNAN | TAG_NULL))
+#define NULL_VAL             ((value_t)(uint64_t)(QNAN | TAG_NULL))
+/// Makro that yields an integer
+#define INTEGER_VAL(integer) ((value_t)(QNAN | TAG_INTEGER | (uint64_t)(uint32_t)(integer)))
 /// Makro that yields the numerical value
-#define NUMBER_VAL(num)  numToValue(num)
+#define NUMBER_VAL(num)      numToValue(num)
 /// Makro that yields the value of a object
-#define OBJECT_VAL(obj)  (value_t)(SIGN_BIT | QNAN | (uint64_t)(uintptr_t)(obj))
+#define OBJECT_VAL(obj)      (value_t)(SIGN_BIT | QNAN | (uint64_t)(uintptr_t)(obj))
 
 /// @brief Converts a double to a value_t using type punning
 /// @param number The value that is converted (a double)
@@ -93,6 +103,9 @@ static inline value_t numToValue(double number) {
 /// @param value The value that is converted (value_t)
 /// @return A double
 static inline double valueToNum(value_t value) {
+    if (IS_INTEGER(value)) {
+        return AS_INTEGER(value);
+    }
     double num;
     memcpy(&num, &value, sizeof(value_t));
     return num;
@@ -128,6 +141,8 @@ typedef struct {
 #define IS_BOOL(value)     ((value).type == VAL_BOOL)
 /// Makro that determines whether a value is of the type nil
 #define IS_NULL(value)     ((value).type == VAL_NULL)
+/// Makro that determines whether a value is a number that is stored as an integer (only done with NaN boxing)
+#define IS_INTEGER(value)  (false)
 /// Makro that determines whether a value is of the type number
 #define IS_NUMBER(value)   ((value).type == VAL_NUMBER)
 /// Makro that determines whether a value is of the type object
@@ -135,6 +150,8 @@ typedef struct {
 
 /// Makro that returns the boolean value in the union
 #define AS_BOOL(value)     ((value).as.boolean)
+/// Makro that returns the value of an integer
+#define AS_INTEGER(value)  ((int32_t)(value).as.number)
 /// Makro that returns the value of a number in the union
 #define AS_NUMBER(value)   ((value).as.number)
 /// Makro that returns the value of an object in the union
@@ -144,6 +161,8 @@ typedef struct {
 #define BOOL_VAL(value)    ((value_t){VAL_BOOL, {.boolean = value}})
 /// Makro that creates a null value
 #define NULL_VAL           ((value_t){VAL_NULL, {.number = 0}})
+/// Makro that creates an integer (stored as a double)
+#define INTEGER_VAL(value) ((value_t){VAL_NUMBER, {.number = (double)(value)}})
 /// Makro that creates a numerical value
 #define NUMBER_VAL(value)  ((value_t){VAL_NUMBER, {.number = value}})
 /// Makro that creates an object
@@ -155,6 +174,67 @@ typedef struct {
 
 #endif // No NAN_BOXING defined
 
+/// @brief Creates a numerical value from the result of an integer operation
+/// @param integer The result of the operation
+/// @return An integer if the result fits into 32 bits, otherwise a double
+static inline value_t value_from_integer(int64_t integer) {
+    return integer >= INT32_MIN && integer <= INT32_MAX ? INTEGER_VAL(integer) : NUMBER_VAL((double)integer);
+}
+
+/// @brief Creates a numerical value that is stored as an integer if it does not have a fractional part
+/// @param number The number that is stored
+/// @return An integer if the number is integral and fits into 32 bits, otherwise a double
+static inline value_t value_from_number(double number) {
+    // Negative zero is stored as a double, because an integer can not represent the sign
+    if (number >= INT32_MIN && number <= INT32_MAX && number == (int32_t)number && (number || !signbit(number))) {
+        return INTEGER_VAL((int32_t)number);
+    }
+    return NUMBER_VAL(number);
+}
+
+/// @brief Divides two integers
+/// @param a The dividend
+/// @param b The divisor
+/// @param result Pointer to the value where the quotient is stored
+/// @return true if the quotient is an integer, false if the division has to be performed with doubles
+/// @details The quotient is only an integer if the division has no remainder and the result is not negative zero (zero
+/// divided by a negative number)
+static inline bool value_divide_integers(int64_t a, int64_t b, value_t * result) {
+    if (!b || a % b || (!a && b < 0)) {
+        return false;
+    }
+    *result = value_from_integer(a / b);
+    return true;
+}
+
+/// @brief Multiplies two integers
+/// @param a The first factor
+/// @param b The second factor
+/// @return The product
+static inline value_t value_multiply_integers(int64_t a, int64_t b) {
+    // Multiplying zero with a negative number results in negative zero, which is only represented by a double
+    return (a * b != 0 || (a >= 0 && b >= 0)) ? value_from_integer(a * b) : NUMBER_VAL(-0.0);
+}
+
+/// @brief Negates a number
+/// @param value The numerical value that is negated
+/// @return The negated number
+static inline value_t value_negate(value_t value) {
+    // Zero is negated as a double, because the result is negative zero
+    if (IS_INTEGER(value) && AS_INTEGER(value)) {
+        return value_from_integer(-(int64_t)AS_INTEGER(value));
+    }
+    return NUMBER_VAL(-AS_NUMBER(value));
+}
+
+/// @brief Truncates a number to an integer
+/// @param value The numerical value that is truncated
+/// @return The truncated number
+/// @details Integers are returned without converting them to a double and back
+static inline int32_t value_truncate(value_t value) {
+    return IS_INTEGER(value) ? AS_INTEGER(value) : (int32_t)AS_NUMBER(value);
+}
+
 /// @brief prints a value
 /// @param value The vallue that is printed
 void value_print(value_t value);
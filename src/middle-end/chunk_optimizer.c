@@ -20,96 +20,304 @@
 
 #include "chunk_optimizer.h"
 
-#define FOLD_EXPRESSION(op)                                                           \
-    chunk->constants.values[chunk->code[*indexPointer + 1]] =                         \
-        NUMBER_VAL(AS_NUMBER(chunk->constants.values[chunk->code[*indexPointer + 1]]) \
-                       op AS_NUMBER(chunk->constants.values[chunk->code[*indexPointer + 3]]))
+#include <stdlib.h>
+#include <string.h>
 
-static void chunk_optimizer_fold_numerical_expression(chunk_t *, int32_t *);
+/// @brief The compacted bytecode of a chunk that is optimized
+typedef struct {
+    /// The chunk that is optimized
+    chunk_t * chunk;
+    /// The bytecode instructions that are kept
+    uint8_t * code;
+    /// The line number of every bytecode instruction that is kept
+    uint32_t * lines;
+    /// Amount of bytes that are kept
+    uint32_t count;
+    /// Index of the line info of the original chunk that covers the last copied byte
+    uint32_t lineInfoIndex;
+} compaction_t;
+
+/// @brief An instruction that was copied to the compacted bytecode
+typedef struct {
+    /// Index of the first byte of the instruction (including its prefixes) in the original chunk
+    uint32_t oldStart;
+    /// Index of the first byte of the instruction in the compacted bytecode
+    uint32_t newStart;
+    /// Index of the constant that is pushed by the instruction (-1 if it is not OP_CONSTANT)
+    int32_t constant;
+} kept_instruction_t;
+
+/// @brief A jump or switch instruction whose offsets are recomputed after the chunk has been compacted
+typedef struct {
+    /// Index of the instruction in the original chunk
+    uint32_t oldOffset;
+    /// The upper bits of the jump offset that were supplied by the prefixes in the original chunk
+    uint32_t extendedArg;
+    /// Index of the instruction in the compacted bytecode
+    uint32_t newOffset;
+    /// Amount of prefixes in front of the instruction in the compacted bytecode
+    uint32_t prefixCount;
+} relocation_t;
+
+static void chunk_optimizer_copy(compaction_t *, uint32_t, uint32_t);
+static bool chunk_optimizer_fold(uint8_t, value_t, value_t, value_t *);
+static inline bool chunk_optimizer_is_jump(uint8_t);
+static uint32_t chunk_optimizer_jump_target(chunk_t *, uint32_t, uint32_t);
+static void chunk_optimizer_mark_jump_targets(chunk_t *, bool *);
+static inline uint32_t chunk_optimizer_prefix_count(uint32_t);
+static inline uint32_t chunk_optimizer_read_u32(uint8_t const *);
+static void chunk_optimizer_relocate(compaction_t *, relocation_t *, uint32_t const *);
+static inline uint32_t chunk_optimizer_switch_table(chunk_t *, uint32_t, uint32_t *);
+static inline void chunk_optimizer_write_u32(uint8_t *, uint32_t);
 
 void chunk_optimizer_optimize_chunk(chunk_t * chunk) {
-    for (int32_t i = 0; i < chunk->byteCodeCount; i++) {
-        switch (chunk->code[i]) {
-        case OP_CONSTANT:
-            if (i + 4 < chunk->byteCodeCount) {
-                if (chunk->code[i + 2] == OP_CONSTANT) {
-                    // Constant folding 🙏
-                    switch (chunk->code[i + 4]) {
-                    case OP_ADD:
-                    case OP_DIVIDE:
-                    case OP_MULTIPLY:
-                    case OP_SUBTRACT:
-                        if (IS_NUMBER(chunk->constants.values[chunk->code[i + 1]]) &&
-                            IS_NUMBER(chunk->constants.values[chunk->code[i + 2]])) {
-                            chunk_optimizer_fold_numerical_expression(chunk, &i);
-                        }
-                        break;
-                    default:
-                        break;
-                    }
-                }
-            }
-        case OP_ARRAY_LITERAL:
-        case OP_CLASS:
-        case OP_DEFINE_GLOBAL:
-        case OP_GET_GLOBAL:
-        case OP_GET_PROPERTY:
-        case OP_GET_SUPER:
-        case OP_METHOD:
-        case OP_SET_GLOBAL:
-        case OP_SET_PROPERTY:
-        case OP_CALL:
-        case OP_GET_LOCAL:
-        case OP_GET_UPVALUE:
-        case OP_SET_LOCAL:
-        case OP_SET_UPVALUE:
-            i++;
-            break;
-        case OP_INVOKE:
-        case OP_JUMP:
-            i += 2;
-            break;
-
-        default:
-            break;
+    uint32_t count = chunk->byteCodeCount;
+    if (!count) {
+        return;
+    }
+    // The function of the chunk is not reachable by the garbage collector at this point, so the temporary arrays are
+    // not allocated by the memory mutator
+    compaction_t compaction = {.chunk = chunk, .count = 0u, .lineInfoIndex = 0u};
+    compaction.code = malloc(count);
+    compaction.lines = malloc(sizeof(uint32_t) * count);
+    bool * targets = calloc(count + 1u, sizeof(bool));
+    uint32_t * newIndexes = malloc(sizeof(uint32_t) * (count + 1u));
+    kept_instruction_t * kept = malloc(sizeof(kept_instruction_t) * count);
+    relocation_t * relocations = malloc(sizeof(relocation_t) * count);
+    if (!compaction.code || !compaction.lines || !targets || !newIndexes || !kept || !relocations) {
+        exit(EXIT_CODE_SYSTEM_ERROR);
+    }
+    chunk_optimizer_mark_jump_targets(chunk, targets);
+    uint32_t keptCount = 0u, relocationCount = 0u, extendedArg = 0u, start = 0u;
+    for (uint32_t i = 0; i < count;) {
+        uint32_t length = chunk_instruction_length(chunk, i, extendedArg);
+        if (chunk->code[i] == OP_EXTENDED_ARG) {
+            extendedArg = chunk_next_extended_arg(chunk, i, extendedArg);
+            i += length;
+            continue;
+        }
+        uint8_t instruction = chunk->code[i];
+        newIndexes[start] = compaction.count;
+        value_t folded;
+        if (chunk_optimizer_is_jump(instruction)) {
+            // Jumps only get shorter when the chunk is compacted, so they never need more prefixes than before
+            uint32_t prefixCount = chunk_optimizer_prefix_count(extendedArg << 8 | chunk->code[i + 1u] << 8 |
+                                                                chunk->code[i + 2u]);
+            uint32_t copyStart = i - 2u * prefixCount;
+            relocations[relocationCount++] = (relocation_t){
+                .oldOffset = i, .extendedArg = extendedArg, .newOffset = compaction.count + 2u * prefixCount,
+                .prefixCount = prefixCount};
+            kept[keptCount++] = (kept_instruction_t){.oldStart = start, .newStart = compaction.count, .constant = -1};
+            chunk_optimizer_copy(&compaction, copyStart, i + length - copyStart);
+        } else if (instruction == OP_HASH_JUMP || instruction == OP_JUMP_TABLE) {
+            relocations[relocationCount++] = (relocation_t){
+                .oldOffset = i, .extendedArg = 0u, .newOffset = compaction.count, .prefixCount = 0u};
+            kept[keptCount++] = (kept_instruction_t){.oldStart = start, .newStart = compaction.count, .constant = -1};
+            chunk_optimizer_copy(&compaction, start, i + length - start);
+        } else if (keptCount >= 2u && !targets[start] && !targets[kept[keptCount - 1u].oldStart] &&
+                   kept[keptCount - 2u].constant != -1 && kept[keptCount - 1u].constant != -1 &&
+                   chunk_optimizer_fold(instruction, chunk->constants.values[kept[keptCount - 2u].constant],
+                                        chunk->constants.values[kept[keptCount - 1u].constant], &folded)) {
+            // Constant folding 🙏 - the first constant is replaced by the result and the second constant is dropped
+            chunk->constants.values[kept[keptCount - 2u].constant] = folded;
+            compaction.count = kept[--keptCount].newStart;
+            newIndexes[start] = compaction.count;
+        } else {
+            int32_t constant = instruction == OP_CONSTANT ? (int32_t)(extendedArg | chunk->code[i + 1u]) : -1;
+            kept[keptCount++] =
+                (kept_instruction_t){.oldStart = start, .newStart = compaction.count, .constant = constant};
+            chunk_optimizer_copy(&compaction, start, i + length - start);
+        }
+        extendedArg = 0u;
+        start = i += length;
+    }
+    newIndexes[count] = compaction.count;
+    for (uint32_t i = 0; i < relocationCount; i++) {
+        chunk_optimizer_relocate(&compaction, &relocations[i], newIndexes);
+    }
+    // The line infos are rebuilt in place, compacting the bytecode never splits a line
+    chunk->lineInfoCount = 0u;
+    for (uint32_t i = 0; i < compaction.count; i++) {
+        if (!chunk->lineInfoCount || chunk->lineInfos[chunk->lineInfoCount - 1u].lineNumber != compaction.lines[i]) {
+            chunk->lineInfos[chunk->lineInfoCount].lineNumber = compaction.lines[i];
+            chunk->lineInfoCount++;
         }
+        chunk->lineInfos[chunk->lineInfoCount - 1u].lastOpCodeIndexInLine = i;
     }
+    memcpy(chunk->code, compaction.code, compaction.count);
+    chunk->byteCodeCount = compaction.count;
+    free(compaction.code);
+    free(compaction.lines);
+    free(targets);
+    free(newIndexes);
+    free(kept);
+    free(relocations);
 }
 
-/// @brief Folds a expression in a chunk
-/// @param chunk The chunk where the expression is folded
-/// @param indexPointer Pointer to the index of the first constant in the expression that is folded
-static void chunk_optimizer_fold_numerical_expression(chunk_t * chunk, int32_t * indexPointer) {
-    // Removes OP_ADD, OP_CONSTANT and the constant index and replaced the first constant at the index with the result
-    // of evaluating the expression
-    double foldedConstantValue;
+/// @brief Copies bytecode of the original chunk to the compacted bytecode
+/// @param compaction The compacted bytecode
+/// @param start Index of the first byte that is copied
+/// @param amount The amount of bytes that are copied
+/// @details The bytes have to be copied in the order of the original chunk, so the line infos can be looked up with a
+/// cursor
+static void chunk_optimizer_copy(compaction_t * compaction, uint32_t start, uint32_t amount) {
+    line_info_t * lineInfos = compaction->chunk->lineInfos;
+    for (uint32_t i = start; i < start + amount; i++) {
+        while (lineInfos[compaction->lineInfoIndex].lastOpCodeIndexInLine < i) {
+            compaction->lineInfoIndex++;
+        }
+        compaction->code[compaction->count] = compaction->chunk->code[i];
+        compaction->lines[compaction->count++] = lineInfos[compaction->lineInfoIndex].lineNumber;
+    }
+}
 
-    switch (chunk->code[*indexPointer + 4]) {
+/// @brief Evaluates a binary arithmetic instruction with two constant operands at compile time
+/// @param instruction The instruction that is evaluated
+/// @param a The first operand
+/// @param b The second operand
+/// @param result Pointer to the value where the result is stored
+/// @return true if the instruction was evaluated, false if it has to be executed at runtime
+/// @details The result matches the result of the virtual machine, integers stay integers as long as they fit
+static bool chunk_optimizer_fold(uint8_t instruction, value_t a, value_t b, value_t * result) {
+    if (!IS_NUMBER(a) || !IS_NUMBER(b)) {
+        return false;
+    }
+    bool integers = IS_INTEGER(a) && IS_INTEGER(b);
+    int64_t x = integers ? AS_INTEGER(a) : 0, y = integers ? AS_INTEGER(b) : 0;
+    switch (instruction) {
     case OP_ADD:
-        FOLD_EXPRESSION(+);
-        break;
+        *result = integers ? value_from_integer(x + y) : NUMBER_VAL(AS_NUMBER(a) + AS_NUMBER(b));
+        return true;
     case OP_DIVIDE:
-        FOLD_EXPRESSION(/);
-        break;
+        if (!integers || !value_divide_integers(x, y, result)) {
+            *result = NUMBER_VAL(AS_NUMBER(a) / AS_NUMBER(b));
+        }
+        return true;
     case OP_MULTIPLY:
-        FOLD_EXPRESSION(*);
-        break;
+        *result = integers ? value_multiply_integers(x, y) : NUMBER_VAL(AS_NUMBER(a) * AS_NUMBER(b));
+        return true;
     case OP_SUBTRACT:
-        FOLD_EXPRESSION(-);
-        break;
+        *result = integers ? value_from_integer(x - y) : NUMBER_VAL(AS_NUMBER(a) - AS_NUMBER(b));
+        return true;
     default:
-// We assume this code to be unreachable.
-#if defined(COMPILER_MSVC)
-        __assume(0);
-#elif defined(COMPILER_GCC) || defined(COMPILER_CLANG)
-        __builtin_unreachable();
-#else
-        break;
-#endif
+        return false;
     }
-    // Removing OP_CONSTANT and OP_ADD / OP_DIVIDE / OP_MULTIPLY / OP_SUBTRACT from the chunk
-    chunk_remove_bytecode(chunk, *indexPointer + 2, 3);
-    if (*indexPointer > 2 && chunk->code[*indexPointer - 2] == OP_CONSTANT) {
-        *indexPointer -= 4; // Checking prevoius bytecode instruction again for recursive constant folding
+}
+
+/// @brief Determines whether an instruction jumps with an offset that can be widened by prefixes
+/// @param instruction The instruction that is checked
+/// @return true if the instruction is OP_FOR_EACH, OP_JUMP, OP_JUMP_IF_FALSE or OP_LOOP
+static inline bool chunk_optimizer_is_jump(uint8_t instruction) {
+    return instruction == OP_FOR_EACH || instruction == OP_JUMP || instruction == OP_JUMP_IF_FALSE ||
+           instruction == OP_LOOP;
+}
+
+/// @brief Determines the index of the instruction a jump instruction jumps to
+/// @param chunk The chunk where the jump instruction is stored
+/// @param offset The index of the jump instruction
+/// @param extendedArg The upper bits of the jump offset that were supplied by the prefixes of the instruction
+/// @return The index of the instruction where the execution continues
+static uint32_t chunk_optimizer_jump_target(chunk_t * chunk, uint32_t offset, uint32_t extendedArg) {
+    uint8_t const * code = chunk->code + offset;
+    uint32_t jump = extendedArg << 8 | (uint32_t)(code[1] << 8 | code[2]);
+    uint32_t end = offset + (code[0] == OP_FOR_EACH ? 5u : 3u);
+    return code[0] == OP_LOOP ? end - jump : end + jump;
+}
+
+/// @brief Marks all the instructions of a chunk that are the target of a jump
+/// @param chunk The chunk that is scanned
+/// @param targets Flags for every index of the chunk (and the end of the chunk) that are set for jump targets
+/// @details Constant folding must not remove an instruction that is jumped to
+static void chunk_optimizer_mark_jump_targets(chunk_t * chunk, bool * targets) {
+    uint32_t extendedArg = 0u;
+    for (uint32_t i = 0; i < chunk->byteCodeCount;) {
+        uint32_t length = chunk_instruction_length(chunk, i, extendedArg);
+        if (chunk_optimizer_is_jump(chunk->code[i])) {
+            targets[chunk_optimizer_jump_target(chunk, i, extendedArg)] = true;
+        } else if (chunk->code[i] == OP_HASH_JUMP || chunk->code[i] == OP_JUMP_TABLE) {
+            uint32_t stride, end = i + length;
+            uint32_t jump = chunk_optimizer_read_u32(chunk->code + i + 1u);
+            if (jump) {
+                targets[end - jump] = true;
+            }
+            for (uint32_t entry = chunk_optimizer_switch_table(chunk, i, &stride); entry < end; entry += stride) {
+                if ((jump = chunk_optimizer_read_u32(chunk->code + entry))) {
+                    targets[end - jump] = true;
+                }
+            }
+        }
+        extendedArg = chunk_next_extended_arg(chunk, i, extendedArg);
+        i += length;
+    }
+}
+
+/// @brief Determines the amount of OP_EXTENDED_ARG prefixes a jump offset needs
+/// @param jump The jump offset
+/// @return The amount of prefixes (every prefix adds 8 bits to the 16-bit operand)
+static inline uint32_t chunk_optimizer_prefix_count(uint32_t jump) {
+    return jump <= UINT16_MAX ? 0u : jump <= 0xffffffu ? 1u : 2u;
+}
+
+/// @brief Reads a big endian unsigned 32-bit integer operand
+/// @param code Pointer to the first byte of the operand
+/// @return The value of the operand
+static inline uint32_t chunk_optimizer_read_u32(uint8_t const * code) {
+    return (uint32_t)code[0] << 24 | (uint32_t)code[1] << 16 | (uint32_t)code[2] << 8 | code[3];
+}
+
+/// @brief Recomputes the offsets of a jump or switch instruction after the chunk has been compacted
+/// @param compaction The compacted bytecode
+/// @param relocation The instruction that is relocated
+/// @param newIndexes The indices of the instructions of the original chunk in the compacted bytecode
+static void chunk_optimizer_relocate(compaction_t * compaction, relocation_t * relocation,
+                                     uint32_t const * newIndexes) {
+    chunk_t * chunk = compaction->chunk;
+    uint8_t * code = compaction->code + relocation->newOffset;
+    if (chunk_optimizer_is_jump(code[0])) {
+        uint32_t target =
+            newIndexes[chunk_optimizer_jump_target(chunk, relocation->oldOffset, relocation->extendedArg)];
+        uint32_t end = relocation->newOffset + (code[0] == OP_FOR_EACH ? 5u : 3u);
+        uint32_t jump = code[0] == OP_LOOP ? end - target : target - end;
+        code[1] = (jump >> 8) & 0xff;
+        code[2] = jump & 0xff;
+        // The operand of the prefix that is closest to the instruction stores the lowest bits
+        for (uint32_t prefix = 1u; prefix <= relocation->prefixCount; prefix++) {
+            code[1 - 2 * (int32_t)prefix] = (jump >> (8u + 8u * prefix)) & 0xff;
+        }
+        return;
+    }
+    uint32_t length = chunk_switch_instruction_length(chunk, relocation->oldOffset);
+    uint32_t oldEnd = relocation->oldOffset + length, newEnd = relocation->newOffset + length, stride;
+    uint32_t jump = chunk_optimizer_read_u32(code + 1);
+    if (jump) {
+        chunk_optimizer_write_u32(code + 1, newEnd - newIndexes[oldEnd - jump]);
+    }
+    for (uint32_t entry = chunk_optimizer_switch_table(chunk, relocation->oldOffset, &stride) - relocation->oldOffset;
+         entry < length; entry += stride) {
+        if ((jump = chunk_optimizer_read_u32(code + entry))) {
+            chunk_optimizer_write_u32(code + entry, newEnd - newIndexes[oldEnd - jump]);
+        }
     }
 }
+
+/// @brief Determines where the jump offsets of the cases of a switch instruction are stored
+/// @param chunk The chunk where the switch instruction is stored
+/// @param offset The index of the switch instruction
+/// @param stride Pointer to the value where the distance between two jump offsets is stored
+/// @return The index of the first jump offset of a case (the offset of the default case is stored in front of it)
+static inline uint32_t chunk_optimizer_switch_table(chunk_t * chunk, uint32_t offset, uint32_t * stride) {
+    // The slots of a hash jump store the index of the constant of the label in front of the jump offset
+    bool jumpTable = chunk->code[offset] == OP_JUMP_TABLE;
+    *stride = jumpTable ? 4u : 6u;
+    return offset + (jumpTable ? 11u : 9u);
+}
+
+/// @brief Writes a big endian unsigned 32-bit integer operand
+/// @param code Pointer to the first byte of the operand
+/// @param value The value of the operand
+static inline void chunk_optimizer_write_u32(uint8_t * code, uint32_t value) {
+    code[0] = (value >> 24) & 0xff;
+    code[1] = (value >> 16) & 0xff;
+    code[2] = (value >> 8) & 0xff;
+    code[3] = value & 0xff;
+}
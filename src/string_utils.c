@@ -24,10 +24,23 @@
 #include <stdlib.h>
 #include <string.h>
 
-/// Offset basic for the fowler-noll-vo hash-fuction - 2166136261
-#define OFFSET_BASIS 0x811c9dc5u
+/// Seed of the hash function
+#define HASH_SEED    (0xa0761d6478bd642full)
+
+/// First secret of the hash function that is used to mix the words
+#define HASH_SECRET1 (0xe7037ed1a0b428dbull)
+
+/// Second secret of the hash function that is used to mix the words
+#define HASH_SECRET2 (0x8ebc6af09c88c6e3ull)
+
+/// Third secret of the hash function that is used to mix the words
+#define HASH_SECRET3 (0x589965cc75374cc3ull)
 
 static void string_utils_behead(char *, uint32_t *);
+static uint64_t string_utils_hash_mix(uint64_t, uint64_t);
+static uint64_t string_utils_read_three(uint8_t const *, uint32_t);
+static uint64_t string_utils_read32(uint8_t const *);
+static uint64_t string_utils_read64(uint8_t const *);
 
 bool string_utils_contains_character_restricted(char const * text, char character, uint32_t length) {
     for (uint32_t i = 0u; i < length; i++) {
@@ -154,10 +167,88 @@ static void string_utils_behead(char * text, uint32_t * length) {
 }
 
 uint32_t string_utils_hash_string(char const * key, uint32_t length) {
-    uint32_t hash = OFFSET_BASIS;
-    for (uint32_t i = 0; i < length; i++) {
-        hash ^= (uint8_t)key[i];
-        hash *= 0x01000193u;
+    uint8_t const * bytes = (uint8_t const *)key;
+    uint64_t seed = HASH_SEED;
+    uint64_t a, b;
+    if (length <= 16u) {
+        if (length >= 4u) {
+            // Two overlapping pairs of 32-bit words cover every length between 4 and 16 bytes
+            uint32_t offset = (length >> 3u) << 2u;
+            a = (string_utils_read32(bytes) << 32u) | string_utils_read32(bytes + offset);
+            b = (string_utils_read32(bytes + length - 4u) << 32u) | string_utils_read32(bytes + length - 4u - offset);
+        } else if (length) {
+            a = string_utils_read_three(bytes, length);
+            b = 0u;
+        } else {
+            a = b = 0u;
+        }
+    } else {
+        uint32_t remaining = length;
+        if (remaining > 48u) {
+            // Long sequences are mixed in three independent lanes, so the multiplications can be executed in parallel
+            uint64_t lane1 = seed, lane2 = seed;
+            do {
+                seed = string_utils_hash_mix(string_utils_read64(bytes) ^ HASH_SECRET1,
+                                             string_utils_read64(bytes + 8u) ^ seed);
+                lane1 = string_utils_hash_mix(string_utils_read64(bytes + 16u) ^ HASH_SECRET2,
+                                              string_utils_read64(bytes + 24u) ^ lane1);
+                lane2 = string_utils_hash_mix(string_utils_read64(bytes + 32u) ^ HASH_SECRET3,
+                                              string_utils_read64(bytes + 40u) ^ lane2);
+                bytes += 48u;
+                remaining -= 48u;
+            } while (remaining > 48u);
+            seed ^= lane1 ^ lane2;
+        }
+        while (remaining > 16u) {
+            seed = string_utils_hash_mix(string_utils_read64(bytes) ^ HASH_SECRET1,
+                                         string_utils_read64(bytes + 8u) ^ seed);
+            bytes += 16u;
+            remaining -= 16u;
+        }
+        // The last 16 bytes are read even if they overlap with the previous block
+        a = string_utils_read64(bytes + remaining - 16u);
+        b = string_utils_read64(bytes + remaining - 8u);
     }
-    return hash;
+    uint64_t hash = string_utils_hash_mix(HASH_SECRET1 ^ length, string_utils_hash_mix(a ^ HASH_SECRET1, b ^ seed));
+    return (uint32_t)(hash ^ (hash >> 32u));
+}
+
+/// @brief Multiplies two 64-bit values and folds the 128-bit product by xoring its halves
+/// @param a The first factor
+/// @param b The second factor
+/// @return The folded product
+static uint64_t string_utils_hash_mix(uint64_t a, uint64_t b) {
+#if (defined(COMPILER_GCC) || defined(COMPILER_CLANG)) && defined(__SIZEOF_INT128__)
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64u);
+#else
+    uint64_t aHigh = a >> 32u, aLow = (uint32_t)a, bHigh = b >> 32u, bLow = (uint32_t)b;
+    uint64_t high = aHigh * bHigh, middle1 = aHigh * bLow, middle2 = aLow * bHigh, low = aLow * bLow;
+    uint64_t carry = ((low >> 32u) + (uint32_t)middle1 + (uint32_t)middle2) >> 32u;
+    uint64_t productLow = low + (middle1 << 32u) + (middle2 << 32u);
+    uint64_t productHigh = high + (middle1 >> 32u) + (middle2 >> 32u) + carry;
+    return productLow ^ productHigh;
+#endif
+}
+
+/// @brief Reads a character sequence that is shorter than 4 bytes
+/// @param bytes The character sequence
+/// @param length The length of the character sequence (between 1 and 3)
+/// @return The first, the middle and the last byte combined in a word
+static uint64_t string_utils_read_three(uint8_t const * bytes, uint32_t length) {
+    return ((uint64_t)bytes[0] << 16u) | ((uint64_t)bytes[length >> 1u] << 8u) | bytes[length - 1u];
+}
+
+/// @brief Reads 4 bytes as a little-endian word
+/// @param bytes Pointer to the first byte
+/// @return The word
+static uint64_t string_utils_read32(uint8_t const * bytes) {
+    return (uint64_t)bytes[0] | ((uint64_t)bytes[1] << 8u) | ((uint64_t)bytes[2] << 16u) | ((uint64_t)bytes[3] << 24u);
+}
+
+/// @brief Reads 8 bytes as a little-endian word
+/// @param bytes Pointer to the first byte
+/// @return The word
+static uint64_t string_utils_read64(uint8_t const * bytes) {
+    return string_utils_read32(bytes) | (string_utils_read32(bytes + 4u) << 32u);
 }
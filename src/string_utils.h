@@ -38,11 +38,12 @@ bool string_utils_contains_character_restricted(char const * text, char characte
 /// character sequence
 int string_utils_resolve_escape_sequence(char * text, uint32_t * length);
 
-/// @brief <a href=https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function#FNV-1a_hash>FNV-1a</a>
-/// hash function
-/// @details Fownler-Noll-Vo is a non-cryptographic hash function, that comes in three different version FNV-0, FNV-1
-/// and FNV-1a. There are 32-, 64-, 128-, 256-, 512-, and 1024-bit variants of the function. We use the 32-bit variant
-/// to hash all the strings in cellox.
+/// @brief Hashes a character sequence
+/// @details The hash function is based on <a href=https://github.com/wangyi-fudan/wyhash>wyhash</a>. The characters are
+/// read in words of 8 bytes that are mixed with 64x64 to 128-bit multiplications. Sequences of up to 16 characters are
+/// hashed with a single multiplication, longer sequences are processed in blocks of 48 bytes using three independent
+/// lanes. The words are always read in little-endian order, so the hashvalue of a character sequence is the same on
+/// every platform. The 64-bit result is folded to 32 bits, that are used to hash all the strings in cellox.
 /// @param key The key that is hashed
 /// @param length The length of the key
 /// @return The hashvalue of the key
@@ -2,10 +2,19 @@
 
 #include "test_cellox.hh"
 
+TEST(Array, AppendInPlace) {
+    test_cellox_program("array/append_in_place.clx", "100000\n{1, 2, 3, 4, 1, 2, 3, 4}\n{} {} 8\n");
+}
+
 TEST(Array, ChangeByIndex) {
     test_cellox_program("array/change_by_index.clx", "12\n");
 }
 
+TEST(Array, ConstantLiteral) {
+    test_cellox_program("array/constant_literal.clx",
+                        "{10, 2, 3, 4}\n{1, 2, 3, 4, 5}\n{1, 2, 3, 4}\n{{1, 30, 3, 4}, {1, 2, 3, 4}}\n-1 70 70 1 70\n");
+}
+
 TEST(Array, EqualOperator) {
     test_cellox_program("array/equal_operator.clx", "true\n");
 }
@@ -14,6 +23,11 @@ TEST(Array, GetByIndex) {
     test_cellox_program("array/get_by_index.clx", "4\n");
 }
 
+TEST(Array, LiteralElements) {
+    test_cellox_program("array/literal_elements.clx",
+                        "{-1, 0, 2.5, -3.5}\n{4, -4, n, true, null}\n{zero, uno, two}\n{zero, one, two}\n");
+}
+
 TEST(Array, PlusOperator) {
     test_cellox_program("array/plus_operator.clx", "{1, 2, true, -10, null}\n{1, 2, true, -10}\n");
 }
\ No newline at end of file
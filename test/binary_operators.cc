@@ -2,6 +2,11 @@
 
 #include "test_cellox.hh"
 
+TEST(BinaryOperators, ConstantFolding) {
+    test_cellox_program("binary_operators/constant_folding.clx",
+                        "1 2 3 4 5 6 7 8\n5\n5\n3.5 2 2.14748e+09\n12\n-0 -0 -2\n");
+}
+
 TEST(BinaryOperators, Divide) {
     test_cellox_program("binary_operators/divide.clx", "3\n");
 }
@@ -18,6 +23,11 @@ TEST(BinaryOperators, GreaterEqual) {
     test_cellox_program("binary_operators/greater_equal.clx", "true\ntrue\nfalse\n");
 }
 
+TEST(BinaryOperators, IntegerOverflow) {
+    test_cellox_program("binary_operators/integer_overflow.clx",
+                        "true 2.14748e+09\n-2.14748e+09 4.29497e+09\n3.5 4 true\n-0 -0 -0\n-1 1\n-0 -0 -2\n");
+}
+
 TEST(BinaryOperators, minus) {
     test_cellox_program("binary_operators/minus.clx", "2\n");
 }
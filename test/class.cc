@@ -52,6 +52,11 @@ TEST(Classes, NoExplizitInit) {
     test_cellox_program("class/no_explizit_init.clx", "{}\n");
 }
 
+TEST(Classes, OverrideMethod) {
+    test_cellox_program("class/override_method.clx",
+                        "fish makes no sound\nrex makes woof\nrex junior makes woofish\n10000\n");
+}
+
 TEST(Classes, PrintInstance) {
     test_cellox_program("class/print_instance.clx", "{}\n");
 }
\ No newline at end of file
@@ -2,6 +2,22 @@
 
 #include "test_cellox.hh"
 
+TEST(Compile, ArrayLiteral) {
+    test_compiled_cellox_program("compile/array_literal.clx", "{4, -2, three}\n{1, -2, three}\n");
+}
+
+TEST(Compile, Functions) {
+    test_compiled_cellox_program("compile/functions.clx", "Hello 3\n12\n");
+}
+
+TEST(Compile, Numbers) {
+    test_compiled_cellox_program("compile/numbers.clx", "-2 0.25 1.23457e+12\n-1\n22.5\nabbb\n");
+}
+
 TEST(Compile, Simple) {
     test_compiled_cellox_program("compile/simple.clx", "Hello World!\n");
 }
+
+TEST(Compile, WideOperands) {
+    test_compiled_cellox_program("compile/wide_operands.clx", "597 {a, b}\n");
+}
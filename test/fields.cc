@@ -51,6 +51,10 @@ TEST(Fields, OnInstance) {
     test_cellox_program("fields/on_instance.clx", "bar!\nbaz!\nbar!\nbaz!\n");
 }
 
+TEST(Fields, Presized) {
+    test_cellox_program("fields/presized.clx", "500500\n{x: 5, y: 6}\n10\n");
+}
+
 TEST(Fields, SetOnBool) {
     test_failing_cellox_program("fields/set_on_bool.clx",
                                 "Only instances have fields but was called with a boolean value\n[line 1] in script\n");
@@ -2,6 +2,37 @@
 
 #include "test_cellox.hh"
 
+TEST(ForLoops, ForEachArray) {
+    test_cellox_program("for_loops/for_each_array.clx", "10\n22\n1x 1y 2x 2y \n");
+}
+
+TEST(ForLoops, ForEachClosures) {
+    test_cellox_program("for_loops/for_each_closures.clx", "10 20 30 \n");
+}
+
+TEST(ForLoops, ForEachCollections) {
+    test_cellox_program("for_loops/for_each_collections.clx", "a b c rope\n7 8 9 \nkey value\n");
+}
+
+TEST(ForLoops, ForEachIteratorProtocol) {
+    test_cellox_program("for_loops/for_each_iterator_protocol.clx", "4 9 16 25 \n");
+}
+
+TEST(ForLoops, ForEachMapModified) {
+    test_failing_cellox_program("for_loops/for_each_map_modified.clx",
+                                "The keys of a map can not be changed while it is iterated\n[line 5] in script\n");
+}
+
+TEST(ForLoops, ForEachMapUpdate) {
+    test_cellox_program("for_loops/for_each_map_update.clx", "64 64 49\n");
+}
+
+TEST(ForLoops, ForEachNotIterable) {
+    test_failing_cellox_program("for_loops/for_each_not_iterable.clx",
+                                "Only arrays, strings, typed arrays, maps and instances can be iterated but the "
+                                "collection is a numerical value\n[line 1] in script\n");
+}
+
 TEST(ForLoops, NoCounterIncrementExpression) {
     test_cellox_program("for_loops/no_counter_increment_expression.clx", "1\n2\n3\n4\n");
 }
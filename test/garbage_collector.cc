@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include "test_cellox.hh"
+
+#include "backend/garbage_collector_policy.h"
+
+TEST(GarbageCollector, AdaptivePolicy) {
+    ASSERT_TRUE(garbage_collector_policy_set_from_argument("--gc-adaptive"));
+    ASSERT_TRUE(garbage_collector_policy_set_from_argument("--gc-initial-heap=16K"));
+    test_cellox_program("garbage_collector/adaptive.clx", "40000\n");
+    ASSERT_TRUE(garbage_collector_policy_set_from_argument("--gc-adaptive=off"));
+    ASSERT_TRUE(garbage_collector_policy_set_from_argument("--gc-initial-heap=1M"));
+}
+
+TEST(GarbageCollector, InstanceFields) {
+    ASSERT_TRUE(garbage_collector_policy_set_from_argument("--gc-initial-heap=16K"));
+    test_cellox_program("garbage_collector/instance_fields.clx", "0 3000 5997\n");
+    ASSERT_TRUE(garbage_collector_policy_set_from_argument("--gc-initial-heap=1M"));
+}
+
+TEST(GarbageCollector, InvalidSettings) {
+    ASSERT_FALSE(garbage_collector_policy_set_from_argument("--gc-growth-factor=1"));
+    ASSERT_FALSE(garbage_collector_policy_set_from_argument("--gc-max-heap=12X"));
+    ASSERT_FALSE(garbage_collector_policy_set_from_argument("--gc-initial-heap"));
+    ASSERT_FALSE(garbage_collector_policy_set_from_argument("--gc-unknown=1"));
+}
+
+TEST(GarbageCollector, NumericArrays) {
+    ASSERT_TRUE(garbage_collector_policy_set_from_argument("--gc-initial-heap=16K"));
+    test_cellox_program("garbage_collector/numeric_arrays.clx",
+                        "{1, 2, 3}\n{1, second value, 3}\n{4, 5, last value}\nfirst value\n");
+    ASSERT_TRUE(garbage_collector_policy_set_from_argument("--gc-initial-heap=1M"));
+}
+
+TEST(GarbageCollector, OutOfMemory) {
+    ASSERT_TRUE(garbage_collector_policy_set_from_argument("--gc-max-heap=1M"));
+    test_failing_cellox_program("garbage_collector/out_of_memory.clx",
+                                "Out of memory - the heap limit of 1048576 bytes was exceeded\n[line 3] in script\n");
+    ASSERT_TRUE(garbage_collector_policy_set_from_argument("--gc-max-heap=0"));
+}
+
+TEST(GarbageCollector, Statistics) {
+    test_cellox_program("garbage_collector/statistics.clx", "true\ntrue\ntrue\n5\ntrue\ntrue\n");
+}
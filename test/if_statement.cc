@@ -14,6 +14,10 @@ TEST(If, Simple) {
     test_cellox_program("if_statement/simple.clx", "yes\nblock\ntrue\n");
 }
 
+TEST(If, ThenInLoop) {
+    test_cellox_program("if_statement/then_in_loop.clx", "50000\n");
+}
+
 TEST(If, VariableInThen) {
     test_failing_cellox_program("if_statement/variable_in_then.clx", "[line 2] Error at 'var': Expect expression.\n");
 }
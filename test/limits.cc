@@ -7,10 +7,6 @@ TEST(Limits, FunTooManyArguments) {
                                 "[line 15] Error at '256': Can't have more than 255 arguments in a function call.\n");
 }
 
-TEST(Limits, LoopBodyTooLarge) {
-    test_failing_cellox_program("limits/loop_body_too_large.clx", "[line 2051] Error at '}': Loop body too large.\n");
-}
-
 TEST(Limits, MethodTooManyArguments) {
     test_failing_cellox_program("limits/method_too_many_arguments.clx",
                                 "[line 259] Error at 'a': Can't have more than 255 arguments in a function call.\n");
@@ -27,17 +23,52 @@ TEST(Limits, TooLongArrayLiteral) {
         "[line 15] Error at '256': Can't have more than 255 arguments in a array literal expression.\n");
 }
 
+TEST(Limits, StackOverflow) {
+    std::string expectedOutput = "Stack overflow!!!\n[line 307] in locals()\n";
+    for (int i = 0; i < 40; i++) {
+        expectedOutput.append("[line 339] in locals()\n");
+    }
+    expectedOutput.append("[line 341] in script\n");
+    test_failing_cellox_program("limits/stack_overflow.clx", expectedOutput);
+}
+
 TEST(Limits, TooManyConstants) {
-    test_failing_cellox_program("limits/too_many_constants.clx",
-                                "[line 34] Error at '256': Too many constants in one chunk.\n");
+    // Every number literal occupies its own constant
+    std::string source;
+    for (int i = 0; i <= 65536; i++) {
+        source.append("1;\n");
+    }
+    test_failing_generated_cellox_program("too_many_constants.clx", source,
+                                          "[line 65537] Error at '1': Too many constants in one chunk.\n");
 }
 
 TEST(Limits, TooManyLocals) {
-    test_failing_cellox_program("limits/too_many_locals.clx",
-                                "[line 52] Error at 'v100': Too many local variables in function.\n");
+    // The first slot of the script is occupied by the script itself, the locals are declared in nested blocks because
+    // the compiler only looks for duplicates in the current block
+    std::string source;
+    for (int i = 0; i < 65536; i++) {
+        source.append(i % 256 ? "" : "{\n");
+        source.append("var v" + std::to_string(i % 256) + ";\n");
+    }
+    source.append(std::string(256, '}'));
+    test_failing_generated_cellox_program("too_many_locals.clx", source,
+                                          "[line 65792] Error at 'v255': Too many local variables in function.\n");
 }
 
 TEST(Limits, TooManyUpvalues) {
-    test_failing_cellox_program("limits/too_many_upvalues.clx",
-                                "[line 102] Error at 'v100': Too many closure variables in function.\n");
+    // The inner function captures three locals of the outer function and the locals of the function in between, the
+    // names have different lengths so most of them are told apart before their characters are compared
+    std::string source = "fun outer() {\nvar a;\nvar b;\nvar c;\nfun middle() {\n";
+    for (int i = 0; i < 65534; i++) {
+        source.append(i % 256 ? "" : "{\n");
+        source.append("var " + std::string(i % 32, '_') + "v" + std::to_string(i) + ";\n");
+    }
+    source.append("fun inner() {\na;\nb;\nc;\n");
+    for (int i = 0; i < 65534; i++) {
+        source.append(std::string(i % 32, '_') + "v" + std::to_string(i) + ";\n");
+    }
+    source.append("}\n" + std::string(256, '}') + "\n}\n}\n");
+    test_failing_generated_cellox_program("too_many_upvalues.clx", source,
+                                          "[line 131333] Error at '" + std::string(29, '_') +
+                                              "v65533': Too many closure variables in function.\n");
 }
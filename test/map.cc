@@ -0,0 +1,15 @@
+#include <gtest/gtest.h>
+
+#include "test_cellox.hh"
+
+TEST(Map, CountWords) {
+    test_cellox_program("map/count_words.clx", "3 2 1 null\n3\n");
+}
+
+TEST(Map, KeyTypes) {
+    test_cellox_program("map/key_types.clx", "one 2 3 zero array string\nnull 6\n");
+}
+
+TEST(Map, Remove) {
+    test_cellox_program("map/remove.clx", "5000 5e+07 false\n5000 true\n{\"x\": \"y\"} false\n");
+}
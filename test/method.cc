@@ -10,6 +10,15 @@ TEST(Methods, BindThis) {
     test_cellox_program("method/binds_this.clx", "foo1\n1\n");
 }
 
+TEST(Methods, BoundMethodEquality) {
+    test_cellox_program("method/bound_method_equality.clx",
+                        "true false false false\ntrue false\nincrement other increment 2\n");
+}
+
+TEST(Methods, BoundMethodReuse) {
+    test_cellox_program("method/bound_method_reuse.clx", "10 15 10\n140000\n{3, 6, 9}\n");
+}
+
 TEST(Methods, Empty) {
     test_cellox_program("method/empty.clx", "null\n");
 }
@@ -1,11 +1,30 @@
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+
 #include "test_cellox.hh"
 
+TEST(NativeFunctions, ArrayInsertRemove) {
+    test_cellox_program("native_functions/array_insert_remove.clx", "{0, 1, 2, 3, 4, 5}\n1\n{0, 2, 3, 4, 5}\n");
+}
+
 TEST(NativeFunctions, ArrayLength) {
     test_cellox_program("native_functions/array_length.clx", "5\n");
 }
 
+TEST(NativeFunctions, ArrayMapFilterReduce) {
+    test_cellox_program("native_functions/array_map_filter_reduce.clx", "{1, 4, 9, 16, 25, 36}\n{2, 4, 6}\n91\n");
+}
+
+TEST(NativeFunctions, ArraySearch) {
+    test_cellox_program("native_functions/array_search.clx", "4 -1\n2 -1\n");
+}
+
+TEST(NativeFunctions, ArraySort) {
+    test_cellox_program("native_functions/array_sort.clx", "{1, 3, 5, 7, 9}\n{app, apple, fig, pear}\ntrue 999 0\n");
+}
+
 TEST(NativeFunctions, AsciToNumerical) {
     test_cellox_program("native_functions/asci_to_numerical.clx", "70");
 }
@@ -18,6 +37,22 @@ TEST(NativeFunctions, NumericalToAsci) {
     test_cellox_program("native_functions/numerical_to_asci.clx", "F");
 }
 
+#ifndef OS_WINDOWS
+TEST(NativeFunctions, ReadFileLargerThan4GiB) {
+    // The file is sparse, so it does not occupy 4 GiB on the disk
+    std::string filePath = testing::TempDir() + "larger_than_4_gib.txt";
+    {
+        std::ofstream file(filePath, std::ios::binary);
+        file.seekp(4294967296LL);
+        file.put('\n');
+    }
+    test_failing_generated_cellox_program("read_large_file.clx", "read_file(\"" + filePath + "\");\n",
+                                          "read_file can not read the file " + filePath +
+                                              ", because it is larger than 4 GiB\n[line 1] in script\n");
+    std::remove(filePath.c_str());
+}
+#endif
+
 TEST(NativeFunctions, StringLength) {
     test_cellox_program("native_functions/string_length.clx", "0\n6\n11\n");
 }
\ No newline at end of file
@@ -9,3 +9,11 @@ TEST(Slice, Array) {
 TEST(Slice, String) {
     test_cellox_program("slice/string.clx", "Hello\n");
 }
+
+TEST(Slice, LargeArray) {
+    test_cellox_program("slice/large_array.clx", "140\n10\n-1\n20\n15\n20\n{100, 101}\n");
+}
+
+TEST(Slice, LargeString) {
+    test_cellox_program("slice/large_string.clx", "800\n495\n012345678901\n5678901\ntrue\ntrue\ntrue\n");
+}
@@ -8,4 +8,21 @@ TEST(Strings, ChangeStringByIndex) {
 
 TEST(Strings, GetByIndex) {
     test_cellox_program("strings/get_by_index.clx", "t\ne\ns\nt\n");
-}
\ No newline at end of file
+}
+TEST(Strings, ConcatenateInLoop) {
+    test_cellox_program("strings/concatenate_in_loop.clx",
+                        "20000\nb\nbaba\ntrue\ntrue\n"
+                        "0123456789012345678901234567890123456789012345678901234567890123456789\ntrue\nfalse\n");
+}
+
+TEST(Strings, Hash) {
+    test_cellox_program("strings/hash.clx", "true\ntrue\ntrue\ntrue\ntrue\nfalse\n");
+}
+
+TEST(Strings, RuntimeStrings) {
+    test_cellox_program("strings/runtime_strings.clx", "true\ntrue\nfalse\ntrue\ntrue\ntrue\n");
+}
+
+TEST(Strings, SingleCharacters) {
+    test_cellox_program("strings/single_characters.clx", "dlroW olleH\ntrue\ntrue\n18182\ntrue\n");
+}
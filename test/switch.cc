@@ -0,0 +1,36 @@
+#include "test_cellox.hh"
+
+#include <gtest/gtest.h>
+
+TEST(Switch, DenseIntegers) {
+    test_cellox_program("switch/dense_integers.clx", "-1 other\n0 zero\n1 one\n2 two or three\n3 two or three\n4 "
+                                                     "other\n5 five\n6 other\ntwo or three other other\n");
+}
+
+TEST(Switch, DuplicateDefault) {
+    test_failing_cellox_program("switch/duplicate_default.clx",
+                                "[line 3] Error at 'default': Can't have more than one default case in a switch "
+                                "statement.\n");
+}
+
+TEST(Switch, DuplicateLabel) {
+    test_failing_cellox_program("switch/duplicate_label.clx",
+                                "[line 3] Error at '1.0': Duplicate case label in switch statement.\n");
+}
+
+TEST(Switch, MissingCase) {
+    test_failing_cellox_program("switch/missing_case.clx",
+                                "[line 2] Error at 'printf': Expect 'case' or 'default' in switch statement.\n");
+}
+
+TEST(Switch, ScopedBodies) {
+    test_cellox_program("switch/scoped_bodies.clx", "334\ndefault only\n");
+}
+
+TEST(Switch, SparseLabels) {
+    test_cellox_program("switch/sparse_labels.clx", "small three large half string none\n");
+}
+
+TEST(Switch, StringLabels) {
+    test_cellox_program("switch/string_labels.clx", "1 2 3\n-1 -1\n");
+}
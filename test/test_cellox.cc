@@ -1,10 +1,13 @@
 #include "test_cellox.hh"
 
+#include <fstream>
+
 #include "gtest/gtest.h"
 
 #include "initializer.h"
 
 static void test_program(std::string const & programPath, std::string const & expectedOutput, bool producesError);
+static void test_program_file(std::string const & filePath, std::string const & expectedOutput, bool producesError);
 
 void test_cellox_program(std::string const & programPath, std::string const & expectedOutput) {
     test_program(programPath, expectedOutput, false);
@@ -24,6 +27,14 @@ void test_compiled_cellox_program(std::string const & programPath, std::string c
     test_program(alteredPath, expectedOutput, false);
 }
 
+void test_failing_generated_cellox_program(std::string const & programName, std::string const & source,
+                                           std::string const & expectedOutput) {
+    std::string filePath = testing::TempDir();
+    filePath.append(programName);
+    std::ofstream(filePath) << source;
+    test_program_file(filePath, expectedOutput, true);
+}
+
 /// @brief Test a cellox program
 /// @param programPath The path of the program that is tested
 /// @param expectedOutput The expected output of the program
@@ -32,7 +43,14 @@ static void test_program(std::string const & programPath, std::string const & ex
     // Create absolute filepath
     std::string filePath = TEST_PROGRAM_BASE_PATH;
     filePath.append(programPath);
+    test_program_file(filePath, expectedOutput, producesError);
+}
 
+/// @brief Test a cellox program that is stored at an absolute path
+/// @param filePath The absolute path of the program that is tested
+/// @param expectedOutput The expected output of the program
+/// @param producesError Determines wheather the rpogram leads to a runtime/compiler error
+static void test_program_file(std::string const & filePath, std::string const & expectedOutput, bool producesError) {
     // Redirect output
     std::string actual_output;
     if (producesError) {
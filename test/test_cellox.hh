@@ -24,4 +24,13 @@ void test_compiled_cellox_program(std::string const & programPath, std::string c
 /// that given string
 void test_failing_cellox_program(std::string const & programPath, std::string const & expectedOutput);
 
+/// @brief Tests a cellox program that is generated by the test and triggers an error at compile- or runtime
+/// @param programName The name of the file the program is stored in
+/// @param source The source code of the program
+/// @param expectedOutput The expected output of the program
+/// @details The program is stored in the temporary directory of the test, so programs that depend on files created by
+/// the test or are too large to be kept in the repository can be tested
+void test_failing_generated_cellox_program(std::string const & programName, std::string const & source,
+                                           std::string const & expectedOutput);
+
 #endif
\ No newline at end of file
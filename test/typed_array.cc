@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include "test_cellox.hh"
+
+#include "backend/typed_array_kernels.h"
+
+TEST(TypedArray, Float64Kernels) {
+    test_cellox_program("typed_array/float64_kernels.clx",
+                        "82.5\n0 15\n1732.5\n{0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30}\n1\n"
+                        "{0, 4.5, 9, 13.5, 18, 22.5, 27, 31.5, 36, 40.5, 45}\n");
+}
+
+TEST(TypedArray, Float64KernelsOfOtherInstructionSets) {
+    typed_array_kernels_instruction_set detected = typed_array_kernels_get_instruction_set();
+    typed_array_kernels_instruction_set sets[] = {TYPED_ARRAY_KERNELS_SCALAR, TYPED_ARRAY_KERNELS_SSE2};
+    for (typed_array_kernels_instruction_set set : sets) {
+        if (!typed_array_kernels_set_instruction_set(set)) {
+            continue;
+        }
+        test_cellox_program("typed_array/float64_kernels.clx",
+                            "82.5\n0 15\n1732.5\n{0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30}\n1\n"
+                            "{0, 4.5, 9, 13.5, 18, 22.5, 27, 31.5, 36, 40.5, 45}\n");
+    }
+    ASSERT_TRUE(typed_array_kernels_set_instruction_set(detected));
+}
+
+TEST(TypedArray, IndexOperator) {
+    test_cellox_program("typed_array/index_operator.clx", "4 {0, 0, 0.25, 0.5}\n6\nnull\n");
+}
+
+TEST(TypedArray, IntegerArrays) {
+    test_cellox_program("typed_array/integer_arrays.clx",
+                        "{250, 255, 0, 1, 255, 2}\n{244, 254, 0, 2, 254, 4}\n{2.14748e+09, -2.14748e+09, -7}\n15 6\n");
+}
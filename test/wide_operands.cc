@@ -0,0 +1,27 @@
+#include <gtest/gtest.h>
+
+#include "test_cellox.hh"
+
+TEST(WideOperands, Constants) {
+    test_cellox_program("wide_operands/constants.clx", "344857 {1, 2, 3}\n");
+}
+
+TEST(WideOperands, Globals) {
+    test_cellox_program("wide_operands/globals.clx", "298 300\n");
+}
+
+TEST(WideOperands, Locals) {
+    test_cellox_program("wide_operands/locals.clx", "300 596 297 6\n");
+}
+
+TEST(WideOperands, LongJumps) {
+    test_cellox_program("wide_operands/long_jumps.clx", "22 -1\n");
+}
+
+TEST(WideOperands, NestedLocals) {
+    test_cellox_program("wide_operands/nested_locals.clx", "2008\n");
+}
+
+TEST(WideOperands, Upvalues) {
+    test_cellox_program("wide_operands/upvalues.clx", "45850\n");
+}